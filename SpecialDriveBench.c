@@ -0,0 +1,805 @@
+#include <LibSpecialDrive.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Mede enumeração, leitura das tabelas GPT/MBR, cache, recarga e
+// marcação sobre conjuntos de imagens esparsas geradas na hora, pelo
+// backend de imagens: sem root e sem discos reais. Cada configuração vira
+// uma linha JSON com as métricas de cada fase, para comparar builds.
+
+#define BENCH_DISK_SIZE (64ull * 1024 * 1024)
+#define BENCH_MAX_DISKS 10000
+#define BENCH_MAX_ITERATIONS 100
+#define BENCH_GPT_ENTRY_SIZE 128
+
+typedef struct
+{
+    size_t disks;
+    uint32_t entries;        // entradas da tabela GPT (4 a 128)
+    uint32_t lbaSize;        // 512 ou 4096
+    uint32_t specialPercent; // discos gerados já marcados
+    uint32_t mbrPercent;     // discos MBR; o restante é GPT
+    size_t iterations;
+    size_t workers;
+} BenchConfig;
+
+// Contadores acumulados do processo num instante; -1 = indisponível
+typedef struct
+{
+    uint64_t ns;
+    int64_t readCalls;
+    int64_t writeCalls;
+    int64_t allocations;
+    int64_t allocatedBytes;
+} BenchSample;
+
+typedef struct
+{
+    const char *name;
+    size_t count;
+    uint64_t wallNs[BENCH_MAX_ITERATIONS];
+    int64_t readCalls;
+    int64_t writeCalls;
+    int64_t allocations;
+    int64_t allocatedBytes;
+    int64_t peakRssKb;
+    BenchSample start;
+} BenchPhase;
+
+enum
+{
+    BENCH_PHASE_FIXTURE,
+    BENCH_PHASE_GET_IDENTITY,
+    BENCH_PHASE_GET,
+    BENCH_PHASE_FOREACH,
+    BENCH_PHASE_GET_CACHED,
+    BENCH_PHASE_RELOAD,
+    BENCH_PHASE_MARK,
+    BENCH_PHASE_UNMARK,
+    BENCH_PHASE_COUNT
+};
+
+static const char *benchPhaseNames[BENCH_PHASE_COUNT] = {"fixture", "get-identity", "get", "foreach", "get-cached", "reload", "mark", "unmark"};
+
+// --- Contagem de alocações ---
+
+// Com glibc o executável substitui malloc/calloc/realloc e repassa ao
+// alocador da própria glibc; vale também para as chamadas de dentro da
+// biblioteca e da libc. free e as variantes alinhadas não são contadas.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static volatile int64_t benchAllocations;
+static volatile int64_t benchAllocatedBytes;
+
+static void benchCountAllocation(size_t size)
+{
+    __atomic_add_fetch(&benchAllocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&benchAllocatedBytes, (int64_t)size, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size)
+{
+    benchCountAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    benchCountAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    benchCountAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+// --- Métricas do processo ---
+
+static uint64_t benchNowNs(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Chamadas de leitura e escrita do processo inteiro: syscr/syscw no Linux,
+// operações de E/S contadas pelo kernel no Windows. Não é o total de
+// syscalls: open, ioctl, fstat e statvfs ficam fora.
+static void benchIoCalls(int64_t *reads, int64_t *writes)
+{
+    *reads = *writes = -1;
+
+#if defined(_WIN32)
+    IO_COUNTERS counters;
+    if (GetProcessIoCounters(GetCurrentProcess(), &counters))
+    {
+        *reads = (int64_t)counters.ReadOperationCount;
+        *writes = (int64_t)counters.WriteOperationCount;
+    }
+#elif defined(__linux__)
+    FILE *file = fopen("/proc/self/io", "r");
+    if (!file)
+        return;
+
+    char line[128];
+    while (fgets(line, sizeof(line), file))
+    {
+        long long value;
+        if (sscanf(line, "syscr: %lld", &value) == 1)
+            *reads = value;
+        else if (sscanf(line, "syscw: %lld", &value) == 1)
+            *writes = value;
+    }
+    fclose(file);
+#endif
+}
+
+// Pico do conjunto residente. No Linux o pico é zerado no começo de cada
+// fase (clear_refs 5); nos demais é o pico do processo até agora.
+static void benchResetPeakRss(void)
+{
+#ifdef __linux__
+    FILE *file = fopen("/proc/self/clear_refs", "w");
+    if (file)
+    {
+        fputs("5", file);
+        fclose(file);
+    }
+#endif
+}
+
+static int64_t benchPeakRssKb(void)
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return (int64_t)(counters.PeakWorkingSetSize / 1024);
+#elif defined(__linux__)
+    FILE *file = fopen("/proc/self/status", "r");
+    if (!file)
+        return -1;
+
+    char line[128];
+    long long value = -1;
+    while (fgets(line, sizeof(line), file))
+        if (sscanf(line, "VmHWM: %lld", &value) == 1)
+            break;
+    fclose(file);
+    return value;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return (int64_t)usage.ru_maxrss / 1024;
+#else
+    return (int64_t)usage.ru_maxrss;
+#endif
+#endif
+}
+
+static void benchSample(BenchSample *sample)
+{
+    benchIoCalls(&sample->readCalls, &sample->writeCalls);
+#ifdef BENCH_COUNT_ALLOCATIONS
+    sample->allocations = __atomic_load_n(&benchAllocations, __ATOMIC_RELAXED);
+    sample->allocatedBytes = __atomic_load_n(&benchAllocatedBytes, __ATOMIC_RELAXED);
+#else
+    sample->allocations = sample->allocatedBytes = -1;
+#endif
+    sample->ns = benchNowNs();
+}
+
+// --- Fases ---
+
+static void benchPhaseInit(BenchPhase *phase, const char *name)
+{
+    memset(phase, 0, sizeof(*phase));
+    phase->name = name;
+    phase->peakRssKb = -1;
+}
+
+static void benchPhaseBegin(BenchPhase *phase)
+{
+    benchResetPeakRss();
+    benchSample(&phase->start);
+}
+
+// Soma um contador; uma amostra indisponível torna a soma indisponível
+static void benchAccumulate(int64_t *total, int64_t start, int64_t end, bool first)
+{
+    if (start < 0 || end < 0 || (!first && *total < 0))
+        *total = -1;
+    else
+        *total += end - start;
+}
+
+static void benchPhaseEnd(BenchPhase *phase)
+{
+    uint64_t ns = benchNowNs();
+    BenchSample end;
+    benchSample(&end);
+
+    bool first = phase->count == 0;
+    benchAccumulate(&phase->readCalls, phase->start.readCalls, end.readCalls, first);
+    benchAccumulate(&phase->writeCalls, phase->start.writeCalls, end.writeCalls, first);
+    benchAccumulate(&phase->allocations, phase->start.allocations, end.allocations, first);
+    benchAccumulate(&phase->allocatedBytes, phase->start.allocatedBytes, end.allocatedBytes, first);
+
+    int64_t peak = benchPeakRssKb();
+    if (peak > phase->peakRssKb)
+        phase->peakRssKb = peak;
+
+    if (phase->count < BENCH_MAX_ITERATIONS)
+        phase->wallNs[phase->count++] = ns - phase->start.ns;
+}
+
+static int benchCompareNs(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void benchPrintMetric(FILE *out, const char *name, int64_t total, size_t count)
+{
+    if (total < 0 || count == 0)
+        fprintf(out, ",\"%s\":null", name);
+    else
+        fprintf(out, ",\"%s\":%" PRId64, name, total / (int64_t)count);
+}
+
+// Mediana e mínimo do tempo; contadores em média por iteração
+static void benchPhasePrint(FILE *out, BenchPhase *phase)
+{
+    uint64_t median = 0, minimum = 0;
+    if (phase->count > 0)
+    {
+        qsort(phase->wallNs, phase->count, sizeof(phase->wallNs[0]), benchCompareNs);
+        median = phase->wallNs[phase->count / 2];
+        minimum = phase->wallNs[0];
+    }
+
+    fprintf(out, "{\"phase\":\"%s\",\"iterations\":%zu,\"wallNsMedian\":%" PRIu64 ",\"wallNsMin\":%" PRIu64,
+            phase->name, phase->count, median, minimum);
+    benchPrintMetric(out, "readCalls", phase->readCalls, phase->count);
+    benchPrintMetric(out, "writeCalls", phase->writeCalls, phase->count);
+    benchPrintMetric(out, "allocations", phase->allocations, phase->count);
+    benchPrintMetric(out, "allocatedBytes", phase->allocatedBytes, phase->count);
+    benchPrintMetric(out, "peakRssKb", phase->peakRssKb, 1);
+    fputc('}', out);
+}
+
+// --- Gerador de imagens ---
+
+static uint32_t benchCrcTable[256];
+
+static uint32_t benchCrc32(const void *data, size_t len)
+{
+    if (!benchCrcTable[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            benchCrcTable[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (const uint8_t *p = data; len--; p++)
+        crc = benchCrcTable[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint64_t benchMix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// UUID v4 determinístico: a mesma configuração gera sempre as mesmas imagens
+static void benchUuid(uint8_t *uuid, size_t disk, uint64_t salt)
+{
+    uint64_t high = benchMix(((uint64_t)disk << 8) ^ salt);
+    uint64_t low = benchMix(high ^ salt);
+    memcpy(uuid, &high, 8);
+    memcpy(uuid + 8, &low, 8);
+    uuid[6] = (uint8_t)((uuid[6] & 0x0F) | 0x40);
+    uuid[8] = (uint8_t)((uuid[8] & 0x3F) | 0x80);
+}
+
+static bool benchPick(size_t disk, uint64_t salt, uint32_t percent)
+{
+    return benchMix(((uint64_t)disk << 8) ^ salt) % 100 < percent;
+}
+
+static void benchDiskPath(char *path, size_t size, const char *directory, size_t disk)
+{
+    snprintf(path, size, "%s/disk%05zu.img", directory, disk);
+}
+
+static bool benchWriteAt(FILE *file, uint64_t offset, const void *data, size_t len)
+{
+    return fseek(file, (long)offset, SEEK_SET) == 0 && fwrite(data, 1, len, file) == len;
+}
+
+// Cabeçalho GPT em lba com o CRC calculado; o setor restante fica zerado
+static void benchGptHeader(uint8_t *sector, const LibSpecialDrive_GPT_Header *base, uint64_t lba, uint64_t backupLba, uint64_t entriesLba)
+{
+    LibSpecialDrive_GPT_Header header = *base;
+    header.currentLba = lba;
+    header.backupLba = backupLba;
+    header.partitionEntriesLba = entriesLba;
+    header.crc32 = 0;
+    header.crc32 = benchCrc32(&header, sizeof(header));
+    memcpy(sector, &header, sizeof(header));
+}
+
+// Imagem esparsa de BENCH_DISK_SIZE bytes: MBR com a flag nos especiais e,
+// nos discos GPT, cabeçalho e tabela primários e de backup
+static bool benchWriteDisk(const char *path, const BenchConfig *config, size_t disk, bool mbr, bool special)
+{
+    uint32_t lba = config->lbaSize;
+    uint64_t sectors = BENCH_DISK_SIZE / lba;
+    uint64_t align = (1024 * 1024) / lba;
+    size_t tableBytes = (size_t)config->entries * BENCH_GPT_ENTRY_SIZE;
+    uint64_t tableSectors = (tableBytes + lba - 1) / lba;
+
+    uint8_t *head = calloc(1, (size_t)(2 + tableSectors) * lba);
+    uint8_t *backup = calloc(1, (size_t)(1 + tableSectors) * lba);
+    FILE *file = fopen(path, "wb");
+    bool ok = false;
+    if (!head || !backup || !file)
+        goto done;
+
+    LibSpecialDrive_Protective_MBR *pmbr = (LibSpecialDrive_Protective_MBR *)head;
+    if (special)
+    {
+        LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
+        benchUuid(flag.uuid, disk, 1);
+        memcpy(pmbr->boot_code, &flag, sizeof(flag));
+    }
+    pmbr->signature = 0xAA55;
+
+    if (mbr)
+    {
+        uint32_t count = config->entries < 4 ? config->entries : 4;
+        uint64_t each = (sectors - align) / count;
+        for (uint32_t p = 0; p < count; p++)
+        {
+            pmbr->partitions[p].partitionType = 0x83;
+            pmbr->partitions[p].firstLBA = (uint32_t)(align + p * each);
+            pmbr->partitions[p].sectors = (uint32_t)each;
+        }
+
+        uint8_t last = 0;
+        ok = benchWriteAt(file, 0, head, lba) && benchWriteAt(file, BENCH_DISK_SIZE - 1, &last, 1);
+        goto done;
+    }
+
+    pmbr->partitions[0].partitionType = 0xEE;
+    pmbr->partitions[0].firstLBA = 1;
+    pmbr->partitions[0].sectors = (uint32_t)(sectors - 1 > UINT32_MAX ? UINT32_MAX : sectors - 1);
+
+    // Linux filesystem data, 0FC63DAF-8483-4772-8E79-3D69D8477DE4
+    static const uint8_t linuxData[16] = {0xAF, 0x3D, 0xC6, 0x0F, 0x83, 0x84, 0x72, 0x47,
+                                          0x8E, 0x79, 0x3D, 0x69, 0xD8, 0x47, 0x7D, 0xE4};
+    uint8_t *table = head + 2 * lba;
+    uint64_t firstUsable = 2 + tableSectors;
+    uint64_t lastUsable = sectors - 2 - tableSectors;
+    uint64_t each = (lastUsable - firstUsable + 1) / config->entries;
+
+    for (uint32_t p = 0; p < config->entries; p++)
+    {
+        LibSpecialDrive_GPT_Partition_Entry *entry = (LibSpecialDrive_GPT_Partition_Entry *)(table + p * BENCH_GPT_ENTRY_SIZE);
+        memcpy(entry->partitionTypeGuid, linuxData, sizeof(linuxData));
+        benchUuid(entry->uniquePartitionGuid, disk, 2 + p);
+        entry->startingLba = firstUsable + p * each;
+        entry->endingLba = entry->startingLba + each - 1;
+    }
+
+    LibSpecialDrive_GPT_Header header = {0};
+    memcpy(&header.signature, GPT_SIGNATURE, 8);
+    header.revision = 0x00010000;
+    header.headerSize = sizeof(header);
+    header.firstUsableLba = firstUsable;
+    header.lastUsableLba = lastUsable;
+    benchUuid(header.diskGuid, disk, 0);
+    header.numPartitionEntries = config->entries;
+    header.sizeOfPartitionEntry = BENCH_GPT_ENTRY_SIZE;
+    header.partitionEntriesCrc32 = benchCrc32(table, tableBytes);
+
+    uint64_t backupEntries = sectors - 1 - tableSectors;
+    benchGptHeader(head + lba, &header, 1, sectors - 1, 2);
+    memcpy(backup, table, tableBytes);
+    benchGptHeader(backup + tableSectors * lba, &header, sectors - 1, 1, backupEntries);
+
+    ok = benchWriteAt(file, 0, head, (size_t)(2 + tableSectors) * lba) &&
+         benchWriteAt(file, backupEntries * lba, backup, (size_t)(1 + tableSectors) * lba);
+
+done:
+    if (file && fclose(file) != 0)
+        ok = false;
+    free(head);
+    free(backup);
+    return ok;
+}
+
+static bool benchFixtureCreate(const char *directory, const BenchConfig *config, size_t *special)
+{
+    *special = 0;
+    for (size_t disk = 0; disk < config->disks; disk++)
+    {
+        char path[4096];
+        bool isSpecial = benchPick(disk, 1, config->specialPercent);
+        benchDiskPath(path, sizeof(path), directory, disk);
+        if (!benchWriteDisk(path, config, disk, benchPick(disk, 2, config->mbrPercent), isSpecial))
+        {
+            fprintf(stderr, "Falha ao gravar %s\n", path);
+            return false;
+        }
+        *special += isSpecial;
+    }
+    return true;
+}
+
+static void benchFixtureRemove(const char *directory, size_t disks)
+{
+    for (size_t disk = 0; disk < disks; disk++)
+    {
+        char path[4096];
+        benchDiskPath(path, sizeof(path), directory, disk);
+        remove(path);
+    }
+}
+
+static bool benchMakeDirectory(const char *directory)
+{
+#ifdef _WIN32
+    return CreateDirectoryA(directory, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    struct stat st;
+    return mkdir(directory, 0755) == 0 || (stat(directory, &st) == 0 && S_ISDIR(st.st_mode));
+#endif
+}
+
+static bool benchTempDirectory(char *directory, size_t size)
+{
+#ifdef _WIN32
+    char base[MAX_PATH];
+    if (!GetTempPathA(sizeof(base), base))
+        return false;
+    snprintf(directory, size, "%sspecialdrive-bench-%lu", base, GetCurrentProcessId());
+    return benchMakeDirectory(directory);
+#else
+    const char *base = getenv("TMPDIR");
+    snprintf(directory, size, "%s/specialdrive-bench.XXXXXX", base && *base ? base : "/tmp");
+    return mkdtemp(directory) != NULL;
+#endif
+}
+
+static void benchRemoveDirectory(const char *directory)
+{
+#ifdef _WIN32
+    RemoveDirectoryA(directory);
+#else
+    rmdir(directory);
+#endif
+}
+
+// --- Execução ---
+
+static void benchCounts(const LibSpecialDrive *ctx, size_t *common, size_t *special)
+{
+    *common = ctx ? ctx->commonBlockDeviceCount : 0;
+    *special = ctx ? ctx->specialBlockDeviceCount : 0;
+}
+
+// Marca todos os comuns e desmarca os mesmos em seguida, deixando as
+// imagens como foram geradas
+static bool benchMarkRound(LibSpecialDrive *ctx, BenchPhase *mark, BenchPhase *unmark)
+{
+    size_t count = ctx->commonBlockDeviceCount;
+    if (count == 0)
+        return true;
+
+    int *indices = malloc(count * sizeof(*indices));
+    LibSpecialDrive_FlagResult *results = malloc(count * sizeof(*results));
+    bool ok = indices && results;
+
+    if (ok)
+    {
+        for (size_t i = 0; i < count; i++)
+            indices[i] = (int)i;
+
+        benchPhaseBegin(mark);
+        ok = LibSpecialDriveMarkBatch(ctx, indices, count, results);
+        benchPhaseEnd(mark);
+    }
+
+    if (ok)
+    {
+        for (size_t i = 0; i < count; i++)
+            indices[i] = results[i].index;
+
+        benchPhaseBegin(unmark);
+        ok = LibSpecialDriveUnmarkBatch(ctx, indices, count, results);
+        benchPhaseEnd(unmark);
+    }
+
+    free(indices);
+    free(results);
+    return ok && ctx->commonBlockDeviceCount == count;
+}
+
+// Contagem da enumeração em fluxo, conferida como a do contexto
+static bool benchForEachCount(const LibSpecialDrive_BlockDevice *blk, bool special, size_t index, void *user)
+{
+    (void)blk;
+    (void)index;
+    size_t *counts = user;
+    counts[special]++;
+    return true;
+}
+
+// Uma configuração completa: gera as imagens, mede cada fase e escreve a
+// linha JSON. Retorna false se alguma fase falhar ou as contagens não
+// baterem com o que foi gerado.
+static bool benchRun(const BenchConfig *config, const char *directory, bool keep, FILE *out)
+{
+    BenchPhase *phases = calloc(BENCH_PHASE_COUNT, sizeof(*phases));
+    if (!phases)
+        return false;
+    for (int i = 0; i < BENCH_PHASE_COUNT; i++)
+        benchPhaseInit(&phases[i], benchPhaseNames[i]);
+
+    char cachePath[4096];
+    snprintf(cachePath, sizeof(cachePath), "%s.cache", directory);
+    remove(cachePath);
+
+    size_t expectedSpecial = 0, common = 0, special = 0;
+    benchPhaseBegin(&phases[BENCH_PHASE_FIXTURE]);
+    bool ok = benchFixtureCreate(directory, config, &expectedSpecial);
+    benchPhaseEnd(&phases[BENCH_PHASE_FIXTURE]);
+
+    LibSpecialDrive_Backend *images = ok ? LibSpecialDriveBackendImageCreate(directory, config->lbaSize) : NULL;
+    ok = ok && images;
+
+    LibSpecialDrive_Options options = {0};
+    options.maxWorkers = config->workers;
+    options.backend = images;
+
+    for (size_t r = 0; ok && r < config->iterations; r++)
+    {
+        options.depth = PROBE_DEPTH_IDENTITY;
+        benchPhaseBegin(&phases[BENCH_PHASE_GET_IDENTITY]);
+        LibSpecialDrive *ctx = LibSpecialDriveGetEx(&options);
+        benchPhaseEnd(&phases[BENCH_PHASE_GET_IDENTITY]);
+        ok = ctx != NULL;
+        LibSpecialDriveDestroy(&ctx);
+
+        options.depth = PROBE_DEPTH_DEFAULT;
+        benchPhaseBegin(&phases[BENCH_PHASE_GET]);
+        ctx = LibSpecialDriveGetEx(&options);
+        benchPhaseEnd(&phases[BENCH_PHASE_GET]);
+        benchCounts(ctx, &common, &special);
+        ok = ok && ctx && special == expectedSpecial && common + special == config->disks;
+        LibSpecialDriveDestroy(&ctx);
+
+        size_t counts[2] = {0, 0};
+        benchPhaseBegin(&phases[BENCH_PHASE_FOREACH]);
+        ok = ok && LibSpecialDriveForEach(&options, benchForEachCount, counts);
+        benchPhaseEnd(&phases[BENCH_PHASE_FOREACH]);
+        ok = ok && counts[1] == expectedSpecial && counts[0] + counts[1] == config->disks;
+    }
+
+    // A primeira abertura com cache grava o arquivo e não é medida
+    options.cachePath = cachePath;
+    LibSpecialDrive *ctx = ok ? LibSpecialDriveGetEx(&options) : NULL;
+    ok = ok && ctx;
+    LibSpecialDriveDestroy(&ctx);
+
+    for (size_t r = 0; ok && r < config->iterations; r++)
+    {
+        benchPhaseBegin(&phases[BENCH_PHASE_GET_CACHED]);
+        ctx = LibSpecialDriveGetEx(&options);
+        benchPhaseEnd(&phases[BENCH_PHASE_GET_CACHED]);
+        ok = ctx != NULL;
+        LibSpecialDriveDestroy(&ctx);
+    }
+    options.cachePath = NULL;
+
+    ctx = ok ? LibSpecialDriveGetEx(&options) : NULL;
+    ok = ok && ctx;
+    for (size_t r = 0; ok && r < config->iterations; r++)
+    {
+        benchPhaseBegin(&phases[BENCH_PHASE_RELOAD]);
+        ok = LibSpecialDriveReload(ctx);
+        benchPhaseEnd(&phases[BENCH_PHASE_RELOAD]);
+    }
+
+    for (size_t r = 0; ok && r < config->iterations; r++)
+        ok = benchMarkRound(ctx, &phases[BENCH_PHASE_MARK], &phases[BENCH_PHASE_UNMARK]);
+
+    LibSpecialDriveDestroy(&ctx);
+    LibSpecialDriveBackendImageDestroy(&images);
+    remove(cachePath);
+    if (!keep)
+        benchFixtureRemove(directory, config->disks);
+
+    fprintf(out, "{\"disks\":%zu,\"entries\":%" PRIu32 ",\"lbaSize\":%" PRIu32 ",\"specialPercent\":%" PRIu32
+                 ",\"mbrPercent\":%" PRIu32 ",\"workers\":%zu,\"common\":%zu,\"special\":%zu,\"ok\":%s,\"phases\":[",
+            config->disks, config->entries, config->lbaSize, config->specialPercent, config->mbrPercent,
+            config->workers, common, special, ok ? "true" : "false");
+    for (int i = 0; i < BENCH_PHASE_COUNT; i++)
+    {
+        if (i > 0)
+            fputc(',', out);
+        benchPhasePrint(out, &phases[i]);
+    }
+    fputs("]}\n", out);
+    fflush(out);
+
+    free(phases);
+    return ok;
+}
+
+void printHelp(const char *progName)
+{
+    printf("Uso: %s [opções]\n", progName);
+    printf("Gera imagens esparsas e mede cada fase; uma linha JSON por configuração\n");
+    printf("Opções:\n");
+    printf("  -n <discos>    Número de imagens, de 1 a %d (padrão 1000)\n", BENCH_MAX_DISKS);
+    printf("  -e <entradas>  Entradas da tabela GPT, de 4 a 128 (padrão 128)\n");
+    printf("  -l <bytes>     Tamanho do setor: 512 ou 4096 (padrão 512)\n");
+    printf("  -s <percentual> Discos gerados já especiais (padrão 25)\n");
+    printf("  -m <percentual> Discos MBR; os demais são GPT (padrão 25)\n");
+    printf("  -r <vezes>     Repetições de cada fase, até %d (padrão 5)\n", BENCH_MAX_ITERATIONS);
+    printf("  -w <threads>   Threads de sondagem (padrão 0 = %d)\n", LIBSPECIAL_DEFAULT_WORKERS);
+    printf("  -d <diretório> Diretório das imagens (padrão: temporário)\n");
+    printf("  -k             Manter as imagens ao final\n");
+    printf("  -o <arquivo>   Gravar o resultado em <arquivo> (padrão: saída padrão)\n");
+    printf("  --sweep        Matriz: 1, 100, 1000 e 10000 discos x 4 e 128 entradas x 512 e 4096 bytes\n");
+    printf("  -h             Mostrar esta ajuda\n");
+    printf("Métricas por fase (média por repetição):\n");
+    printf("  readCalls/writeCalls  Só chamadas read*/write* (syscr/syscw; no Windows, operações de E/S);\n");
+    printf("                        open, ioctl e stat não são contados\n");
+    printf("  allocations/allocatedBytes  malloc/calloc/realloc (só glibc; null nas demais)\n");
+    printf("  peakRssKb             Pico de memória residente da fase (Linux; nas demais, do processo)\n");
+}
+
+int main(int argc, const char *argv[])
+{
+    BenchConfig config = {1000, 128, 512, 25, 25, 5, 0};
+    const char *directory = NULL;
+    const char *output = NULL;
+    bool keep = false;
+    bool sweep = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool value = i + 1 < argc;
+        if (strcmp(argv[i], "-n") == 0 && value)
+            config.disks = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-e") == 0 && value)
+            config.entries = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-l") == 0 && value)
+            config.lbaSize = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-s") == 0 && value)
+            config.specialPercent = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-m") == 0 && value)
+            config.mbrPercent = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-r") == 0 && value)
+            config.iterations = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-w") == 0 && value)
+            config.workers = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-d") == 0 && value)
+            directory = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && value)
+            output = argv[++i];
+        else if (strcmp(argv[i], "-k") == 0)
+            keep = true;
+        else if (strcmp(argv[i], "--sweep") == 0)
+            sweep = true;
+        else
+        {
+            if (strcmp(argv[i], "-h") != 0)
+                printf("Opção inválida: %s\n", argv[i]);
+            printHelp(argv[0]);
+            return strcmp(argv[i], "-h") == 0 ? 0 : 2;
+        }
+    }
+
+    if (config.disks < 1 || config.disks > BENCH_MAX_DISKS || config.entries < 4 || config.entries > 128 ||
+        (config.lbaSize != 512 && config.lbaSize != 4096) || config.specialPercent > 100 || config.mbrPercent > 100 ||
+        config.iterations < 1 || config.iterations > BENCH_MAX_ITERATIONS)
+    {
+        printf("Configuração fora dos limites\n");
+        printHelp(argv[0]);
+        return 2;
+    }
+
+    char temp[4096];
+    bool ownDirectory = !directory;
+    if (ownDirectory)
+    {
+        if (!benchTempDirectory(temp, sizeof(temp)))
+        {
+            perror("diretório temporário");
+            return 1;
+        }
+        directory = temp;
+    }
+    else if (!benchMakeDirectory(directory))
+    {
+        perror(directory);
+        return 1;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out)
+    {
+        perror(output);
+        return 1;
+    }
+
+    bool ok = true;
+    if (sweep)
+    {
+        static const size_t disks[] = {1, 100, 1000, 10000};
+        static const uint32_t entries[] = {4, 128};
+        static const uint32_t lbaSizes[] = {512, 4096};
+
+        for (size_t d = 0; d < sizeof(disks) / sizeof(disks[0]); d++)
+            for (size_t e = 0; e < sizeof(entries) / sizeof(entries[0]); e++)
+                for (size_t l = 0; l < sizeof(lbaSizes) / sizeof(lbaSizes[0]); l++)
+                {
+                    config.disks = disks[d];
+                    config.entries = entries[e];
+                    config.lbaSize = lbaSizes[l];
+                    // Cada configuração parte de um diretório vazio
+                    ok = benchRun(&config, directory, false, out) && ok;
+                }
+    }
+    else
+    {
+        ok = benchRun(&config, directory, keep, out);
+    }
+
+    if (output)
+        fclose(out);
+    if (ownDirectory && !keep)
+        benchRemoveDirectory(directory);
+    return ok ? 0 : 1;
+}
@@ -1,15 +1,31 @@
 #include <LibSpecialDrive.h>
 #include <inttypes.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-void listPartition(LibSpecialDrive_BlockDevice *blk)
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <time.h>
+#endif
+
+#define WATCH_DEFAULT_INTERVAL_MS 10000
+#define WATCH_DEFAULT_DELTA (64ull * 1024 * 1024)
+#define WATCH_DEBOUNCE_MS 250
+
+void listPartition(const LibSpecialDrive_BlockDevice *blk)
 {
+    if (blk && (blk->flags & BLOCK_FLAG_GPT_CORRUPT))
+        printf("\tGPT corrompida: nenhuma cópia passou no CRC\n");
+
     if (!blk || blk->partitionCount <= 0)
         return;
 
-    printf("\t%s\n", blk->type == PARTITION_TYPE_GPT ? "GPT" : "MBR");
+    printf("\t%s%s\n", blk->type == PARTITION_TYPE_GPT ? "GPT" : "MBR",
+           (blk->flags & BLOCK_FLAG_GPT_FROM_BACKUP) ? " (lida do backup)" : "");
 
     for (int i = 0; i < blk->partitionCount; i++)
     {
@@ -18,9 +34,8 @@ void listPartition(LibSpecialDrive_BlockDevice *blk)
 
         if (blk->type == PARTITION_TYPE_GPT)
         {
-            char *uuidStr = LibSpecialDriveGenUUIDString(part->partitionMeta.gpt.uniquePartitionGuid);
-            printf("\t\tUUID: %s\n", uuidStr);
-            LibSpecialDriveFree(uuidStr);
+            char uuidStr[LIBSPECIAL_UUID_STRING_SIZE];
+            printf("\t\tUUID: %s\n", LibSpecialDriveFormatUUID(part->partitionMeta.gpt.uniquePartitionGuid, uuidStr));
         }
 
         printf("\t\tVolume Path: %s\n\t\tFree Space: %" PRIu64 " bytes\n", (part->path ? part->path : "None"), part->freeSpace);
@@ -53,19 +68,450 @@ void listBlock(LibSpecialDrive *lb, bool listPart, bool hiddenBlock)
         {
             LibSpecialDrive_BlockDevice *bd = &lb->specialBlockDevices[i];
             LibSpecialDrive_Flag *flag = (LibSpecialDrive_Flag *)bd->signature->boot_code;
-            char *uuidStr = LibSpecialDriveGenUUIDString(flag->uuid);
+            char uuidStr[LIBSPECIAL_UUID_STRING_SIZE];
 
             if (!hiddenBlock)
                 printf("Special Device %zu: %s, Size: %" PRIu64 " bytes, Removable: %s\n\tSpecial UUID:%s\n",
                        i, bd->path, bd->size,
-                       (bd->flags & BLOCK_FLAG_IS_REMOVABLE) ? "Yes" : "No", uuidStr);
+                       (bd->flags & BLOCK_FLAG_IS_REMOVABLE) ? "Yes" : "No", LibSpecialDriveFormatUUID(flag->uuid, uuidStr));
 
             if (listPart)
                 listPartition(bd);
+        }
+    }
+}
+
+// Saída para coletores: o contexto inteiro pelo escritor em fluxo da
+// biblioteca, direto no stdout
+void listMachine(LibSpecialDrive *lb, enum LibSpecialDrive_WriterFormat format, bool listPart)
+{
+    if (!lb)
+        return;
+
+    uint8_t buffer[16 * 1024];
+    LibSpecialDrive_Writer writer;
+
+    fflush(stdout);
+    LibSpecialDriveWriterInitFd(&writer, format, listPart ? 0 : WRITER_FLAG_NO_PARTITIONS, fileno(stdout), buffer, sizeof(buffer));
+    LibSpecialDriveWriterContext(&writer, lb);
+    LibSpecialDriveWriterFlush(&writer);
+}
+
+// --- Enumeração em fluxo (--stream) ---
+
+// Cada dispositivo sai assim que é sondado, sem montar o contexto; listPart
+// e hiddenBlock como em listBlock e listMachine
+typedef struct
+{
+    int format; // -1 = texto; senão enum LibSpecialDrive_WriterFormat
+    bool listPart;
+    bool hiddenBlock;
+    LibSpecialDrive_Writer writer;
+    uint8_t buffer[16 * 1024];
+} StreamState;
+
+static bool streamBlock(const LibSpecialDrive_BlockDevice *blk, bool special, size_t index, void *user)
+{
+    StreamState *state = user;
+
+    if (state->format >= 0)
+    {
+        LibSpecialDriveWriterBlock(&state->writer, blk, special, index);
+        LibSpecialDriveWriterFlush(&state->writer);
+        return !state->writer.failed;
+    }
+
+    if (!state->hiddenBlock)
+        printf("%s Device %zu: %s, Size: %" PRIu64 " bytes, Removable: %s\n", special ? "Special" : "Common",
+               index, blk->path, blk->size, (blk->flags & BLOCK_FLAG_IS_REMOVABLE) ? "Yes" : "No");
+    if (state->listPart)
+        listPartition(blk);
+    fflush(stdout);
+    return true;
+}
+
+void streamDevices(const LibSpecialDrive_Options *options, int format, bool listPart, bool hiddenBlock)
+{
+    StreamState *state = calloc(1, sizeof(*state));
+    if (!state)
+        return;
+
+    state->format = format;
+    state->listPart = listPart;
+    state->hiddenBlock = hiddenBlock;
+    fflush(stdout);
+    if (format >= 0)
+        LibSpecialDriveWriterInitFd(&state->writer, (enum LibSpecialDrive_WriterFormat)format, listPart ? 0 : WRITER_FLAG_NO_PARTITIONS,
+                                    fileno(stdout), state->buffer, sizeof(state->buffer));
+
+    if (!LibSpecialDriveForEach(options, streamBlock, state))
+        fprintf(stderr, "Falha na enumeração\n");
+    free(state);
+}
+
+// Converte "1,4,7" em índices; retorna a quantidade lida
+size_t parseIds(const char *arg, int *ids, size_t max)
+{
+    size_t count = 0;
+    while (arg && *arg && count < max)
+    {
+        char *end;
+        ids[count++] = (int)strtol(arg, &end, 10);
+        if (*end != ',')
+            break;
+        arg = end + 1;
+    }
+    return count;
+}
+
+// Marca ou desmarca um lote de índices e mostra o resultado de cada um
+void flagBlocks(LibSpecialDrive *lb, const char *arg, bool mark)
+{
+    static const char *statusText[] = {"Sucesso", "Índice inválido", "Falha ao abrir", "Falha de E/S", "Falha no flush"};
+    int ids[256];
+    LibSpecialDrive_FlagResult results[256];
+    size_t count = parseIds(arg, ids, sizeof(ids) / sizeof(ids[0]));
+    for (size_t i = 0; i < count; i++)
+        results[i] = (LibSpecialDrive_FlagResult){FLAG_STATUS_INVALID, {0}, -1};
+
+    bool ok = mark ? LibSpecialDriveMarkBatch(lb, ids, count, results)
+                   : LibSpecialDriveUnmarkBatch(lb, ids, count, results);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        printf("%s %d: %s", mark ? "Marca" : "Desmarca", ids[i], statusText[results[i].status]);
+        if (results[i].index >= 0)
+            printf(" (agora %s %d)", mark ? "especial" : "comum", results[i].index);
+        printf("\n");
+    }
+    if (count != 1)
+        printf("%s: %s\n", mark ? "Marca" : "Desmarca", ok ? "Sucesso" : "Falha");
+}
+
+// --- Monitoramento (--watch) ---
+
+static volatile sig_atomic_t watchStop = 0;
+
+static void watchSignal(int sig)
+{
+    (void)sig;
+    watchStop = 1;
+}
+
+static uint64_t watchNowMs(void)
+{
+#ifdef _WIN32
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
+}
+
+// Último espaço livre informado de cada partição montada
+typedef struct
+{
+    char *path;
+    uint64_t freeSpace;
+    bool seen;
+} WatchFreeSpace;
+
+typedef struct
+{
+    LibSpecialDrive *lb;
+    int format;     // -1 = texto; senão enum LibSpecialDrive_WriterFormat
+    uint64_t delta; // variação mínima do espaço livre para informar
+    WatchFreeSpace *spaces;
+    size_t spaceCount;
+    size_t spaceCapacity;
+    LibSpecialDrive_Writer writer;
+    uint8_t buffer[16 * 1024];
+} WatchState;
+
+static LibSpecialDrive_BlockDevice *watchFind(LibSpecialDrive *lb, const char *path, bool special, size_t *index)
+{
+    LibSpecialDrive_BlockDevice *blocks = special ? lb->specialBlockDevices : lb->commonBlockDevices;
+    size_t count = special ? lb->specialBlockDeviceCount : lb->commonBlockDeviceCount;
+
+    for (size_t i = 0; path && i < count; i++)
+    {
+        if (blocks[i].path && strcmp(blocks[i].path, path) == 0)
+        {
+            *index = i;
+            return &blocks[i];
+        }
+    }
+    return NULL;
+}
+
+static void watchChange(WatchState *state, const LibSpecialDrive_Change *change)
+{
+    size_t index = 0;
+    LibSpecialDrive_BlockDevice *blk = change->type == CHANGE_REMOVED ? NULL : watchFind(state->lb, change->path, change->special, &index);
+
+    if (state->format >= 0)
+    {
+        // Adicionado/alterado levam o registro completo logo em seguida
+        LibSpecialDriveWriterChange(&state->writer, change);
+        if (blk)
+            LibSpecialDriveWriterBlock(&state->writer, blk, change->special, index);
+        return;
+    }
+
+    if (change->type == CHANGE_REMOVED)
+        printf("- %s\n", change->path);
+    else if (blk)
+        printf("%c %s (%s %zu), Size: %" PRIu64 " bytes\n", change->type == CHANGE_ADDED ? '+' : '*',
+               change->path, change->special ? "especial" : "comum", index, blk->size);
+}
+
+static void watchChanges(WatchState *state, const LibSpecialDrive_ChangeList *changes)
+{
+    for (size_t i = 0; i < changes->count; i++)
+        watchChange(state, &changes->items[i]);
+}
 
-            free(uuidStr);
+static WatchFreeSpace *watchFreeSpaceEntry(WatchState *state, const char *path, bool *created)
+{
+    for (size_t i = 0; i < state->spaceCount; i++)
+    {
+        if (strcmp(state->spaces[i].path, path) == 0)
+        {
+            *created = false;
+            return &state->spaces[i];
         }
     }
+
+    if (state->spaceCount == state->spaceCapacity)
+    {
+        size_t capacity = state->spaceCapacity ? state->spaceCapacity * 2 : 16;
+        WatchFreeSpace *spaces = realloc(state->spaces, capacity * sizeof(*spaces));
+        if (!spaces)
+            return NULL;
+        state->spaces = spaces;
+        state->spaceCapacity = capacity;
+    }
+
+    size_t len = strlen(path) + 1;
+    WatchFreeSpace *entry = &state->spaces[state->spaceCount];
+    entry->path = malloc(len);
+    if (!entry->path)
+        return NULL;
+    memcpy(entry->path, path, len);
+    entry->freeSpace = 0;
+    state->spaceCount++;
+    *created = true;
+    return entry;
+}
+
+// Informa partições recém-montadas e variações de pelo menos delta bytes
+static void watchBlockFreeSpace(WatchState *state, LibSpecialDrive_BlockDevice *blk)
+{
+    for (int i = 0; i < blk->partitionCount; i++)
+    {
+        LibSpecialDrive_Partition *part = &blk->partitions[i];
+        if (!part->path || !part->mountPoint || part->freeSpaceMs == 0)
+            continue;
+
+        bool created;
+        WatchFreeSpace *entry = watchFreeSpaceEntry(state, part->path, &created);
+        if (!entry)
+            continue;
+        entry->seen = true;
+
+        uint64_t previous = entry->freeSpace;
+        uint64_t diff = part->freeSpace > previous ? part->freeSpace - previous : previous - part->freeSpace;
+        if (!created && diff < state->delta)
+            continue;
+
+        if (state->format >= 0)
+            LibSpecialDriveWriterFreeSpace(&state->writer, part, previous);
+        else if (created)
+            printf("Espaço livre %s (%s): %" PRIu64 " bytes\n", part->path, part->mountPoint, part->freeSpace);
+        else
+            printf("Espaço livre %s (%s): %" PRIu64 " bytes (%c%" PRIu64 ")\n", part->path, part->mountPoint,
+                   part->freeSpace, part->freeSpace > previous ? '+' : '-', diff);
+        entry->freeSpace = part->freeSpace;
+    }
+}
+
+static void watchFreeSpace(WatchState *state)
+{
+    LibSpecialDrive *lb = state->lb;
+    for (size_t i = 0; i < state->spaceCount; i++)
+        state->spaces[i].seen = false;
+
+    for (size_t i = 0; i < lb->commonBlockDeviceCount; i++)
+        watchBlockFreeSpace(state, &lb->commonBlockDevices[i]);
+    for (size_t i = 0; i < lb->specialBlockDeviceCount; i++)
+        watchBlockFreeSpace(state, &lb->specialBlockDevices[i]);
+
+    // Partições desmontadas ou removidas voltam como novas se reaparecerem
+    size_t kept = 0;
+    for (size_t i = 0; i < state->spaceCount; i++)
+    {
+        if (state->spaces[i].seen)
+            state->spaces[kept++] = state->spaces[i];
+        else
+            free(state->spaces[i].path);
+    }
+    state->spaceCount = kept;
+}
+
+static void watchFlush(WatchState *state)
+{
+    if (state->format >= 0)
+        LibSpecialDriveWriterFlush(&state->writer);
+    else
+        fflush(stdout);
+}
+
+// Espera o próximo evento; retorna true se a tabela de montagem mudou
+static bool watchWait(LibSpecialDrive_Watcher *watcher, int mountFd, int timeoutMs)
+{
+#ifdef _WIN32
+    // Sem netlink nem fd da tabela de montagem: só o intervalo
+    (void)watcher;
+    (void)mountFd;
+    Sleep((DWORD)timeoutMs);
+    return false;
+#else
+    struct pollfd fds[2];
+    nfds_t count = 0;
+    int watchFd = LibSpecialDriveWatcherGetFd(watcher);
+
+    if (watchFd >= 0)
+        fds[count++] = (struct pollfd){watchFd, POLLIN, 0};
+    if (mountFd >= 0)
+        fds[count++] = (struct pollfd){mountFd, POLLPRI, 0};
+
+    if (poll(fds, count, timeoutMs) <= 0 || mountFd < 0)
+        return false;
+    return (fds[count - 1].revents & (POLLPRI | POLLERR)) != 0;
+#endif
+}
+
+// Mantém o contexto vivo e mostra só as diferenças: dispositivos
+// adicionados, removidos e alterados (hotplug, ou recarga completa a cada
+// intervalMs; 0 = só hotplug) e variações de espaço livre de pelo menos
+// delta bytes, consultadas na validade do cache de espaço livre
+void watchDevices(LibSpecialDrive *lb, int format, uint32_t intervalMs, uint64_t delta)
+{
+    if (!lb)
+        return;
+
+    WatchState *state = calloc(1, sizeof(*state));
+    if (!state)
+        return;
+    state->lb = lb;
+    state->format = format;
+    state->delta = delta;
+
+    fflush(stdout);
+    if (format >= 0)
+        LibSpecialDriveWriterInitFd(&state->writer, (enum LibSpecialDrive_WriterFormat)format, 0, fileno(stdout), state->buffer, sizeof(state->buffer));
+
+    LibSpecialDrive_EventSource source;
+    LibSpecialDrive_Watcher *watcher = NULL;
+    if (LibSpecialDriveEventSourceNetlink(&source))
+    {
+        watcher = LibSpecialDriveWatcherCreate(lb, &source, WATCH_DEBOUNCE_MS, NULL, NULL);
+        if (!watcher && source.close)
+            source.close(source.user);
+    }
+
+    // Obtido uma vez: a própria recarga consome a mudança da tabela
+    int mountFd = LibSpecialDriveMountTableGetFd();
+
+    signal(SIGINT, watchSignal);
+    signal(SIGTERM, watchSignal);
+
+    // Estado inicial: todo dispositivo aparece como adicionado
+    for (int special = 0; special < 2; special++)
+    {
+        LibSpecialDrive_BlockDevice *blocks = special ? lb->specialBlockDevices : lb->commonBlockDevices;
+        size_t count = special ? lb->specialBlockDeviceCount : lb->commonBlockDeviceCount;
+        for (size_t i = 0; i < count; i++)
+        {
+            LibSpecialDrive_Change change = {CHANGE_ADDED, blocks[i].devId, blocks[i].path, special != 0};
+            watchChange(state, &change);
+        }
+    }
+    LibSpecialDriveRefreshFreeSpace(lb, false);
+    watchFreeSpace(state);
+    watchFlush(state);
+
+    LibSpecialDrive_ChangeList changes = {0};
+    uint64_t nextReload = watchNowMs() + intervalMs;
+
+    while (!watchStop)
+    {
+        uint64_t now = watchNowMs();
+        uint64_t wait = lb->options.freeSpaceTtlMs < INT32_MAX ? lb->options.freeSpaceTtlMs : INT32_MAX;
+        uint64_t untilReload = nextReload > now ? nextReload - now : 0;
+        if (intervalMs > 0 && untilReload < wait)
+            wait = untilReload;
+
+        int timeout = LibSpecialDriveWatcherGetTimeout(watcher);
+        if (timeout < 0 || (uint64_t)timeout > wait)
+            timeout = (int)wait;
+
+        bool mountsChanged = watchWait(watcher, mountFd, timeout);
+        if (watchStop)
+            break;
+
+        if (watcher && LibSpecialDriveWatcherDispatch(watcher, &changes))
+            watchChanges(state, &changes);
+        LibSpecialDriveChangeListClear(&changes);
+
+        if (mountsChanged || (intervalMs > 0 && watchNowMs() >= nextReload))
+        {
+            if (LibSpecialDriveReloadDiff(lb, &changes))
+                watchChanges(state, &changes);
+            LibSpecialDriveChangeListClear(&changes);
+            if (intervalMs > 0 && watchNowMs() >= nextReload)
+                nextReload = watchNowMs() + intervalMs;
+        }
+
+        LibSpecialDriveRefreshFreeSpace(lb, false);
+        watchFreeSpace(state);
+        watchFlush(state);
+    }
+
+    LibSpecialDriveWatcherDestroy(&watcher);
+    for (size_t i = 0; i < state->spaceCount; i++)
+        free(state->spaces[i].path);
+    free(state->spaces);
+    free(state);
+}
+
+// Tempo por fase e dispositivos mais lentos, no stderr para não misturar
+// com as listagens jsonl/bin do stdout
+void printStats(void)
+{
+    LibSpecialDrive_Stats stats;
+    if (!LibSpecialDriveGetStats(&stats))
+    {
+        fprintf(stderr, "Estatísticas indisponíveis: biblioteca compilada sem LIBSPECIAL_STATS\n");
+        return;
+    }
+
+    fprintf(stderr, "%-16s %10s %12s %14s\n", "Fase", "Chamadas", "Tempo (ms)", "Bytes");
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+    {
+        const LibSpecialDrive_PhaseStats *phase = &stats.phases[i];
+        fprintf(stderr, "%-16s %10" PRIu64 " %12.3f %14" PRIu64 "\n", LibSpecialDriveStatsPhaseName((enum LibSpecialDrive_StatsPhase)i),
+                phase->calls, (double)phase->ns / 1e6, phase->bytes);
+    }
+
+    fprintf(stderr, "Dispositivos sondados: %" PRIu64 "\n", stats.devices);
+    for (size_t i = 0; i < stats.slowestCount; i++)
+    {
+        const LibSpecialDrive_DeviceStats *device = &stats.slowest[i];
+        fprintf(stderr, "\t%s: %.3f ms (%s: %.3f ms)\n", device->path, (double)device->ns / 1e6,
+                LibSpecialDriveStatsPhaseName((enum LibSpecialDrive_StatsPhase)device->phase), (double)device->phaseNs / 1e6);
+    }
 }
 
 void printHelp(const char *progName)
@@ -76,8 +522,18 @@ void printHelp(const char *progName)
     printf("  -b             Listar apenas blocos\n");
     printf("  -p             Listar apenas partições\n");
     printf("  -r             Recarrega os dispositivos\n");
-    printf("  -m <id>        Marcar bloco comum com índice <id> como especial\n");
-    printf("  -u <id>        Desmarcar bloco especial com índice <id>\n");
+    printf("  -m <id>[,<id>] Marcar blocos comuns com os índices <id> como especiais\n");
+    printf("  -u <id>[,<id>] Desmarcar blocos especiais com os índices <id>\n");
+    printf("  -c <arquivo>   Usar <arquivo> como cache da sondagem entre execuções\n");
+    printf("  -i <diretório> Usar os arquivos de imagem de <diretório> como dispositivos\n");
+    printf("  -o <formato>   Formato das listagens seguintes: texto (padrão), jsonl ou bin\n");
+    printf("  --publish <nome> Publicar o resultado no segmento compartilhado <nome> para outros processos\n");
+    printf("  --watch        Monitorar e mostrar só as diferenças até Ctrl+C\n");
+    printf("  --interval <ms>  Recarga completa no --watch a cada <ms> (padrão %d, 0 = só hotplug)\n", WATCH_DEFAULT_INTERVAL_MS);
+    printf("  --delta <bytes>  Variação mínima de espaço livre mostrada no --watch (padrão %llu)\n", WATCH_DEFAULT_DELTA);
+    printf("  --stream       Listagens (-a, -b, -p; -a se nenhuma) saem à medida que cada dispositivo é sondado,\n");
+    printf("                 sem montar o contexto; não combina com -m, -u, -r, -c, --publish e --watch\n");
+    printf("  --stats        Mostrar no stderr, ao final, o tempo por fase e os dispositivos mais lentos\n");
     printf("  -h             Mostrar esta ajuda\n");
 }
 
@@ -89,36 +545,132 @@ int main(int argc, const char *argv[])
         return 0;
     }
 
-    LibSpecialDrive *lb = LibSpecialDriveGet();
+    // Opções do contexto vêm antes das ações, que já usam o contexto
+    LibSpecialDrive_Options options = {0};
+    LibSpecialDrive_Backend *images = NULL;
+    bool stats = false;
+    bool stream = false;
+    bool listed = false;             // há -a, -b ou -p
+    const char *needsContext = NULL; // primeira ação que depende do contexto
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--stats") == 0)
+        {
+            LibSpecialDriveStatsEnable(true);
+            stats = true;
+        }
+        else if (strcmp(argv[i], "--stream") == 0)
+        {
+            stream = true;
+        }
+        else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "-p") == 0)
+        {
+            listed = true;
+        }
+        else if (!needsContext && (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "-r") == 0 ||
+                                   strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--publish") == 0 || strcmp(argv[i], "--watch") == 0))
+        {
+            needsContext = argv[i];
+        }
+    }
+
+    // Sem contexto não há índices para marcar nem o que recarregar ou publicar
+    if (stream && needsContext)
+    {
+        printf("--stream não pode ser combinado com %s\n", needsContext);
+        return 1;
+    }
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0)
+            options.cachePath = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && !images)
+            options.backend = images = LibSpecialDriveBackendImageCreate(argv[++i], 0);
+        else if (strcmp(argv[i], "--publish") == 0)
+            options.shmName = argv[++i];
+    }
+
+    // --stream enumera sem contexto, a cada listagem
+    LibSpecialDrive *lb = stream ? NULL : LibSpecialDriveGetEx(&options);
+    int format = -1; // texto; senão enum LibSpecialDrive_WriterFormat
+    uint32_t watchInterval = WATCH_DEFAULT_INTERVAL_MS;
+    uint64_t watchDelta = WATCH_DEFAULT_DELTA;
 
     for (int i = 1; i < argc; i++)
     {
-        if (strcmp(argv[i], "-a") == 0)
+        if (stream && (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "-p") == 0))
+        {
+            streamDevices(&options, format, argv[i][1] != 'b', argv[i][1] == 'p');
+        }
+        else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "-p") == 0)
         {
-            listBlock(lb, true, false);
+            // Espaço livre só é consultado quando listado, todo num lote
+            LibSpecialDriveRefreshFreeSpace(lb, false);
+            if (format >= 0)
+                listMachine(lb, (enum LibSpecialDrive_WriterFormat)format, true);
+            else
+                listBlock(lb, true, argv[i][1] == 'p');
         }
         else if (strcmp(argv[i], "-b") == 0)
         {
-            listBlock(lb, false, false);
+            if (format >= 0)
+                listMachine(lb, (enum LibSpecialDrive_WriterFormat)format, false);
+            else
+                listBlock(lb, false, false);
         }
-        else if (strcmp(argv[i], "-p") == 0)
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
         {
-            listBlock(lb, true, true);
+            const char *name = argv[++i];
+            if (strcmp(name, "jsonl") == 0)
+                format = WRITER_FORMAT_JSONL;
+            else if (strcmp(name, "bin") == 0)
+                format = WRITER_FORMAT_BINARY;
+            else if (strcmp(name, "texto") == 0)
+                format = -1;
+            else
+            {
+                printf("Formato inválido: %s\n", name);
+                break;
+            }
         }
         else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
         {
-            int id = atoi(argv[++i]);
-            printf("Marca: %s\n", LibSpecialDriveMark(lb, id) == 1 ? "Sucesso" : "Falha");
+            flagBlocks(lb, argv[++i], true);
         }
         else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
         {
-            int id = atoi(argv[++i]);
-            printf("Desmarca: %s\n", LibSpecialDriveUnmark(lb, id) == 1 ? "Sucesso" : "Falha");
+            flagBlocks(lb, argv[++i], false);
+        }
+        else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--publish") == 0) && i + 1 < argc)
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+        {
+            watchInterval = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--delta") == 0 && i + 1 < argc)
+        {
+            watchDelta = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--watch") == 0)
+        {
+            watchDevices(lb, format, watchInterval, watchDelta);
         }
         else if (strcmp(argv[i], "-h") == 0)
         {
             printHelp(argv[0]);
         }
+        else if (strcmp(argv[i], "--stream") == 0)
+        {
+            if (!listed)
+                streamDevices(&options, format, true, false);
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            // ligada antes de criar o contexto; o resumo sai no final
+        }
         else if (strcmp(argv[i], "-r") == 0)
         {
             LibSpecialDriveReload(lb);
@@ -131,6 +683,10 @@ int main(int argc, const char *argv[])
         }
     }
 
+    if (stats)
+        printStats();
+
     LibSpecialDriveDestroy(&lb);
+    LibSpecialDriveBackendImageDestroy(&images);
     return 0;
 }
@@ -19,6 +19,8 @@
 // Constantes da GPT
 // =====================================================================================
 #define GPT_SIGNATURE "EFI PART"
+#define LIBSPECIAL_GPT_ENTRIES_BYTES (128 * 128)          // tabela padrão: 128 entradas de 128 bytes
+#define LIBSPECIAL_GPT_ENTRIES_MAX_BYTES (4 * 1024 * 1024) // limite contra cabeçalhos corrompidos
 
 // =====================================================================================
 // Estruturas GPT (GUID Partition Table)
@@ -85,7 +87,9 @@ PACKED_END
 enum LibSpecialDrive_BlockFlags
 {
     BLOCK_FLAG_IS_REMOVABLE = 1 << 0,
-    BLOCK_FLAG_IS_READ_ONLY = 1 << 1
+    BLOCK_FLAG_IS_READ_ONLY = 1 << 1,
+    BLOCK_FLAG_GPT_FROM_BACKUP = 1 << 2, // GPT primária inválida, partições lidas do backup
+    BLOCK_FLAG_GPT_CORRUPT = 1 << 3      // nenhuma cópia da GPT passou no CRC
 };
 
 enum LibSpecialDrive_PartitionType
@@ -95,6 +99,16 @@ enum LibSpecialDrive_PartitionType
     PARTITION_TYPE_MBR = 2
 };
 
+// Profundidade da sondagem; cada nível inclui o anterior
+enum LibSpecialDrive_ProbeDepth
+{
+    PROBE_DEPTH_DEFAULT = 0,    // PROBE_DEPTH_FULL
+    PROBE_DEPTH_IDENTITY = 1,   // só o LBA 0: MBR e flag de dispositivo especial
+    PROBE_DEPTH_PARTITIONS = 2, // + tabela de partições e caminhos das partições
+    PROBE_DEPTH_MOUNTS = 3,     // + pontos de montagem
+    PROBE_DEPTH_FULL = 4        // + espaço livre (statvfs, sob demanda; ver LibSpecialDriveGetFreeSpace)
+};
+
 // =====================================================================================
 // Estruturas Principais
 // =====================================================================================
@@ -109,10 +123,21 @@ typedef struct
     char *path;
     char *mountPoint;
     uint32_t *lbaSize;
-    uint64_t freeSpace;
+    uint64_t freeSpace;   // em cache; ver LibSpecialDriveGetFreeSpace
+    uint64_t freeSpaceMs; // LibSpecialDriveNowMs da consulta (0 = nunca consultado)
     union LibSpecialDrive_PartitionMeta partitionMeta;
 } LibSpecialDrive_Partition;
 
+// Impressão digital barata usada pelo recarregamento incremental
+typedef struct
+{
+    uint64_t size;
+    uint64_t diskSeq;      // diskseq do kernel (0 se indisponível)
+    uint64_t identity;     // hash do WWID/número de série (0 se indisponível)
+    uint32_t gptHeaderCrc; // campo crc32 do cabeçalho GPT (0 se MBR)
+    uint64_t stamp;        // mtime do nó ou da imagem vista pela descoberta (0 se indisponível)
+} LibSpecialDrive_Fingerprint;
+
 typedef struct
 {
     enum LibSpecialDrive_PartitionType type;
@@ -123,16 +148,268 @@ typedef struct
     int8_t flags;
     char *path;
     LibSpecialDrive_Protective_MBR *signature;
+    uint64_t devId; // dev_t (POSIX) ou número do disco (Windows)
+    LibSpecialDrive_Fingerprint fingerprint;
+    uint8_t depth; // enum LibSpecialDrive_ProbeDepth já sondada
+    const struct LibSpecialDrive_Backend *backend; // E/S do bloco (NULL = sistema)
 } LibSpecialDrive_BlockDevice;
 
+// Arena de alocação: a memória do contexto é liberada de uma só vez
+#define LIBSPECIAL_ARENA_CHUNK_MIN (16 * 1024)
+#define LIBSPECIAL_ARENA_CHUNK_MAX (1024 * 1024)
+
+typedef struct LibSpecialDrive_ArenaChunk LibSpecialDrive_ArenaChunk;
+
+typedef struct
+{
+    LibSpecialDrive_ArenaChunk *head; // bloco atual; os anteriores seguem encadeados
+    size_t chunkSize;                 // tamanho do próximo bloco (0 = LIBSPECIAL_ARENA_CHUNK_MIN)
+} LibSpecialDrive_Arena;
+
+typedef struct
+{
+    LibSpecialDrive_ArenaChunk *chunk;
+    size_t used;
+} LibSpecialDrive_ArenaMark;
+
+// Índice UUID da flag -> posição em specialBlockDevices, com endereçamento
+// aberto; reconstruído sempre que as listas do contexto mudam
+typedef struct
+{
+    uint32_t *slots; // posição + 1; 0 = vazio
+    size_t mask;     // capacidade - 1 (capacidade potência de 2)
+} LibSpecialDrive_UUIDIndex;
+
+// Número de threads de sondagem usado quando maxWorkers é 0
+#define LIBSPECIAL_DEFAULT_WORKERS 8
+
+// Candidatos sondados juntos por LibSpecialDriveForEach; limita a memória
+// da enumeração em fluxo independentemente do número de dispositivos
+#define LIBSPECIAL_FOREACH_WINDOW 64
+
+// Validade do espaço livre em cache e espera máxima pelo statvfs
+#define LIBSPECIAL_DEFAULT_FREE_SPACE_TTL_MS 5000
+#define LIBSPECIAL_DEFAULT_FREE_SPACE_TIMEOUT_MS 1000
+
+enum LibSpecialDrive_OptionFlags
+{
+    LIBSPECIAL_OPT_PROC_PARTITIONS = 1 << 1 // Linux: descoberta por /proc/partitions em vez do sysfs
+};
+
+// major:minor do dispositivo; no Windows major é 0 e minor o número do disco
+#define LIBSPECIAL_ANY_MINOR UINT32_MAX
+
+typedef struct
+{
+    uint32_t major;
+    uint32_t minor; // LIBSPECIAL_ANY_MINOR = qualquer minor do major
+} LibSpecialDrive_DevMatch;
+
+enum LibSpecialDrive_FilterFlags
+{
+    LIBSPECIAL_FILTER_REMOVABLE_ONLY = 1 << 0,
+    LIBSPECIAL_FILTER_EXCLUDE_READ_ONLY = 1 << 1
+};
+
+// Filtros aplicados aos candidatos antes de abrir qualquer dispositivo.
+// Listas vazias não restringem; os padrões aceitam '*' e '?' e valem para o
+// nome (ex.: "sd*") ou, se tiverem '/', para o caminho inteiro. Atributos
+// que a descoberta não conhece são conferidos após a sondagem.
+typedef struct
+{
+    const LibSpecialDrive_DevMatch *allowDevs;
+    size_t allowDevCount;
+    const LibSpecialDrive_DevMatch *denyDevs;
+    size_t denyDevCount;
+    const char *const *allowNames;
+    size_t allowNameCount;
+    const char *const *denyNames;
+    size_t denyNameCount;
+    uint64_t minSize; // bytes; 0 = sem limite
+    uint64_t maxSize; // bytes; 0 = sem limite
+    uint32_t flags;   // enum LibSpecialDrive_FilterFlags
+} LibSpecialDrive_Filter;
+
+typedef struct
+{
+    size_t maxWorkers; // 0 = LIBSPECIAL_DEFAULT_WORKERS, 1 = sondagem sequencial
+    uint32_t flags;    // enum LibSpecialDrive_OptionFlags
+    LibSpecialDrive_Filter filter;
+    uint8_t depth;               // enum LibSpecialDrive_ProbeDepth
+    uint32_t freeSpaceTtlMs;     // 0 = LIBSPECIAL_DEFAULT_FREE_SPACE_TTL_MS
+    uint32_t freeSpaceTimeoutMs; // 0 = LIBSPECIAL_DEFAULT_FREE_SPACE_TIMEOUT_MS
+    const char *cachePath;       // cache persistente da sondagem (NULL = sem cache)
+    const char *shmName;         // segmento compartilhado publicado a cada alteração (NULL = sem publicação)
+    size_t shmCapacity;          // bytes iniciais do segmento (0 = primeira imagem com folga); cresce quando preciso
+    const struct LibSpecialDrive_Backend *backend; // descoberta e E/S (NULL = dispositivos do sistema)
+} LibSpecialDrive_Options;
+
 typedef struct
 {
     LibSpecialDrive_BlockDevice *commonBlockDevices;
     size_t commonBlockDeviceCount;
     LibSpecialDrive_BlockDevice *specialBlockDevices;
     size_t specialBlockDeviceCount;
+    LibSpecialDrive_Options options;
+    LibSpecialDrive_Arena arena;        // dona de blocos, partições, caminhos e vetores
+    LibSpecialDrive_Arena optionsArena; // cópia das listas do filtro
+    LibSpecialDrive_UUIDIndex uuidIndex;
+    // Muda sempre que os vetores de blocos são refeitos ou reordenados
+    // (recarregamentos e marcações). Ponteiros para blocos e partições
+    // obtidos com outro valor não valem mais: procure de novo pelo caminho
+    // ou pelo UUID. O conteúdo dos blocos mantidos não muda.
+    uint64_t layoutGeneration;
+    // Publicação para leitores em outras threads (LibSpecialDriveSnapshotAcquire);
+    // só acessados atomicamente
+    struct LibSpecialDrive_Snapshot *snapshot;
+    volatile int64_t snapshotEpoch;
+    volatile int64_t snapshotPins[2]; // leitores fixando, por paridade da época
+    uint64_t snapshotGeneration;
+    struct LibSpecialDrive_ShmPublisher *shm; // options.shmName aberto
 } LibSpecialDrive;
 
+// Cópia imutável das listas do contexto, publicada a cada alteração. O
+// leitor a usa como um contexto somente leitura (ex.: FindByUUID sobre
+// &view) enquanto mantiver a referência; view.options vem sem as listas do
+// filtro, sem cachePath e sem shmName.
+typedef struct LibSpecialDrive_Snapshot
+{
+    LibSpecialDrive view;
+    uint64_t generation;   // cresce a cada publicação
+    volatile int64_t refs; // contexto + leitores
+} LibSpecialDrive_Snapshot;
+
+// Dispositivo candidato encontrado na descoberta, ainda não aberto
+typedef struct
+{
+    char *path;
+    int8_t flags;
+    uint64_t devId;
+    uint64_t diskSeq;
+    uint64_t size;    // tamanhos já conhecidos pela descoberta (ex.: sysfs);
+    uint32_t lbaSize; // 0 = consultar o dispositivo aberto
+    bool flagsKnown;  // removível/somente leitura já informados em flags
+    uint64_t identity; // hash do WWID/número de série (0 se indisponível)
+    const struct LibSpecialDrive_Backend *backend; // quem abre o candidato (NULL = sistema)
+    uint64_t stamp;    // mtime do nó ou da imagem em ns, por stat (0 se indisponível)
+} LibSpecialDrive_Candidate;
+
+enum LibSpecialDrive_ChangeType
+{
+    CHANGE_ADDED = 0,
+    CHANGE_REMOVED = 1,
+    CHANGE_CHANGED = 2
+};
+
+typedef struct
+{
+    enum LibSpecialDrive_ChangeType type;
+    uint64_t devId;
+    char *path;
+    bool special; // lista em que o dispositivo está (ou estava, se removido)
+} LibSpecialDrive_Change;
+
+typedef struct
+{
+    LibSpecialDrive_Change *items;
+    size_t count;
+} LibSpecialDrive_ChangeList;
+
+enum LibSpecialDrive_FlagStatus
+{
+    FLAG_STATUS_OK = 0,
+    FLAG_STATUS_INVALID = 1,     // índice ou caminho fora da lista, ou repetido no lote
+    FLAG_STATUS_OPEN_FAILED = 2, // sem permissão de escrita ou dispositivo removido
+    FLAG_STATUS_IO_FAILED = 3,   // leitura ou escrita do MBR incompleta
+    FLAG_STATUS_SYNC_FAILED = 4  // escrita feita, mas o flush falhou
+};
+
+// Resultado por dispositivo das marcações em lote, na ordem da entrada.
+// Os índices passados a LibSpecialDriveMarkBatch/UnmarkBatch referem-se à
+// lista de origem como estava antes do lote, mesmo que entradas anteriores
+// do mesmo lote tenham movido blocos; index refere-se à lista de destino
+// depois do lote. Índices repetidos valem só na primeira ocorrência.
+typedef struct
+{
+    enum LibSpecialDrive_FlagStatus status;
+    uint8_t uuid[16]; // UUID gravado na flag (marcação)
+    int index;        // posição na lista de destino após a operação (-1 se não moveu)
+} LibSpecialDrive_FlagResult;
+
+// Evento de hotplug (uevent do kernel ou sintético)
+typedef struct
+{
+    char action[16];   // "add", "remove", "change"
+    char devName[64];  // ex.: "sdb" ou "sdb1"
+    char devType[16];  // "disk" ou "partition"
+    char devPath[256]; // ex.: "/devices/.../block/sdb/sdb1"
+} LibSpecialDrive_UEvent;
+
+// Fonte de eventos plugável: netlink em produção, sintética em testes
+typedef struct
+{
+    void *user;
+    int (*getFd)(void *user);                                    // fd para poll, -1 se não houver
+    int (*next)(void *user, LibSpecialDrive_UEvent *event);      // 1 = evento, 0 = vazio, -1 = eventos perdidos
+    void (*close)(void *user);
+    const char *devDirectory; // onde ficam os discos nomeados pelos eventos (NULL = "/dev"), ex.: diretório de imagens
+} LibSpecialDrive_EventSource;
+
+typedef struct LibSpecialDrive_Watcher LibSpecialDrive_Watcher;
+
+// Publicação entre processos em memória compartilhada (LibSpecialDriveShm.c)
+typedef struct LibSpecialDrive_ShmPublisher LibSpecialDrive_ShmPublisher;
+typedef struct LibSpecialDrive_ShmReader LibSpecialDrive_ShmReader;
+
+typedef void (*LibSpecialDrive_WatchCallback)(LibSpecialDrive *ctx, const LibSpecialDrive_ChangeList *changes, void *user);
+
+// Espera máxima de uma rajada contínua, em múltiplos do debounce
+#define LIBSPECIAL_WATCH_MAX_DELAY_FACTOR 8
+
+// Saída legível por máquina, escrita sem alocação por campo
+enum LibSpecialDrive_WriterFormat
+{
+    WRITER_FORMAT_JSONL = 0, // um objeto JSON por dispositivo, uma linha cada
+    WRITER_FORMAT_BINARY = 1 // registros compactos little-endian (ver LibSpecialDriveWriter.c)
+};
+
+enum LibSpecialDrive_WriterFlags
+{
+    WRITER_FLAG_NO_PARTITIONS = 1 << 0
+};
+
+// Escritor em fluxo sobre um buffer do chamador. Com fd, o buffer é
+// descarregado nele ao encher; sem fd, o registro que não cabe é
+// descartado inteiro e a escrita falha.
+typedef struct
+{
+    uint8_t *buffer;
+    size_t capacity;
+    size_t len;
+    int fd;              // -1 = só o buffer
+    uint8_t format;      // enum LibSpecialDrive_WriterFormat
+    uint32_t flags;      // enum LibSpecialDrive_WriterFlags
+    bool headerWritten;  // cabeçalho do formato binário
+    bool failed;         // erro de escrita no fd; as escritas seguintes falham
+} LibSpecialDrive_Writer;
+
+// Tamanho de LibSpecialDriveFormatUUID, com o terminador
+#define LIBSPECIAL_UUID_STRING_SIZE 37
+
+// Buffer de leitura reaproveitado entre sondagens de uma mesma thread
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+} LibSpecialDrive_ProbeBuffer;
+
+typedef bool (*LibSpecialDrive_DiscoverCallback)(const LibSpecialDrive_Candidate *cand, void *user);
+
+// Bloco emprestado só durante a chamada (copie o que precisar guardar);
+// index conta os blocos entregues. Retornar false encerra a enumeração.
+typedef bool (*LibSpecialDrive_ForEachCallback)(const LibSpecialDrive_BlockDevice *blk, bool special, size_t index, void *user);
+typedef void (*LibSpecialDrive_TaskFn)(size_t index, size_t worker, void *user);
+
 PACKED_BEGIN
 typedef struct PACKED
 {
@@ -160,6 +437,114 @@ enum LibSpecialDrive_DeviceHandle_Flags
     DEVICE_FLAG_SILENCE = 1 << 3
 };
 
+// Backend de descoberta e E/S. Operações NULL usam as funções do sistema
+// (Funções de Sistema Dependente), então um backend cobre só o que muda.
+typedef struct LibSpecialDrive_Backend
+{
+    void *user;
+    bool (*discover)(void *user, const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *callbackUser);
+    LibSpecialDrive_DeviceHandle (*open)(void *user, const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags);
+    void (*close)(void *user, LibSpecialDrive_DeviceHandle device);
+    int64_t (*readAt)(void *user, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target);
+    int64_t (*writeAt)(void *user, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source);
+    bool (*flush)(void *user, LibSpecialDrive_DeviceHandle device);
+    bool (*lookUpSizes)(void *user, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
+    bool (*lookUpIsRemovable)(void *user, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
+    char *(*partitionPath)(void *user, const char *path, int partNumber, LibSpecialDrive_Arena *arena);
+    void (*partitionMount)(void *user, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena);
+    bool (*mountTableRefresh)(void *user); // true se as montagens mudaram
+} LibSpecialDrive_Backend;
+
+// Fases contadas por LibSpecialDriveGetStats (LibSpecialDriveStats.c)
+enum LibSpecialDrive_StatsPhase
+{
+    STATS_PHASE_DISCOVER = 0,       // descoberta dos candidatos
+    STATS_PHASE_OPEN = 1,           // abertura e fechamento do dispositivo
+    STATS_PHASE_SIZES = 2,          // tamanho e setor (BLKGETSIZE64/BLKSSZGET)
+    STATS_PHASE_REMOVABLE = 3,      // removível e somente leitura
+    STATS_PHASE_READ_MBR = 4,       // leituras a partir do LBA 0: MBR e janela da GPT
+    STATS_PHASE_READ_GPT = 5,       // demais leituras: tabela fora da janela e backup
+    STATS_PHASE_PARTITION_PATH = 6, // LibSpecialDrivePartitionPathLookup
+    STATS_PHASE_MOUNT_TABLE = 7,    // varredura da tabela de montagens
+    STATS_PHASE_MOUNTS = 8,         // ponto de montagem de cada partição
+    STATS_PHASE_FREE_SPACE = 9,     // statvfs/GetDiskFreeSpaceEx
+    STATS_PHASE_WRITE = 10,         // escrita e flush das marcações
+    STATS_PHASE_COUNT = 11
+};
+
+typedef struct
+{
+    uint64_t ns;    // somado entre threads
+    uint64_t calls;
+    uint64_t bytes; // lidos ou gravados
+} LibSpecialDrive_PhaseStats;
+
+#define LIBSPECIAL_STATS_SLOWEST 8
+#define LIBSPECIAL_STATS_PATH_SIZE 64
+
+// Dispositivo sondado, com a fase em que passou mais tempo
+typedef struct
+{
+    char path[LIBSPECIAL_STATS_PATH_SIZE]; // truncado se necessário
+    uint64_t ns;      // todas as fases da sondagem do dispositivo
+    uint64_t phaseNs; // só a fase mais lenta
+    uint8_t phase;    // enum LibSpecialDrive_StatsPhase
+} LibSpecialDrive_DeviceStats;
+
+// Contadores do processo desde o último LibSpecialDriveResetStats
+typedef struct
+{
+    LibSpecialDrive_PhaseStats phases[STATS_PHASE_COUNT];
+    uint64_t devices;                                              // dispositivos sondados
+    LibSpecialDrive_DeviceStats slowest[LIBSPECIAL_STATS_SLOWEST]; // mais lento primeiro
+    size_t slowestCount;
+} LibSpecialDrive_Stats;
+
+// Registro por dispositivo da thread que o sonda; interno
+typedef struct LibSpecialDrive_StatsDevice
+{
+    uint64_t ns[STATS_PHASE_COUNT];
+    struct LibSpecialDrive_StatsDevice *previous; // registro ativo antes deste
+} LibSpecialDrive_StatsDevice;
+
+// Instrumentação compilada só com LIBSPECIAL_STATS; sem ela as macros não
+// geram código e LibSpecialDriveGetStats retorna false
+#ifdef LIBSPECIAL_STATS
+#define LIBSPECIAL_STATS_BEGIN() LibSpecialDriveStatsBegin()
+#define LIBSPECIAL_STATS_END(phase, start, bytes) LibSpecialDriveStatsEnd(phase, start, bytes)
+#define LIBSPECIAL_STATS_DEVICE_ENTER(device) LibSpecialDriveStatsDeviceEnter(device)
+#define LIBSPECIAL_STATS_DEVICE_LEAVE(device, path) LibSpecialDriveStatsDeviceLeave(device, path)
+#else
+#define LIBSPECIAL_STATS_BEGIN() ((uint64_t)0)
+#define LIBSPECIAL_STATS_END(phase, start, bytes) ((void)(start))
+#define LIBSPECIAL_STATS_DEVICE_ENTER(device) ((void)(device))
+#define LIBSPECIAL_STATS_DEVICE_LEAVE(device, path) ((void)(device))
+#endif
+
+// Pontos de rastreamento estáticos (USDT, provider libspecialdrive) para
+// bpftrace/perf/SystemTap. Cada ponto é um nop no código até alguém se
+// anexar; os argumentos são valores já em registradores. Só no Linux com
+// <sys/sdt.h> (systemtap-sdt-dev) e sem LIBSPECIAL_NO_USDT; fora disso as
+// macros não geram código nem avaliam os argumentos.
+#if defined(__linux__) && !defined(LIBSPECIAL_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LIBSPECIAL_USDT
+#endif
+#endif
+
+#ifdef LIBSPECIAL_USDT
+#define LIBSPECIAL_TRACE1(name, a) DTRACE_PROBE1(libspecialdrive, name, a)
+#define LIBSPECIAL_TRACE2(name, a, b) DTRACE_PROBE2(libspecialdrive, name, a, b)
+#define LIBSPECIAL_TRACE3(name, a, b, c) DTRACE_PROBE3(libspecialdrive, name, a, b, c)
+#define LIBSPECIAL_TRACE4(name, a, b, c, d) DTRACE_PROBE4(libspecialdrive, name, a, b, c, d)
+#else
+#define LIBSPECIAL_TRACE1(name, a) ((void)0)
+#define LIBSPECIAL_TRACE2(name, a, b) ((void)0)
+#define LIBSPECIAL_TRACE3(name, a, b, c) ((void)0)
+#define LIBSPECIAL_TRACE4(name, a, b, c, d) ((void)0)
+#endif
+
 #define LIBSPECIAL_MAGIC_STRING "LIBSPECIALDRIVE_DEVICE"
 
 #define LIBSPECIAL_FLAG {0xFF, LIBSPECIAL_MAGIC_STRING, {0}, {0, 0, 0, 1}}
@@ -170,33 +555,134 @@ enum LibSpecialDrive_DeviceHandle_Flags
 /// Internas
 LibSpecialDrive_Flag *LibSpecialDriveIsSpecial(LibSpecialDrive_Protective_MBR *ptr);
 void LibSpecialDriveGenUUID(uint8_t *uuid);
-bool LibSpecialDriveBlockAppend(LibSpecialDrive *driver, LibSpecialDrive_BlockDevice **blockDevice);
-void LibSpecialDriveDestroyPartition(LibSpecialDrive_Partition *part);
-void LibSpecialDriveDestroyBlock(LibSpecialDrive_BlockDevice *blk);
-void LibSpecialDriveMapperPartitionsMBR(LibSpecialDrive_BlockDevice *blk);
-void LibSpecialDriveMapperPartitionsGPT(LibSpecialDrive_GPT_Header *header, uint8_t *partitionBuffer, LibSpecialDrive_BlockDevice *blk);
-LibSpecialDrive_Partition *LibSpecialDriveGetPartition(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device);
-LibSpecialDrive_BlockDevice *LibSpecialDriveGetBlock(const char *path);
+void *LibSpecialDriveArenaAlloc(LibSpecialDrive_Arena *arena, size_t size);
+void *LibSpecialDriveArenaMemdup(LibSpecialDrive_Arena *arena, const void *source, size_t size);
+char *LibSpecialDriveArenaStrdup(LibSpecialDrive_Arena *arena, const char *str);
+LibSpecialDrive_ArenaMark LibSpecialDriveArenaGetMark(const LibSpecialDrive_Arena *arena);
+void LibSpecialDriveArenaRewind(LibSpecialDrive_Arena *arena, LibSpecialDrive_ArenaMark mark);
+void LibSpecialDriveArenaSplice(LibSpecialDrive_Arena *target, LibSpecialDrive_Arena *source);
+void LibSpecialDriveArenaReset(LibSpecialDrive_Arena *arena);
+void LibSpecialDriveArenaFree(LibSpecialDrive_Arena *arena);
+LibSpecialDrive_BlockDevice *LibSpecialDriveBlockCopy(LibSpecialDrive_Arena *arena, const LibSpecialDrive_BlockDevice *blk);
+void LibSpecialDriveBlockRebind(LibSpecialDrive_BlockDevice *blk);
+bool LibSpecialDriveUUIDIndexBuild(LibSpecialDrive *ctx);
+bool LibSpecialDriveParseUUIDString(const char *str, uint8_t *uuid);
+void LibSpecialDriveMapperPartitionsMBR(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Arena *arena);
+void LibSpecialDriveMapperPartitionsGPT(LibSpecialDrive_GPT_Header *header, uint8_t *partitionBuffer, LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Arena *arena);
+uint8_t *LibSpecialDriveProbeBufferReserve(LibSpecialDrive_ProbeBuffer *buffer, size_t size);
+void LibSpecialDriveProbeBufferFree(LibSpecialDrive_ProbeBuffer *buffer);
+size_t LibSpecialDriveProbeWindowSize(const LibSpecialDrive_BlockDevice *blk);
+bool LibSpecialDriveGetPartition(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, size_t windowLen, LibSpecialDrive_Arena *arena);
+bool LibSpecialDriveParseWindow(LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, int64_t bytesRead, LibSpecialDrive_Arena *arena);
+bool LibSpecialDriveFilterAccepts(const LibSpecialDrive_Filter *filter, const LibSpecialDrive_Candidate *cand);
+bool LibSpecialDriveCandidateSizes(const LibSpecialDrive_Candidate *cand, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
+LibSpecialDrive_BlockDevice *LibSpecialDriveGetBlock(const LibSpecialDrive_Candidate *cand, enum LibSpecialDrive_ProbeDepth depth, LibSpecialDrive_ProbeBuffer *buffer, LibSpecialDrive_Arena *arena);
+bool LibSpecialDriveFingerprintMatches(const LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand, LibSpecialDrive_ProbeBuffer *buffer);
+void LibSpecialDriveParallelFor(size_t count, size_t maxWorkers, LibSpecialDrive_TaskFn fn, void *user);
+size_t LibSpecialDriveParallelWorkers(size_t count, size_t maxWorkers);
+uint64_t LibSpecialDriveNowMs(void);
+bool LibSpecialDriveContextPlace(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *const *blocks, size_t count);
+bool LibSpecialDriveSnapshotPublish(LibSpecialDrive *ctx);
+bool LibSpecialDriveCacheLoad(LibSpecialDrive *ctx, const char *path);
+uint8_t *LibSpecialDriveCacheSerialize(const LibSpecialDrive *ctx, size_t *len);
+bool LibSpecialDriveCacheParse(LibSpecialDrive *ctx, const uint8_t *data, size_t len);
+bool LibSpecialDriveContextPublish(LibSpecialDrive *ctx);
+bool LibSpecialDriveBackendDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user);
+LibSpecialDrive_DeviceHandle LibSpecialDriveBackendOpen(const LibSpecialDrive_Backend *backend, const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags);
+void LibSpecialDriveBackendClose(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device);
+int64_t LibSpecialDriveBackendReadAt(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target);
+int64_t LibSpecialDriveBackendWriteAt(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source);
+bool LibSpecialDriveBackendFlush(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device);
+bool LibSpecialDriveBackendLookUpSizes(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
+bool LibSpecialDriveBackendLookUpIsRemovable(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
+char *LibSpecialDriveBackendPartitionPath(const LibSpecialDrive_Backend *backend, const char *path, int partNumber, LibSpecialDrive_Arena *arena);
+void LibSpecialDriveBackendPartitionMount(const LibSpecialDrive_Backend *backend, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena);
+void LibSpecialDriveBackendPartitionRefreshMount(const LibSpecialDrive_Backend *backend, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena);
+bool LibSpecialDriveBackendMountTableRefresh(const LibSpecialDrive_Backend *backend);
+void LibSpecialDriveSnapshotRetire(LibSpecialDrive *ctx);
+size_t LibSpecialDriveFreeSpaceRefresh(LibSpecialDrive_Partition *const *parts, size_t count, uint64_t maxAgeMs, uint32_t timeoutMs);
+size_t LibSpecialDriveFreeSpaceRefreshBlocks(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *blk, bool force);
+size_t LibSpecialDriveFreeSpaceRefreshList(LibSpecialDrive_BlockDevice *const *blocks, size_t count, uint32_t timeoutMs);
+uint32_t LibSpecialDriveCrc32(uint32_t crc, const void *data, size_t len);
+uint32_t LibSpecialDriveCrc32Portable(uint32_t crc, const void *data, size_t len);
+uint64_t LibSpecialDriveStatsBegin(void);
+void LibSpecialDriveStatsEnd(enum LibSpecialDrive_StatsPhase phase, uint64_t start, int64_t bytes);
+void LibSpecialDriveStatsDeviceEnter(LibSpecialDrive_StatsDevice *device);
+void LibSpecialDriveStatsDeviceLeave(LibSpecialDrive_StatsDevice *device, const char *path);
 
 /// Externas
 EXPORT char *LibSpecialDriveGenUUIDString(uint8_t *uuid);
 EXPORT bool LibSpecialDriveReload(LibSpecialDrive *ctx);
+EXPORT bool LibSpecialDriveForEach(const LibSpecialDrive_Options *options, LibSpecialDrive_ForEachCallback callback, void *user);
+EXPORT bool LibSpecialDriveReloadDiff(LibSpecialDrive *ctx, LibSpecialDrive_ChangeList *changes);
+EXPORT bool LibSpecialDriveReloadDevices(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_ChangeList *changes);
+EXPORT void LibSpecialDriveChangeListClear(LibSpecialDrive_ChangeList *changes);
+EXPORT LibSpecialDrive_Watcher *LibSpecialDriveWatcherCreate(LibSpecialDrive *ctx, const LibSpecialDrive_EventSource *source, uint32_t debounceMs, LibSpecialDrive_WatchCallback callback, void *user);
+EXPORT int LibSpecialDriveWatcherGetFd(LibSpecialDrive_Watcher *watcher);
+EXPORT int LibSpecialDriveWatcherGetTimeout(LibSpecialDrive_Watcher *watcher);
+EXPORT bool LibSpecialDriveWatcherDispatch(LibSpecialDrive_Watcher *watcher, LibSpecialDrive_ChangeList *changes);
+EXPORT void LibSpecialDriveWatcherDestroy(LibSpecialDrive_Watcher **watcher);
 EXPORT void LibSpecialDriveDestroy(LibSpecialDrive **ctx);
 EXPORT bool LibSpecialDriveMark(LibSpecialDrive *ctx, int blockNumber);
 EXPORT bool LibSpecialDriveUnmark(LibSpecialDrive *ctx, int blockNumber);
+EXPORT bool LibSpecialDriveMarkEx(LibSpecialDrive *ctx, int blockNumber, int *newIndex);
+EXPORT bool LibSpecialDriveUnmarkEx(LibSpecialDrive *ctx, int blockNumber, int *newIndex);
+EXPORT bool LibSpecialDriveMarkBatch(LibSpecialDrive *ctx, const int *indices, size_t count, LibSpecialDrive_FlagResult *results);
+EXPORT bool LibSpecialDriveUnmarkBatch(LibSpecialDrive *ctx, const int *indices, size_t count, LibSpecialDrive_FlagResult *results);
+EXPORT bool LibSpecialDriveMarkPaths(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_FlagResult *results);
+EXPORT bool LibSpecialDriveUnmarkPaths(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_FlagResult *results);
+EXPORT bool LibSpecialDriveDeepen(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *blk, enum LibSpecialDrive_ProbeDepth depth);
+EXPORT uint64_t LibSpecialDriveGetFreeSpace(LibSpecialDrive *ctx, LibSpecialDrive_Partition *part);
+EXPORT size_t LibSpecialDriveRefreshFreeSpace(LibSpecialDrive *ctx, bool force);
+EXPORT char *LibSpecialDriveFormatUUID(const uint8_t *uuid, char *out);
+EXPORT void LibSpecialDriveWriterInit(LibSpecialDrive_Writer *writer, enum LibSpecialDrive_WriterFormat format, uint32_t flags, void *buffer, size_t capacity);
+EXPORT void LibSpecialDriveWriterInitFd(LibSpecialDrive_Writer *writer, enum LibSpecialDrive_WriterFormat format, uint32_t flags, int fd, void *buffer, size_t capacity);
+EXPORT bool LibSpecialDriveWriterBlock(LibSpecialDrive_Writer *writer, const LibSpecialDrive_BlockDevice *blk, bool special, size_t index);
+EXPORT bool LibSpecialDriveWriterChange(LibSpecialDrive_Writer *writer, const LibSpecialDrive_Change *change);
+EXPORT bool LibSpecialDriveWriterFreeSpace(LibSpecialDrive_Writer *writer, const LibSpecialDrive_Partition *part, uint64_t previous);
+EXPORT bool LibSpecialDriveWriterContext(LibSpecialDrive_Writer *writer, const LibSpecialDrive *ctx);
+EXPORT bool LibSpecialDriveWriterFlush(LibSpecialDrive_Writer *writer);
+EXPORT bool LibSpecialDriveCacheSave(const LibSpecialDrive *ctx, const char *path);
+EXPORT const LibSpecialDrive_Snapshot *LibSpecialDriveSnapshotAcquire(LibSpecialDrive *ctx);
+EXPORT void LibSpecialDriveSnapshotRelease(const LibSpecialDrive_Snapshot **snapshot);
+EXPORT LibSpecialDrive_Backend *LibSpecialDriveBackendImageCreate(const char *directory, uint32_t lbaSize);
+EXPORT void LibSpecialDriveBackendImageDestroy(LibSpecialDrive_Backend **backend);
+EXPORT LibSpecialDrive_ShmPublisher *LibSpecialDriveShmPublisherCreate(const char *name, size_t capacity);
+EXPORT bool LibSpecialDriveShmPublish(LibSpecialDrive_ShmPublisher *publisher, const LibSpecialDrive *ctx);
+EXPORT void LibSpecialDriveShmPublisherDestroy(LibSpecialDrive_ShmPublisher **publisher);
+EXPORT bool LibSpecialDriveShmUnlink(const char *name);
+EXPORT LibSpecialDrive_ShmReader *LibSpecialDriveShmReaderOpen(const char *name);
+EXPORT const LibSpecialDrive *LibSpecialDriveShmReaderGet(LibSpecialDrive_ShmReader *reader, uint64_t *generation);
+EXPORT void LibSpecialDriveShmReaderClose(LibSpecialDrive_ShmReader **reader);
+EXPORT bool LibSpecialDriveStatsEnable(bool enable);
+EXPORT bool LibSpecialDriveGetStats(LibSpecialDrive_Stats *stats);
+EXPORT void LibSpecialDriveResetStats(void);
+EXPORT const char *LibSpecialDriveStatsPhaseName(enum LibSpecialDrive_StatsPhase phase);
+EXPORT LibSpecialDrive_BlockDevice *LibSpecialDriveFindByUUID(const LibSpecialDrive *ctx, const uint8_t *uuid, size_t *index);
+EXPORT LibSpecialDrive_BlockDevice *LibSpecialDriveFindByUUIDString(const LibSpecialDrive *ctx, const char *uuid, size_t *index);
 EXPORT LibSpecialDrive *LibSpecialDriveGet(void);
+EXPORT LibSpecialDrive *LibSpecialDriveGetEx(const LibSpecialDrive_Options *options);
 EXPORT void LibSpecialDriveFree(void *ptr);
 
 // =====================================================================================
 // Funções de Sistema Dependente
 // =====================================================================================
-void LibSpecialDriveDiretoryFreeSpaceLookup(LibSpecialDrive_Partition *part);
-char *LibSpecialDrivePartitionPathLookup(const char *path, int partNumber);
-void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type);
+bool LibSpecialDriveDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user);
+EXPORT bool LibSpecialDriveEventSourceNetlink(LibSpecialDrive_EventSource *source);
+void LibSpecialDriveDevIdSplit(uint64_t devId, uint32_t *major, uint32_t *minor);
+bool LibSpecialDriveDiretoryFreeSpaceLookup(const char *directory, uint64_t *freeSpace);
+char *LibSpecialDrivePartitionPathLookup(const char *path, int partNumber, LibSpecialDrive_Arena *arena);
+void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena);
+void LibSpecialDrivePartitionRefreshMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena);
+EXPORT bool LibSpecialDriveMountTableRefresh(void);
+EXPORT int LibSpecialDriveMountTableGetFd(void);
 bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
 bool LibSpecialDriveLookUpIsRemovable(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk);
 LibSpecialDrive_DeviceHandle LibSpecialDriveOpenDevice(const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags);
 bool LibSpecialDriveSeek(LibSpecialDrive_DeviceHandle device, int64_t padding);
 int64_t LibSpecialDriveRead(LibSpecialDrive_DeviceHandle device, int64_t len, uint8_t *target);
+int64_t LibSpecialDriveReadAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target);
 int64_t LibSpecialDriveWrite(LibSpecialDrive_DeviceHandle device, int64_t len, const uint8_t *soruce);
+int64_t LibSpecialDriveWriteAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source);
+bool LibSpecialDriveFlush(LibSpecialDrive_DeviceHandle device);
 void LibSpecialDriveCloseDevice(LibSpecialDrive_DeviceHandle device);
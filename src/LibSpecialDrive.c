@@ -11,6 +11,17 @@ static uint8_t zeroGuid[16] = {0};
 
 // --- UUID ---
 
+static int LibSpecialDriveHexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
 void LibSpecialDriveGenUUID(uint8_t *uuid)
 {
     if (!uuid)
@@ -29,23 +40,63 @@ void LibSpecialDriveGenUUID(uint8_t *uuid)
     uuid[8] = (uuid[8] & 0x3F) | 0x80; // Variante
 }
 
+// Formata em out (LIBSPECIAL_UUID_STRING_SIZE bytes) sem alocar; retorna out
+char *LibSpecialDriveFormatUUID(const uint8_t *uuid, char *out)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    if (!uuid || !out)
+        return NULL;
+
+    char *c = out;
+    for (size_t i = 0; i < 16; i++)
+    {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            *c++ = '-';
+        *c++ = hex[uuid[i] >> 4];
+        *c++ = hex[uuid[i] & 0x0F];
+    }
+    *c = '\0';
+    return out;
+}
+
 char *LibSpecialDriveGenUUIDString(uint8_t *uuid)
 {
     if (!uuid)
         return NULL;
 
-    char *uuidStr = malloc(37);
+    char *uuidStr = malloc(LIBSPECIAL_UUID_STRING_SIZE);
     if (!uuidStr)
         return NULL;
 
-    snprintf(uuidStr, 37,
-             "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-             uuid[0], uuid[1], uuid[2], uuid[3],
-             uuid[4], uuid[5], uuid[6], uuid[7],
-             uuid[8], uuid[9], uuid[10], uuid[11],
-             uuid[12], uuid[13], uuid[14], uuid[15]);
+    return LibSpecialDriveFormatUUID(uuid, uuidStr);
+}
+
+// Aceita o formato de LibSpecialDriveGenUUIDString (8-4-4-4-12, hexadecimal
+// em qualquer caixa) sem alocar
+bool LibSpecialDriveParseUUIDString(const char *str, uint8_t *uuid)
+{
+    if (!str || !uuid)
+        return false;
+
+    size_t byte = 0;
+    for (size_t i = 0; byte < 16; i++)
+    {
+        if (i == 8 || i == 13 || i == 18 || i == 23)
+        {
+            if (str[i] != '-')
+                return false;
+            continue;
+        }
 
-    return uuidStr;
+        int hi = LibSpecialDriveHexValue(str[i]);
+        int lo = hi < 0 ? -1 : LibSpecialDriveHexValue(str[i + 1]);
+        if (lo < 0)
+            return false;
+
+        uuid[byte++] = (uint8_t)(hi << 4 | lo);
+        i++;
+    }
+    return str[36] == '\0';
 }
 
 // --- Verificação de assinatura especial ---
@@ -68,124 +119,291 @@ LibSpecialDrive_Flag *LibSpecialDriveIsSpecial(LibSpecialDrive_Protective_MBR *m
 
 // --- Manipulação de dispositivos e partições ---
 
-bool LibSpecialDriveBlockAppend(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice **blk)
+// Aponta lbaSize das partições para o bloco na sua posição definitiva
+void LibSpecialDriveBlockRebind(LibSpecialDrive_BlockDevice *blk)
 {
-    if (!ctx || !blk || !(*blk) || !(*blk)->signature)
-        return false;
+    if (!blk)
+        return;
+
+    for (int i = 0; i < blk->partitionCount; i++)
+        blk->partitions[i].lbaSize = &blk->lbaSize;
+}
+
+// Cópia profunda de um bloco para outra arena
+LibSpecialDrive_BlockDevice *LibSpecialDriveBlockCopy(LibSpecialDrive_Arena *arena, const LibSpecialDrive_BlockDevice *blk)
+{
+    if (!arena || !blk)
+        return NULL;
+
+    LibSpecialDrive_BlockDevice *copy = LibSpecialDriveArenaMemdup(arena, blk, sizeof(*blk));
+    if (!copy)
+        return NULL;
+
+    copy->path = LibSpecialDriveArenaStrdup(arena, blk->path);
+    copy->signature = LibSpecialDriveArenaMemdup(arena, blk->signature, sizeof(*blk->signature));
+    copy->partitions = blk->partitionCount > 0
+                           ? LibSpecialDriveArenaMemdup(arena, blk->partitions, (size_t)blk->partitionCount * sizeof(*blk->partitions))
+                           : NULL;
+    if ((blk->path && !copy->path) || (blk->signature && !copy->signature) || (blk->partitionCount > 0 && !copy->partitions))
+        return NULL;
+
+    for (int i = 0; i < copy->partitionCount; i++)
+    {
+        LibSpecialDrive_Partition *part = &copy->partitions[i];
+        const LibSpecialDrive_Partition *source = &blk->partitions[i];
+
+        part->path = LibSpecialDriveArenaStrdup(arena, source->path);
+        part->mountPoint = LibSpecialDriveArenaStrdup(arena, source->mountPoint);
+        if ((source->path && !part->path) || (source->mountPoint && !part->mountPoint))
+            return NULL;
+    }
+
+    LibSpecialDriveBlockRebind(copy);
+    return copy;
+}
+
+// --- Índice por UUID ---
 
-    LibSpecialDrive_Flag *flag = LibSpecialDriveIsSpecial((*blk)->signature);
-    LibSpecialDrive_BlockDevice **targetList = flag ? &ctx->specialBlockDevices : &ctx->commonBlockDevices;
-    size_t *count = flag ? &ctx->specialBlockDeviceCount : &ctx->commonBlockDeviceCount;
+static size_t LibSpecialDriveUUIDHash(const uint8_t *uuid)
+{
+    uint64_t lo, hi;
+    memcpy(&lo, uuid, 8);
+    memcpy(&hi, uuid + 8, 8);
+
+    // Mistura as duas metades: flags podem ser copiadas ou escritas por
+    // outras ferramentas, então não se conta com UUIDv4 aleatório
+    uint64_t h = (lo ^ (hi * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return (size_t)h;
+}
+
+static const uint8_t *LibSpecialDriveBlockUUID(const LibSpecialDrive_BlockDevice *blk)
+{
+    LibSpecialDrive_Flag *flag = LibSpecialDriveIsSpecial(blk->signature);
+    return flag ? flag->uuid : NULL;
+}
 
-    LibSpecialDrive_BlockDevice *newList = realloc(*targetList, (*count + 1) * sizeof(**targetList));
-    if (!newList)
+// Reconstrói o índice na arena do contexto, reaproveitando a tabela atual
+// quando ela comporta a lista. Com UUIDs repetidos (discos clonados) vale o
+// primeiro na ordem da lista.
+bool LibSpecialDriveUUIDIndexBuild(LibSpecialDrive *ctx)
+{
+    if (!ctx)
         return false;
 
-    *targetList = newList;
-    (*targetList)[*count] = *(*blk);
-    (*count)++;
+    if (ctx->specialBlockDeviceCount == 0)
+    {
+        if (ctx->uuidIndex.slots)
+            memset(ctx->uuidIndex.slots, 0, (ctx->uuidIndex.mask + 1) * sizeof(*ctx->uuidIndex.slots));
+        return true;
+    }
+
+    // Carga máxima de 50%
+    size_t capacity = 8;
+    while (capacity < ctx->specialBlockDeviceCount * 2)
+        capacity <<= 1;
+
+    uint32_t *slots = ctx->uuidIndex.slots;
+    if (slots && ctx->uuidIndex.mask + 1 >= capacity)
+    {
+        capacity = ctx->uuidIndex.mask + 1;
+        memset(slots, 0, capacity * sizeof(*slots));
+    }
+    else
+    {
+        slots = LibSpecialDriveArenaAlloc(&ctx->arena, capacity * sizeof(*slots));
+        if (!slots)
+            return false;
+    }
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < ctx->specialBlockDeviceCount; i++)
+    {
+        const uint8_t *uuid = LibSpecialDriveBlockUUID(&ctx->specialBlockDevices[i]);
+        if (!uuid)
+            continue;
+
+        size_t slot = LibSpecialDriveUUIDHash(uuid) & mask;
+        while (slots[slot] != 0 &&
+               memcmp(LibSpecialDriveBlockUUID(&ctx->specialBlockDevices[slots[slot] - 1]), uuid, 16) != 0)
+            slot = (slot + 1) & mask;
 
-    free(*blk);
-    *blk = NULL;
+        if (slots[slot] == 0)
+            slots[slot] = (uint32_t)(i + 1);
+    }
+
+    ctx->uuidIndex.slots = slots;
+    ctx->uuidIndex.mask = mask;
     return true;
 }
 
-void LibSpecialDriveDestroyPartition(LibSpecialDrive_Partition *p)
+// Busca um dispositivo especial pelo UUID da flag (16 bytes). index, se
+// informado, recebe a posição em specialBlockDevices, a usada por Unmark.
+LibSpecialDrive_BlockDevice *LibSpecialDriveFindByUUID(const LibSpecialDrive *ctx, const uint8_t *uuid, size_t *index)
 {
-    if (p)
+    if (!ctx || !uuid || !ctx->uuidIndex.slots)
+        return NULL;
+
+    size_t slot = LibSpecialDriveUUIDHash(uuid) & ctx->uuidIndex.mask;
+    for (; ctx->uuidIndex.slots[slot] != 0; slot = (slot + 1) & ctx->uuidIndex.mask)
     {
-        free((char *)p->path);
-        free((char *)p->mountPoint);
+        size_t position = ctx->uuidIndex.slots[slot] - 1;
+        LibSpecialDrive_BlockDevice *blk = &ctx->specialBlockDevices[position];
+        if (memcmp(LibSpecialDriveBlockUUID(blk), uuid, 16) == 0)
+        {
+            if (index)
+                *index = position;
+            return blk;
+        }
     }
+    return NULL;
 }
 
-void LibSpecialDriveDestroyBlock(LibSpecialDrive_BlockDevice *blk)
+LibSpecialDrive_BlockDevice *LibSpecialDriveFindByUUIDString(const LibSpecialDrive *ctx, const char *uuid, size_t *index)
 {
-    if (!blk)
-        return;
+    uint8_t bytes[16];
+    if (!LibSpecialDriveParseUUIDString(uuid, bytes))
+        return NULL;
 
-    free((char *)blk->path);
-    for (int i = 0; i < blk->partitionCount; i++)
-        LibSpecialDriveDestroyPartition(&blk->partitions[i]);
+    return LibSpecialDriveFindByUUID(ctx, bytes, index);
+}
+
+// Distribui os blocos entre as listas comum e especial na ordem dada. Os
+// blocos já devem pertencer à arena do contexto; os vetores são alocados
+// nela uma única vez, cada um com espaço para todos os blocos, para que
+// marcar e desmarcar movam blocos entre as listas sem realocar.
+bool LibSpecialDriveContextPlace(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *const *blocks, size_t count)
+{
+    size_t special = 0, common = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!blocks[i] || !blocks[i]->signature)
+            continue;
+        if (LibSpecialDriveIsSpecial(blocks[i]->signature))
+            special++;
+        else
+            common++;
+    }
+
+    size_t capacity = special + common;
+    ctx->specialBlockDevices = capacity ? LibSpecialDriveArenaAlloc(&ctx->arena, capacity * sizeof(*ctx->specialBlockDevices)) : NULL;
+    ctx->commonBlockDevices = capacity ? LibSpecialDriveArenaAlloc(&ctx->arena, capacity * sizeof(*ctx->commonBlockDevices)) : NULL;
+    ctx->specialBlockDeviceCount = 0;
+    ctx->commonBlockDeviceCount = 0;
+    if (capacity && (!ctx->specialBlockDevices || !ctx->commonBlockDevices))
+        return false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!blocks[i] || !blocks[i]->signature)
+            continue;
 
-    free(blk->signature);
-    free(blk->partitions);
+        bool isSpecial = LibSpecialDriveIsSpecial(blocks[i]->signature) != NULL;
+        LibSpecialDrive_BlockDevice *list = isSpecial ? ctx->specialBlockDevices : ctx->commonBlockDevices;
+        size_t *listCount = isSpecial ? &ctx->specialBlockDeviceCount : &ctx->commonBlockDeviceCount;
+
+        list[*listCount] = *blocks[i];
+        LibSpecialDriveBlockRebind(&list[*listCount]);
+        (*listCount)++;
+    }
+    return LibSpecialDriveUUIDIndexBuild(ctx);
+}
+
+// Montagem só quando a profundidade do bloco pede; o espaço livre fica para
+// quem o pedir (LibSpecialDriveGetFreeSpace, LibSpecialDriveRefreshFreeSpace)
+static void LibSpecialDriveMapperPartition(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Partition *part, LibSpecialDrive_Arena *arena)
+{
+    part->path = LibSpecialDriveBackendPartitionPath(blk->backend, blk->path, blk->partitionCount, arena);
+    part->lbaSize = &blk->lbaSize;
+    if (blk->depth >= PROBE_DEPTH_MOUNTS)
+        LibSpecialDriveBackendPartitionMount(blk->backend, part, blk->type, arena);
 }
 
-void LibSpecialDriveMapperPartitionsMBR(LibSpecialDrive_BlockDevice *blk)
+void LibSpecialDriveMapperPartitionsMBR(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Arena *arena)
 {
     if (!blk)
         return;
 
+    size_t used = 0;
+    for (uint32_t i = 0; i < 4; i++)
+        used += blk->signature->partitions[i].partitionType != 0x00;
+    if (used == 0)
+        return;
+
+    blk->partitions = LibSpecialDriveArenaAlloc(arena, used * sizeof(*blk->partitions));
+    if (!blk->partitions)
+        return;
+
     for (uint32_t i = 0; i < 4; i++)
     {
         LibSpecialDrive_MBR_Partition_Entry *entry = &blk->signature->partitions[i];
         if (entry->partitionType == 0x00)
             continue;
 
-        blk->partitions = realloc(blk->partitions, ((size_t)blk->partitionCount + 1) * sizeof(*blk->partitions));
-        if (!blk->partitions)
-            return;
-
         LibSpecialDrive_Partition *part = &blk->partitions[blk->partitionCount];
-        memset(part, 0, sizeof(*part));
-        part->path = LibSpecialDrivePartitionPathLookup(blk->path, blk->partitionCount);
         memcpy(&part->partitionMeta.mbr, entry, sizeof(*entry));
-        part->lbaSize = &blk->lbaSize;
-        LibSpecialDrivePartitionGetPathMount(part, blk->type);
-        LibSpecialDriveDiretoryFreeSpaceLookup(part);
+        LibSpecialDriveMapperPartition(blk, part, arena);
         blk->partitionCount++;
     }
 }
 
-void LibSpecialDriveMapperPartitionsGPT(LibSpecialDrive_GPT_Header *hdr, uint8_t *table, LibSpecialDrive_BlockDevice *blk)
+void LibSpecialDriveMapperPartitionsGPT(LibSpecialDrive_GPT_Header *hdr, uint8_t *table, LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Arena *arena)
 {
     if (!hdr || !table || !blk)
         return;
 
-    for (uint32_t i = 0; i < hdr->numPartitionEntries; i++)
+    // Conta antes para alocar o vetor de uma vez; partitionCount é int8_t
+    size_t used = 0;
+    for (uint32_t i = 0; i < hdr->numPartitionEntries && used < INT8_MAX; i++)
+    {
+        LibSpecialDrive_GPT_Partition_Entry *entry = (void *)(table + i * hdr->sizeOfPartitionEntry);
+        used += memcmp(entry->uniquePartitionGuid, zeroGuid, 16) != 0;
+    }
+    if (used == 0)
+        return;
+
+    blk->partitions = LibSpecialDriveArenaAlloc(arena, used * sizeof(*blk->partitions));
+    if (!blk->partitions)
+        return;
+
+    for (uint32_t i = 0; i < hdr->numPartitionEntries && (size_t)blk->partitionCount < used; i++)
     {
         LibSpecialDrive_GPT_Partition_Entry *entry = (void *)(table + i * hdr->sizeOfPartitionEntry);
         if (memcmp(entry->uniquePartitionGuid, zeroGuid, 16) == 0)
             continue;
 
-        blk->partitions = realloc(blk->partitions, ((size_t)blk->partitionCount + 1) * sizeof(*blk->partitions));
-        if (!blk->partitions)
-            return;
-
         LibSpecialDrive_Partition *part = &blk->partitions[blk->partitionCount];
-        memset(part, 0, sizeof(*part));
-        part->path = LibSpecialDrivePartitionPathLookup(blk->path, blk->partitionCount);
         memcpy(&part->partitionMeta.gpt, entry, sizeof(*entry));
-        part->lbaSize = &blk->lbaSize;
-        LibSpecialDrivePartitionGetPathMount(part, blk->type);
-        LibSpecialDriveDiretoryFreeSpaceLookup(part);
+        LibSpecialDriveMapperPartition(blk, part, arena);
         blk->partitionCount++;
     }
 }
 
 // --- Gerenciamento de contexto ---
 
-bool LibSpecialDriveReload(LibSpecialDrive *ctx)
+// Publica o estado atual para leitores de outras threads (instantâneo) e
+// de outros processos (segmento compartilhado, se configurado). Falha no
+// segmento não invalida o contexto, mas é relatada: os leitores dos outros
+// processos seguem com a versão anterior.
+bool LibSpecialDriveContextPublish(LibSpecialDrive *ctx)
 {
-    if (!ctx)
-        return false;
-
-    for (size_t i = 0; i < ctx->commonBlockDeviceCount; i++)
-        LibSpecialDriveDestroyBlock(&ctx->commonBlockDevices[i]);
-    free(ctx->commonBlockDevices);
-
-    for (size_t i = 0; i < ctx->specialBlockDeviceCount; i++)
-        LibSpecialDriveDestroyBlock(&ctx->specialBlockDevices[i]);
-    free(ctx->specialBlockDevices);
+    bool shared = !ctx->shm || LibSpecialDriveShmPublish(ctx->shm, ctx);
+    return LibSpecialDriveSnapshotPublish(ctx) && shared;
+}
 
-    LibSpecialDrive *newCtx = LibSpecialDriveGet();
-    if (!newCtx)
-        return false;
+// Fim de toda alteração do contexto: publica para leitores e, se o conteúdo
+// mudou em relação ao cache gravado, grava o cache persistente (quando
+// configurado). Falha ao gravar o cache não invalida o contexto.
+static bool LibSpecialDriveContextCommit(LibSpecialDrive *ctx, bool changed)
+{
+    if (changed && ctx->options.cachePath)
+        LibSpecialDriveCacheSave(ctx, ctx->options.cachePath);
+    return LibSpecialDriveContextPublish(ctx);
+}
 
-    *ctx = *newCtx;
-    free(newCtx);
-    return true;
+bool LibSpecialDriveReload(LibSpecialDrive *ctx)
+{
+    return LibSpecialDriveReloadDiff(ctx, NULL);
 }
 
 void LibSpecialDriveDestroy(LibSpecialDrive **ctx)
@@ -193,169 +411,1650 @@ void LibSpecialDriveDestroy(LibSpecialDrive **ctx)
     if (!ctx || !*ctx)
         return;
 
-    for (size_t i = 0; i < (*ctx)->commonBlockDeviceCount; i++)
-        LibSpecialDriveDestroyBlock(&(*ctx)->commonBlockDevices[i]);
-
-    for (size_t i = 0; i < (*ctx)->specialBlockDeviceCount; i++)
-        LibSpecialDriveDestroyBlock(&(*ctx)->specialBlockDevices[i]);
-
+    LibSpecialDriveSnapshotRetire(*ctx);
+    LibSpecialDriveShmPublisherDestroy(&(*ctx)->shm);
+    LibSpecialDriveArenaFree(&(*ctx)->arena);
+    LibSpecialDriveArenaFree(&(*ctx)->optionsArena);
     free(*ctx);
     *ctx = NULL;
 }
 
 // --- Acesso a blocos e partições ---
 
-LibSpecialDrive_Partition *LibSpecialDriveGetPartition(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device)
+// Garante capacidade no buffer reaproveitado entre sondagens
+uint8_t *LibSpecialDriveProbeBufferReserve(LibSpecialDrive_ProbeBuffer *buffer, size_t size)
 {
-    if (!blk || !blk->path || device == DEVICE_INVALID || !blk->signature)
+    if (!buffer)
         return NULL;
 
-    LibSpecialDrive_GPT_Header *header = malloc(512);
-    if (!header)
+    if (buffer->size < size)
+    {
+        uint8_t *data = realloc(buffer->data, size);
+        if (!data)
+            return NULL;
+        buffer->data = data;
+        buffer->size = size;
+    }
+    return buffer->data;
+}
+
+void LibSpecialDriveProbeBufferFree(LibSpecialDrive_ProbeBuffer *buffer)
+{
+    if (!buffer)
+        return;
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+}
+
+// Janela lida de uma vez: LBA 0 (MBR), LBA 1 (cabeçalho GPT) e a tabela de
+// entradas no layout padrão (LBA 2, 128 entradas de 128 bytes)
+size_t LibSpecialDriveProbeWindowSize(const LibSpecialDrive_BlockDevice *blk)
+{
+    uint64_t window = blk->depth == PROBE_DEPTH_IDENTITY
+                          ? blk->lbaSize
+                          : (uint64_t)blk->lbaSize * 2 + LIBSPECIAL_GPT_ENTRIES_BYTES;
+    if (blk->size && blk->size < window)
+        window = blk->size;
+    return (size_t)window;
+}
+
+// Valida um cabeçalho GPT lido de lba: assinatura, tamanho, posição, CRC do
+// próprio cabeçalho (com o campo crc32 zerado) e limites da tabela.
+static bool LibSpecialDriveGptHeaderValid(const LibSpecialDrive_BlockDevice *blk, const uint8_t *raw, size_t available, uint64_t lba, LibSpecialDrive_GPT_Header *header)
+{
+    if (available < sizeof(*header))
+        return false;
+
+    memcpy(header, raw, sizeof(*header));
+
+    if (memcmp(&header->signature, GPT_SIGNATURE, 8) != 0 ||
+        header->headerSize < sizeof(*header) || header->headerSize > blk->lbaSize || header->headerSize > available ||
+        header->currentLba != lba)
+        return false;
+
+    if (header->sizeOfPartitionEntry < sizeof(LibSpecialDrive_GPT_Partition_Entry) ||
+        (uint64_t)header->numPartitionEntries * header->sizeOfPartitionEntry > LIBSPECIAL_GPT_ENTRIES_MAX_BYTES)
+        return false;
+
+    uint64_t lbaCount = blk->size / blk->lbaSize;
+    if (lbaCount && header->partitionEntriesLba >= lbaCount)
+        return false;
+
+    static const uint8_t zeroCrc[4] = {0};
+    size_t crcOffset = offsetof(LibSpecialDrive_GPT_Header, crc32);
+    uint32_t crc = LibSpecialDriveCrc32(0, raw, crcOffset);
+    crc = LibSpecialDriveCrc32(crc, zeroCrc, sizeof(zeroCrc));
+    crc = LibSpecialDriveCrc32(crc, raw + crcOffset + 4, header->headerSize - crcOffset - 4);
+    return crc == header->crc32;
+}
+
+// Localiza a tabela de entradas do cabeçalho: dentro da janela quando
+// possível, senão lida em buffer->data[windowLen + scratch, ...). Retorna
+// NULL se a leitura falhar ou o CRC das entradas não conferir.
+static uint8_t *LibSpecialDriveGptTable(const LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, size_t windowLen, size_t scratch, const LibSpecialDrive_GPT_Header *header)
+{
+    if (header->partitionEntriesLba > (uint64_t)INT64_MAX / blk->lbaSize)
         return NULL;
 
-    if (!LibSpecialDriveSeek(device, blk->signature->partitions->firstLBA * blk->lbaSize) ||
-        LibSpecialDriveRead(device, 512, (uint8_t *)header) < 0)
+    uint64_t tableOffset = header->partitionEntriesLba * blk->lbaSize;
+    size_t tableSize = (size_t)header->numPartitionEntries * header->sizeOfPartitionEntry;
+    uint8_t *table;
+
+    if (tableOffset + tableSize <= windowLen)
     {
-        free(header);
-        blk->type = PARTITION_TYPE_MBR;
-        LibSpecialDriveMapperPartitionsMBR(blk);
-        return blk->partitions;
+        table = buffer->data + tableOffset;
+    }
+    else
+    {
+        if (!LibSpecialDriveProbeBufferReserve(buffer, windowLen + scratch + tableSize))
+            return NULL;
+
+        table = buffer->data + windowLen + scratch;
+        if (LibSpecialDriveBackendReadAt(blk->backend, device, (int64_t)tableOffset, (int64_t)tableSize, table) != (int64_t)tableSize)
+            return NULL;
     }
 
-    if (memcmp(&header->signature, GPT_SIGNATURE, 8) != 0)
+    return LibSpecialDriveCrc32(0, table, tableSize) == header->partitionEntriesCrc32 ? table : NULL;
+}
+
+// Interpreta MBR, cabeçalho GPT e entradas a partir da janela já lida em
+// buffer->data[0, windowLen). Só volta ao dispositivo se a tabela de
+// entradas estiver fora da janela ou se a cópia primária não passar na
+// verificação de CRC; nesse caso tenta o cabeçalho de backup. Sem cópia
+// válida o disco é mantido como GPT sem partições.
+static bool LibSpecialDriveGetPartitionTable(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, size_t windowLen, LibSpecialDrive_Arena *arena)
+{
+
+    size_t headerOffset = blk->lbaSize;
+    if (windowLen < headerOffset + sizeof(LibSpecialDrive_GPT_Header) ||
+        memcmp(buffer->data + headerOffset, GPT_SIGNATURE, 8) != 0)
     {
-        free(header);
         blk->type = PARTITION_TYPE_MBR;
-        LibSpecialDriveMapperPartitionsMBR(blk);
-        return blk->partitions;
+        LibSpecialDriveMapperPartitionsMBR(blk, arena);
+        return true;
     }
 
-    int64_t tableSize = header->numPartitionEntries * header->sizeOfPartitionEntry;
-    uint8_t *partitionTable = malloc((size_t)tableSize);
-    if (!partitionTable)
+    blk->type = PARTITION_TYPE_GPT;
+    memcpy(&blk->fingerprint.gptHeaderCrc, buffer->data + headerOffset + offsetof(LibSpecialDrive_GPT_Header, crc32), sizeof(uint32_t));
+
+    // O backup fica no último LBA; sem tamanho conhecido (ou menor que dois
+    // LBAs) não há onde procurar
+    LibSpecialDrive_GPT_Header header;
+    uint64_t lbaCount = blk->size / blk->lbaSize;
+    uint64_t backupLba = lbaCount >= 2 ? lbaCount - 1 : 0;
+
+    if (LibSpecialDriveGptHeaderValid(blk, buffer->data + headerOffset, windowLen - headerOffset, 1, &header))
     {
-        free(header);
-        return NULL;
+        uint8_t *table = LibSpecialDriveGptTable(blk, device, buffer, windowLen, 0, &header);
+        if (table)
+        {
+            LibSpecialDriveMapperPartitionsGPT(&header, table, blk, arena);
+            return true;
+        }
+
+        // Só um cabeçalho com CRC válido muda o lugar do backup, e só para
+        // dentro do disco
+        if (header.backupLba > 1 && header.backupLba <= (uint64_t)INT64_MAX / blk->lbaSize &&
+            (lbaCount == 0 || header.backupLba < lbaCount))
+            backupLba = header.backupLba;
     }
 
-    if (!LibSpecialDriveSeek(device, (int64_t)(header->partitionEntriesLba * blk->lbaSize)) ||
-        LibSpecialDriveRead(device, tableSize, partitionTable) < 0)
+    // Cópia primária rasgada ou corrompida: cabeçalho de backup, lido após
+    // a janela, e a tabela para a qual ele aponta
+    if (backupLba > 1 && LibSpecialDriveProbeBufferReserve(buffer, windowLen + blk->lbaSize) &&
+        LibSpecialDriveBackendReadAt(blk->backend, device, (int64_t)(backupLba * blk->lbaSize), blk->lbaSize, buffer->data + windowLen) == (int64_t)blk->lbaSize &&
+        LibSpecialDriveGptHeaderValid(blk, buffer->data + windowLen, blk->lbaSize, backupLba, &header))
     {
-        free(header);
-        free(partitionTable);
-        return NULL;
+        uint8_t *table = LibSpecialDriveGptTable(blk, device, buffer, windowLen, blk->lbaSize, &header);
+        if (table)
+        {
+            blk->flags |= BLOCK_FLAG_GPT_FROM_BACKUP;
+            LibSpecialDriveMapperPartitionsGPT(&header, table, blk, arena);
+            return true;
+        }
     }
 
-    blk->type = PARTITION_TYPE_GPT;
-    LibSpecialDriveMapperPartitionsGPT(header, partitionTable, blk);
-    free(header);
-    free(partitionTable);
-    return blk->partitions;
+    blk->flags |= BLOCK_FLAG_GPT_CORRUPT;
+    return true;
 }
 
-LibSpecialDrive_BlockDevice *LibSpecialDriveGetBlock(const char *path)
+// Entre parse__start e parse__done fica a interpretação da tabela, com as
+// leituras extras de GPT que ela fizer
+bool LibSpecialDriveGetPartition(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, size_t windowLen, LibSpecialDrive_Arena *arena)
 {
-    if (!path)
-        return NULL;
+    if (!blk || !blk->path || !blk->signature || !buffer || !buffer->data || !arena)
+        return false;
 
-    LibSpecialDrive_Protective_MBR *mbr = malloc(sizeof(*mbr));
-    if (!mbr)
+    LIBSPECIAL_TRACE2(parse__start, blk->path, device);
+    bool ok = LibSpecialDriveGetPartitionTable(blk, device, buffer, windowLen, arena);
+    LIBSPECIAL_TRACE4(parse__done, blk->path, (int)blk->type, (int)blk->partitionCount, (int)blk->flags);
+    return ok;
+}
+
+// Completa um bloco cujos tamanhos já foram consultados a partir da janela
+// lida do início do dispositivo. Caminhos, MBR e partições vão para a arena;
+// em caso de falha o chamador retorna a arena à marca anterior.
+bool LibSpecialDriveParseWindow(LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_ProbeBuffer *buffer, int64_t bytesRead, LibSpecialDrive_Arena *arena)
+{
+    if (!blk || !cand || !cand->path || !buffer || !arena || bytesRead < (int64_t)sizeof(LibSpecialDrive_Protective_MBR))
+        return false;
+
+    blk->path = LibSpecialDriveArenaStrdup(arena, cand->path);
+    blk->signature = LibSpecialDriveArenaMemdup(arena, buffer->data, sizeof(*blk->signature));
+    if (!blk->path || !blk->signature)
+        return false;
+
+    blk->fingerprint.size = blk->size;
+
+    // A descoberta que já leu removível e somente leitura (sysfs, IOKit,
+    // imagens) dispensa a consulta pelo dispositivo aberto
+    if (cand->flagsKnown)
+        blk->flags |= cand->flags & (BLOCK_FLAG_IS_REMOVABLE | BLOCK_FLAG_IS_READ_ONLY);
+    else
+        LibSpecialDriveBackendLookUpIsRemovable(blk->backend, device, blk);
+
+    if (blk->depth == PROBE_DEPTH_IDENTITY)
+        return true; // tabela fica para LibSpecialDriveDeepen
+
+    return LibSpecialDriveGetPartition(blk, device, buffer, (size_t)bytesRead, arena);
+}
+
+// Usa os tamanhos informados pela descoberta; o ioctl só é feito quando a
+// plataforma não os conhece sem abrir o dispositivo
+bool LibSpecialDriveCandidateSizes(const LibSpecialDrive_Candidate *cand, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
+{
+    if (!cand || !blk)
+        return false;
+
+    if (cand->lbaSize && cand->size)
+    {
+        blk->lbaSize = cand->lbaSize;
+        blk->size = cand->size;
+        return true;
+    }
+
+    return LibSpecialDriveBackendLookUpSizes(cand->backend, device, blk);
+}
+
+LibSpecialDrive_BlockDevice *LibSpecialDriveGetBlock(const LibSpecialDrive_Candidate *cand, enum LibSpecialDrive_ProbeDepth depth, LibSpecialDrive_ProbeBuffer *buffer, LibSpecialDrive_Arena *arena)
+{
+    if (!cand || !cand->path || !arena)
         return NULL;
 
-    LibSpecialDrive_DeviceHandle device = LibSpecialDriveOpenDevice(path, DEVICE_FLAG_READ | DEVICE_FLAG_SILENCE);
+    LibSpecialDrive_ProbeBuffer local = {0};
+    if (!buffer)
+        buffer = &local;
+
+    // Tudo o que for medido até o fim da sondagem conta para este dispositivo
+    LibSpecialDrive_StatsDevice stats = {{0}, NULL};
+    LIBSPECIAL_STATS_DEVICE_ENTER(&stats);
+
+    LibSpecialDrive_DeviceHandle device = LibSpecialDriveBackendOpen(cand->backend, cand->path, DEVICE_FLAG_READ | DEVICE_FLAG_SILENCE);
     if (device == DEVICE_INVALID)
     {
-        free(mbr);
+        LIBSPECIAL_STATS_DEVICE_LEAVE(&stats, cand->path);
         return NULL;
     }
 
-    if (LibSpecialDriveRead(device, sizeof(*mbr), (uint8_t *)mbr) < 0)
-        goto error_device;
-
-    LibSpecialDrive_BlockDevice *blk = calloc(1, sizeof(*blk));
+    LibSpecialDrive_ArenaMark mark = LibSpecialDriveArenaGetMark(arena);
+    LibSpecialDrive_BlockDevice *blk = LibSpecialDriveArenaAlloc(arena, sizeof(*blk));
     if (!blk)
-        goto error_device;
-
-    blk->path = strdup(path);
-    blk->signature = mbr;
+        goto error;
+    blk->backend = cand->backend;
 
-    if (!blk->path || !LibSpecialDriveLookUpSizes(device, blk))
-        goto error_blk;
+    if (!LibSpecialDriveCandidateSizes(cand, device, blk) || blk->lbaSize < sizeof(LibSpecialDrive_Protective_MBR))
+        goto error;
 
-    LibSpecialDriveLookUpIsRemovable(device, blk);
+    blk->depth = (uint8_t)depth;
+    size_t windowLen = LibSpecialDriveProbeWindowSize(blk);
+    if (!LibSpecialDriveProbeBufferReserve(buffer, windowLen))
+        goto error;
 
-    if (!LibSpecialDriveGetPartition(blk, device))
-        goto error_blk;
+    int64_t bytesRead = LibSpecialDriveBackendReadAt(cand->backend, device, 0, (int64_t)windowLen, buffer->data);
+    if (!LibSpecialDriveParseWindow(blk, cand, device, buffer, bytesRead, arena))
+        goto error;
 
-    LibSpecialDriveCloseDevice(device);
+    LibSpecialDriveBackendClose(cand->backend, device);
+    LIBSPECIAL_STATS_DEVICE_LEAVE(&stats, cand->path);
+    LibSpecialDriveProbeBufferFree(&local);
     return blk;
 
-error_blk:
-    free(blk->path);
-    free(blk);
-error_device:
-    LibSpecialDriveCloseDevice(device);
-    free(mbr);
+error:
+    LibSpecialDriveBackendClose(cand->backend, device);
+    LIBSPECIAL_STATS_DEVICE_LEAVE(&stats, cand->path);
+    LibSpecialDriveArenaRewind(arena, mark);
+    LibSpecialDriveProbeBufferFree(&local);
     return NULL;
 }
 
-// --- Marcações ---
+// --- Filtros de enumeração ---
 
-bool LibSpecialDriveMark(LibSpecialDrive *ctx, int idx)
+// Glob mínimo ('*' e '?'), igual em todas as plataformas
+static bool LibSpecialDriveGlobMatch(const char *pattern, const char *name)
 {
-    if (!ctx || idx < 0 || (size_t)idx >= ctx->commonBlockDeviceCount)
-        return false;
-
-    LibSpecialDrive_BlockDevice *blk = &ctx->commonBlockDevices[idx];
-    LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
-    LibSpecialDriveGenUUID((uint8_t *)&flag.uuid);
+    const char *star = NULL, *resume = NULL;
+    while (*name)
+    {
+        if (*pattern == '*')
+        {
+            star = pattern++;
+            resume = name;
+        }
+        else if (*pattern == '?' || *pattern == *name)
+        {
+            pattern++;
+            name++;
+        }
+        else if (star)
+        {
+            pattern = star + 1;
+            name = ++resume;
+        }
+        else
+        {
+            return false;
+        }
+    }
 
-    LibSpecialDrive_DeviceHandle device = LibSpecialDriveOpenDevice(blk->path, DEVICE_FLAG_READ | DEVICE_FLAG_WRITE);
-    if (device == DEVICE_INVALID)
-        return false;
+    while (*pattern == '*')
+        pattern++;
+    return *pattern == '\0';
+}
 
-    if (LibSpecialDriveRead(device, sizeof(*blk->signature), (uint8_t *)blk->signature) < 0)
-        goto error_device;
+static bool LibSpecialDriveFilterNameIn(const char *const *patterns, size_t count, const char *path)
+{
+    const char *name = path;
+    for (const char *c = path; *c; c++)
+    {
+        if (*c == '/' || *c == '\\')
+            name = c + 1;
+    }
 
-    if (!LibSpecialDriveSeek(device, 0))
-        goto error_device;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!patterns[i])
+            continue;
+        bool full = strchr(patterns[i], '/') || strchr(patterns[i], '\\');
+        if (LibSpecialDriveGlobMatch(patterns[i], full ? path : name))
+            return true;
+    }
+    return false;
+}
 
-    memcpy(blk->signature->boot_code, &flag, sizeof(LibSpecialDrive_Flag));
-    int64_t written = LibSpecialDriveWrite(device, sizeof(*blk->signature), (uint8_t *)blk->signature);
+static bool LibSpecialDriveFilterDevIn(const LibSpecialDrive_DevMatch *matches, size_t count, uint64_t devId)
+{
+    uint32_t major, minor;
+    LibSpecialDriveDevIdSplit(devId, &major, &minor);
 
-    return (written == sizeof(*blk->signature)) && LibSpecialDriveReload(ctx);
-error_device:
-    LibSpecialDriveCloseDevice(device);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (matches[i].major == major && (matches[i].minor == LIBSPECIAL_ANY_MINOR || matches[i].minor == minor))
+            return true;
+    }
     return false;
 }
 
-bool LibSpecialDriveUnmark(LibSpecialDrive *ctx, int idx)
+// Avalia só o que o candidato já sabe: tamanho 0 ou flags desconhecidas não
+// reprovam aqui e são conferidos de novo com o bloco sondado
+bool LibSpecialDriveFilterAccepts(const LibSpecialDrive_Filter *filter, const LibSpecialDrive_Candidate *cand)
 {
-    if (!ctx || idx < 0 || (size_t)idx >= ctx->specialBlockDeviceCount)
+    if (!filter || !cand || !cand->path)
+        return true;
+
+    if (filter->allowDevCount && !LibSpecialDriveFilterDevIn(filter->allowDevs, filter->allowDevCount, cand->devId))
+        return false;
+    if (filter->denyDevCount && LibSpecialDriveFilterDevIn(filter->denyDevs, filter->denyDevCount, cand->devId))
         return false;
 
-    LibSpecialDrive_BlockDevice *blk = &ctx->specialBlockDevices[idx];
-    if (!blk->signature)
+    if (filter->allowNameCount && !LibSpecialDriveFilterNameIn(filter->allowNames, filter->allowNameCount, cand->path))
+        return false;
+    if (filter->denyNameCount && LibSpecialDriveFilterNameIn(filter->denyNames, filter->denyNameCount, cand->path))
         return false;
 
-    LibSpecialDrive_DeviceHandle device = LibSpecialDriveOpenDevice(blk->path, DEVICE_FLAG_READ | DEVICE_FLAG_WRITE);
-    if (device == DEVICE_INVALID)
+    if (cand->size)
+    {
+        if (filter->minSize && cand->size < filter->minSize)
+            return false;
+        if (filter->maxSize && cand->size > filter->maxSize)
+            return false;
+    }
+
+    if (cand->flagsKnown)
+    {
+        if ((filter->flags & LIBSPECIAL_FILTER_REMOVABLE_ONLY) && !(cand->flags & BLOCK_FLAG_IS_REMOVABLE))
+            return false;
+        if ((filter->flags & LIBSPECIAL_FILTER_EXCLUDE_READ_ONLY) && (cand->flags & BLOCK_FLAG_IS_READ_ONLY))
+            return false;
+    }
+
+    return true;
+}
+
+// Copia as listas do filtro para a arena do contexto, para que o chamador
+// possa liberar as suas logo após LibSpecialDriveGetEx
+static bool LibSpecialDriveFilterCopy(LibSpecialDrive_Filter *filter, LibSpecialDrive_Arena *arena)
+{
+    if (filter->allowDevCount)
+    {
+        filter->allowDevs = LibSpecialDriveArenaMemdup(arena, filter->allowDevs, filter->allowDevCount * sizeof(*filter->allowDevs));
+        if (!filter->allowDevs)
+            return false;
+    }
+    if (filter->denyDevCount)
+    {
+        filter->denyDevs = LibSpecialDriveArenaMemdup(arena, filter->denyDevs, filter->denyDevCount * sizeof(*filter->denyDevs));
+        if (!filter->denyDevs)
+            return false;
+    }
+
+    const char *const **lists[] = {&filter->allowNames, &filter->denyNames};
+    size_t counts[] = {filter->allowNameCount, filter->denyNameCount};
+    for (size_t l = 0; l < 2; l++)
+    {
+        if (!counts[l])
+            continue;
+        if (!*lists[l])
+            return false;
+
+        const char **names = LibSpecialDriveArenaAlloc(arena, counts[l] * sizeof(*names));
+        if (!names)
+            return false;
+        for (size_t i = 0; i < counts[l]; i++)
+        {
+            names[i] = LibSpecialDriveArenaStrdup(arena, (*lists[l])[i]);
+            if ((*lists[l])[i] && !names[i])
+                return false;
+        }
+        *lists[l] = names;
+    }
+
+    return true;
+}
+
+// --- Enumeração ---
+
+typedef struct
+{
+    LibSpecialDrive_Candidate *items;
+    size_t count;
+    size_t capacity;
+    LibSpecialDrive_Arena strings; // caminhos dos candidatos
+    const LibSpecialDrive_Filter *filter;
+    enum LibSpecialDrive_ProbeDepth depth;
+    const LibSpecialDrive_Backend *backend; // atribuído a cada candidato
+} LibSpecialDrive_CandidateList;
+
+// Estado próprio de cada worker: buffer de leitura e arena onde os blocos
+// sondados são alocados sem disputa entre threads
+typedef struct
+{
+    LibSpecialDrive_ProbeBuffer buffer;
+    LibSpecialDrive_Arena arena;
+} LibSpecialDrive_ProbeWorker;
+
+typedef struct
+{
+    LibSpecialDrive_CandidateList *list;
+    LibSpecialDrive_BlockDevice **results;
+    LibSpecialDrive_ProbeWorker *workers;
+} LibSpecialDrive_ProbeJob;
+
+static bool LibSpecialDriveCandidateCollect(const LibSpecialDrive_Candidate *cand, void *user)
+{
+    LibSpecialDrive_CandidateList *list = user;
+
+    if (!LibSpecialDriveFilterAccepts(list->filter, cand))
+        return true; // descartado sem abrir o dispositivo
+
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        LibSpecialDrive_Candidate *items = realloc(list->items, capacity * sizeof(*items));
+        if (!items)
+            return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    LibSpecialDrive_Candidate *item = &list->items[list->count];
+    *item = *cand;
+    item->path = LibSpecialDriveArenaStrdup(&list->strings, cand->path);
+    item->backend = list->backend;
+    if (!item->path)
         return false;
 
-    if (LibSpecialDriveRead(device, sizeof(*blk->signature), (uint8_t *)blk->signature) < 0)
-        goto error_device;
+    list->count++;
+    return true;
+}
 
-    if (!LibSpecialDriveSeek(device, 0))
-        goto error_device;
+static void LibSpecialDriveCandidateListClear(LibSpecialDrive_CandidateList *list)
+{
+    free(list->items);
+    LibSpecialDriveArenaFree(&list->strings);
+    memset(list, 0, sizeof(*list));
+}
 
-    memset(blk->signature->boot_code, 0, sizeof(LibSpecialDrive_Flag));
-    int64_t written = LibSpecialDriveWrite(device, sizeof(*blk->signature), (uint8_t *)blk->signature);
-    LibSpecialDriveCloseDevice(device);
-    return (written == sizeof(*blk->signature)) && LibSpecialDriveReload(ctx);
-error_device:
-    LibSpecialDriveCloseDevice(device);
-    return false;
+// Completa o bloco com o que veio da descoberta e repete o filtro agora que
+// tamanho e flags são conhecidos. O bloco recusado fica na arena até ela
+// ser liberada.
+static LibSpecialDrive_BlockDevice *LibSpecialDriveApplyCandidate(LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand, const LibSpecialDrive_Filter *filter)
+{
+    if (!blk)
+        return NULL;
+
+    blk->flags |= cand->flags;
+    blk->devId = cand->devId;
+    blk->fingerprint.diskSeq = cand->diskSeq;
+
+    blk->fingerprint.identity = cand->identity;
+    blk->fingerprint.stamp = cand->stamp;
+
+    blk->backend = cand->backend;
+
+    LibSpecialDrive_Candidate probed = {blk->path, blk->flags, blk->devId, cand->diskSeq, blk->size, blk->lbaSize, true, cand->identity, cand->backend, cand->stamp};
+    return LibSpecialDriveFilterAccepts(filter, &probed) ? blk : NULL;
+}
+
+static LibSpecialDrive_BlockDevice *LibSpecialDriveProbeCandidate(const LibSpecialDrive_CandidateList *list, size_t index, LibSpecialDrive_ProbeWorker *worker)
+{
+    const LibSpecialDrive_Candidate *cand = &list->items[index];
+    return LibSpecialDriveApplyCandidate(LibSpecialDriveGetBlock(cand, list->depth, &worker->buffer, &worker->arena), cand, list->filter);
+}
+
+static void LibSpecialDriveProbeTask(size_t index, size_t worker, void *user)
+{
+    LibSpecialDrive_ProbeJob *job = user;
+
+    job->results[index] = LibSpecialDriveProbeCandidate(job->list, index, &job->workers[worker]);
+}
+
+static LibSpecialDrive_ProbeWorker *LibSpecialDriveProbeWorkersCreate(size_t count, size_t maxWorkers)
+{
+    return calloc(LibSpecialDriveParallelWorkers(count, maxWorkers), sizeof(LibSpecialDrive_ProbeWorker));
+}
+
+// Libera os buffers e entrega as arenas dos workers ao contexto
+static void LibSpecialDriveProbeWorkersFinish(LibSpecialDrive_ProbeWorker *workers, size_t count, size_t maxWorkers, LibSpecialDrive_Arena *target)
+{
+    if (!workers)
+        return;
+
+    size_t total = LibSpecialDriveParallelWorkers(count, maxWorkers);
+    for (size_t i = 0; i < total; i++)
+    {
+        LibSpecialDriveProbeBufferFree(&workers[i].buffer);
+        if (target)
+            LibSpecialDriveArenaSplice(target, &workers[i].arena);
+        LibSpecialDriveArenaFree(&workers[i].arena);
+    }
+    free(workers);
+}
+
+static bool LibSpecialDriveReloadSet(LibSpecialDrive *ctx, const char *const *paths, size_t pathCount, bool fromCache, LibSpecialDrive_ChangeList *changes);
+
+LibSpecialDrive *LibSpecialDriveGetEx(const LibSpecialDrive_Options *options)
+{
+    LibSpecialDrive *ctx = calloc(1, sizeof(LibSpecialDrive));
+    if (!ctx)
+        return NULL;
+
+    if (options)
+        ctx->options = *options;
+    if (ctx->options.maxWorkers == 0)
+        ctx->options.maxWorkers = LIBSPECIAL_DEFAULT_WORKERS;
+    if (ctx->options.depth == PROBE_DEPTH_DEFAULT || ctx->options.depth > PROBE_DEPTH_FULL)
+        ctx->options.depth = PROBE_DEPTH_FULL;
+    if (ctx->options.freeSpaceTtlMs == 0)
+        ctx->options.freeSpaceTtlMs = LIBSPECIAL_DEFAULT_FREE_SPACE_TTL_MS;
+    if (ctx->options.freeSpaceTimeoutMs == 0)
+        ctx->options.freeSpaceTimeoutMs = LIBSPECIAL_DEFAULT_FREE_SPACE_TIMEOUT_MS;
+
+    if (!LibSpecialDriveFilterCopy(&ctx->options.filter, &ctx->optionsArena))
+    {
+        LibSpecialDriveDestroy(&ctx);
+        return NULL;
+    }
+
+    // Outro processo já publicando no segmento: este não deve sondar
+    if (ctx->options.shmName)
+    {
+        ctx->options.shmName = LibSpecialDriveArenaStrdup(&ctx->optionsArena, ctx->options.shmName);
+        ctx->shm = ctx->options.shmName ? LibSpecialDriveShmPublisherCreate(ctx->options.shmName, ctx->options.shmCapacity) : NULL;
+        if (!ctx->shm)
+        {
+            LibSpecialDriveDestroy(&ctx);
+            return NULL;
+        }
+    }
+
+    if (ctx->options.cachePath)
+    {
+        ctx->options.cachePath = LibSpecialDriveArenaStrdup(&ctx->optionsArena, ctx->options.cachePath);
+        if (!ctx->options.cachePath)
+        {
+            LibSpecialDriveDestroy(&ctx);
+            return NULL;
+        }
+
+        // Cache válido vira o contexto anterior de um recarregamento
+        // incremental: só dispositivos que não batem mais são sondados; os
+        // demais custam uma leitura dos dois primeiros LBAs e ficam onde o
+        // cache os deixou. Sem mudanças, o cache não é regravado.
+        if (LibSpecialDriveCacheLoad(ctx, ctx->options.cachePath))
+        {
+            if (!LibSpecialDriveReloadSet(ctx, NULL, 0, true, NULL))
+                LibSpecialDriveDestroy(&ctx);
+            return ctx;
+        }
+    }
+
+    LibSpecialDrive_CandidateList list = {0};
+    list.filter = &ctx->options.filter;
+    list.depth = (enum LibSpecialDrive_ProbeDepth)ctx->options.depth;
+    list.backend = ctx->options.backend;
+    if (!LibSpecialDriveBackendDiscover(&ctx->options, LibSpecialDriveCandidateCollect, &list))
+    {
+        LibSpecialDriveCandidateListClear(&list);
+        LibSpecialDriveDestroy(&ctx);
+        return NULL;
+    }
+
+    // Índice de montagens montado uma vez e compartilhado pelas sondagens
+    if (ctx->options.depth >= PROBE_DEPTH_MOUNTS)
+        LibSpecialDriveBackendMountTableRefresh(ctx->options.backend);
+
+    LibSpecialDrive_ProbeJob job = {
+        &list,
+        calloc(list.count ? list.count : 1, sizeof(*job.results)),
+        LibSpecialDriveProbeWorkersCreate(list.count, ctx->options.maxWorkers)};
+    if (!job.results || !job.workers)
+    {
+        free(job.results);
+        free(job.workers);
+        LibSpecialDriveCandidateListClear(&list);
+        LibSpecialDriveDestroy(&ctx);
+        return NULL;
+    }
+
+    // Pool de threads com leituras síncronas, limitado por maxWorkers
+    LibSpecialDriveParallelFor(list.count, ctx->options.maxWorkers, LibSpecialDriveProbeTask, &job);
+    LibSpecialDriveProbeWorkersFinish(job.workers, list.count, ctx->options.maxWorkers, &ctx->arena);
+
+    // A junção segue a ordem da descoberta, independente da ordem de conclusão
+    bool placed = LibSpecialDriveContextPlace(ctx, job.results, list.count);
+
+    free(job.results);
+    LibSpecialDriveCandidateListClear(&list);
+
+    if (placed)
+        placed = LibSpecialDriveContextCommit(ctx, true);
+    if (!placed)
+        LibSpecialDriveDestroy(&ctx);
+    return ctx;
+}
+
+LibSpecialDrive *LibSpecialDriveGet(void)
+{
+    return LibSpecialDriveGetEx(NULL);
+}
+
+// --- Enumeração em fluxo ---
+
+// A descoberta enche uma janela de até LIBSPECIAL_FOREACH_WINDOW candidatos;
+// a janela cheia é sondada em paralelo como no LibSpecialDriveGetEx, os
+// blocos são entregues na ordem da descoberta e as arenas voltam ao início.
+// Nada cresce com o número de dispositivos.
+typedef struct
+{
+    const LibSpecialDrive_Options *options;
+    LibSpecialDrive_ForEachCallback callback;
+    void *user;
+    LibSpecialDrive_CandidateList list; // a janela atual
+    LibSpecialDrive_BlockDevice *results[LIBSPECIAL_FOREACH_WINDOW];
+    LibSpecialDrive_ProbeWorker *workers;
+    size_t maxWorkers;
+    size_t delivered;
+    bool stopped; // o callback pediu para parar
+} LibSpecialDrive_ForEachJob;
+
+static void LibSpecialDriveForEachProbe(LibSpecialDrive_ForEachJob *job)
+{
+    LibSpecialDrive_CandidateList *list = &job->list;
+    LibSpecialDrive_ProbeJob probe = {list, job->results, job->workers};
+
+    LibSpecialDriveParallelFor(list->count, job->maxWorkers, LibSpecialDriveProbeTask, &probe);
+
+    if (list->depth >= PROBE_DEPTH_FULL)
+        LibSpecialDriveFreeSpaceRefreshList(job->results, list->count, job->options->freeSpaceTimeoutMs ? job->options->freeSpaceTimeoutMs : LIBSPECIAL_DEFAULT_FREE_SPACE_TIMEOUT_MS);
+}
+
+// Sonda e entrega a janela, depois a esvazia mantendo a memória reservada
+static bool LibSpecialDriveForEachFlush(LibSpecialDrive_ForEachJob *job)
+{
+    LibSpecialDrive_CandidateList *list = &job->list;
+    if (list->count == 0)
+        return true;
+
+    LibSpecialDriveForEachProbe(job);
+
+    for (size_t i = 0; i < list->count && !job->stopped; i++)
+    {
+        LibSpecialDrive_BlockDevice *blk = job->results[i];
+        if (blk && blk->signature)
+            job->stopped = !job->callback(blk, LibSpecialDriveIsSpecial(blk->signature) != NULL, job->delivered++, job->user);
+    }
+
+    size_t workers = LibSpecialDriveParallelWorkers(LIBSPECIAL_FOREACH_WINDOW, job->maxWorkers);
+    for (size_t i = 0; i < workers; i++)
+        LibSpecialDriveArenaReset(&job->workers[i].arena);
+    LibSpecialDriveArenaReset(&list->strings);
+    memset(job->results, 0, sizeof(job->results));
+    list->count = 0;
+    return !job->stopped;
+}
+
+static bool LibSpecialDriveForEachCollect(const LibSpecialDrive_Candidate *cand, void *user)
+{
+    LibSpecialDrive_ForEachJob *job = user;
+
+    if (job->list.count == LIBSPECIAL_FOREACH_WINDOW && !LibSpecialDriveForEachFlush(job))
+        return false;
+    return LibSpecialDriveCandidateCollect(cand, &job->list);
+}
+
+// Enumera os dispositivos com as opções de LibSpecialDriveGetEx (cache e
+// publicação são ignorados) sem montar um contexto: cada bloco sondado é
+// entregue ao callback assim que sua janela termina. O callback pode parar
+// a enumeração retornando false. Retorna false só em caso de erro.
+bool LibSpecialDriveForEach(const LibSpecialDrive_Options *options, LibSpecialDrive_ForEachCallback callback, void *user)
+{
+    if (!callback)
+        return false;
+
+    LibSpecialDrive_Options local = {0};
+    if (options)
+        local = *options;
+    if (local.maxWorkers == 0)
+        local.maxWorkers = LIBSPECIAL_DEFAULT_WORKERS;
+    if (local.depth == PROBE_DEPTH_DEFAULT || local.depth > PROBE_DEPTH_FULL)
+        local.depth = PROBE_DEPTH_FULL;
+
+    LibSpecialDrive_ForEachJob job;
+    memset(&job, 0, sizeof(job));
+    job.options = &local;
+    job.callback = callback;
+    job.user = user;
+    job.maxWorkers = local.maxWorkers;
+    job.list.filter = &local.filter;
+    job.list.depth = (enum LibSpecialDrive_ProbeDepth)local.depth;
+    job.list.backend = local.backend;
+    job.workers = LibSpecialDriveProbeWorkersCreate(LIBSPECIAL_FOREACH_WINDOW, local.maxWorkers);
+    if (!job.workers)
+        return false;
+
+    if (local.depth >= PROBE_DEPTH_MOUNTS)
+        LibSpecialDriveBackendMountTableRefresh(local.backend);
+
+    // Parada pedida pelo callback também interrompe a descoberta
+    bool ok = LibSpecialDriveBackendDiscover(&local, LibSpecialDriveForEachCollect, &job) || job.stopped;
+    if (ok && !job.stopped)
+        LibSpecialDriveForEachFlush(&job);
+
+    LibSpecialDriveProbeWorkersFinish(job.workers, LIBSPECIAL_FOREACH_WINDOW, local.maxWorkers, NULL);
+    LibSpecialDriveCandidateListClear(&job.list);
+    return ok;
+}
+
+// --- Aprofundamento da sondagem ---
+
+// Relê a tabela de partições de um bloco sondado só com identidade. O MBR
+// precisa ser o mesmo da sondagem; senão o contexto deve ser recarregado.
+static bool LibSpecialDriveDeepenTable(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *blk, enum LibSpecialDrive_ProbeDepth depth)
+{
+    LibSpecialDrive_DeviceHandle device = LibSpecialDriveBackendOpen(blk->backend, blk->path, DEVICE_FLAG_READ | DEVICE_FLAG_SILENCE);
+    if (device == DEVICE_INVALID)
+        return false;
+
+    LibSpecialDrive_ProbeBuffer buffer = {0};
+    LibSpecialDrive_ArenaMark mark = LibSpecialDriveArenaGetMark(&ctx->arena);
+    uint8_t previousDepth = blk->depth;
+    int8_t previousFlags = blk->flags;
+    bool ok = false;
+
+    blk->depth = (uint8_t)depth;
+    size_t windowLen = LibSpecialDriveProbeWindowSize(blk);
+    if (!LibSpecialDriveProbeBufferReserve(&buffer, windowLen))
+        goto done;
+
+    int64_t bytesRead = LibSpecialDriveBackendReadAt(blk->backend, device, 0, (int64_t)windowLen, buffer.data);
+    if (bytesRead < (int64_t)sizeof(*blk->signature) || memcmp(buffer.data, blk->signature, sizeof(*blk->signature)) != 0)
+        goto done;
+
+    ok = LibSpecialDriveGetPartition(blk, device, &buffer, (size_t)bytesRead, &ctx->arena);
+
+done:
+    if (!ok)
+    {
+        blk->depth = previousDepth;
+        blk->flags = previousFlags;
+        blk->type = PARTITION_TYPE_UNKNOWN;
+        blk->partitions = NULL;
+        blk->partitionCount = 0;
+        LibSpecialDriveArenaRewind(&ctx->arena, mark);
+    }
+    LibSpecialDriveProbeBufferFree(&buffer);
+    LibSpecialDriveBackendClose(blk->backend, device);
+    return ok;
+}
+
+// Completa um bloco do contexto até depth, fazendo apenas o que falta:
+// tabela de partições e montagens; o espaço livre continua sob demanda.
+// A memória nova vai para a arena do contexto. Uma falha só na publicação
+// para outros processos é relatada com o bloco já aprofundado.
+bool LibSpecialDriveDeepen(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *blk, enum LibSpecialDrive_ProbeDepth depth)
+{
+    if (!ctx || !blk || !blk->path || !blk->signature || depth > PROBE_DEPTH_FULL)
+        return false;
+
+    if (depth == PROBE_DEPTH_DEFAULT)
+        depth = PROBE_DEPTH_FULL;
+    if (blk->depth >= depth)
+        return true;
+
+    // Montagens resolvidas contra a tabela atual, não a da última enumeração
+    if (blk->depth < PROBE_DEPTH_MOUNTS && depth >= PROBE_DEPTH_MOUNTS)
+        LibSpecialDriveBackendMountTableRefresh(blk->backend);
+
+    // Sem tabela ainda: o mapeamento já faz as montagens
+    if (blk->depth < PROBE_DEPTH_PARTITIONS)
+    {
+        if (!LibSpecialDriveDeepenTable(ctx, blk, depth))
+            return false;
+    }
+    else if (blk->depth < PROBE_DEPTH_MOUNTS && depth >= PROBE_DEPTH_MOUNTS)
+    {
+        for (int i = 0; i < blk->partitionCount; i++)
+            LibSpecialDriveBackendPartitionMount(blk->backend, &blk->partitions[i], blk->type, &ctx->arena);
+    }
+
+    blk->depth = (uint8_t)depth;
+    return LibSpecialDriveContextCommit(ctx, true);
+}
+
+// --- Recarregamento incremental ---
+
+// Pré-filtro do início pelo cache: o stat da descoberta já diz que o nó foi
+// escrito depois da última sondagem, então a leitura da impressão digital é
+// dispensada e o dispositivo vai direto para a sondagem. O mtime igual não
+// prova nada (escritas por outro nó do mesmo disco não o mudam), por isso
+// nesse caso os LBAs 0 e 1 ainda são conferidos.
+static bool LibSpecialDriveFingerprintStampMoved(const LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand)
+{
+    return cand->stamp && blk->fingerprint.stamp && cand->stamp != blk->fingerprint.stamp;
+}
+
+// Compara a impressão digital guardada com o estado atual do dispositivo
+// lendo apenas os dois primeiros LBAs, sem mapear partições.
+bool LibSpecialDriveFingerprintMatches(const LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Candidate *cand, LibSpecialDrive_ProbeBuffer *buffer)
+{
+    if (!blk || !cand || !buffer || !blk->signature || blk->lbaSize == 0)
+        return false;
+
+    if (cand->diskSeq != blk->fingerprint.diskSeq || cand->identity != blk->fingerprint.identity)
+        return false;
+
+    // Tamanho conhecido pela descoberta: a troca de mídia é detectada sem abrir
+    if (cand->lbaSize && cand->size && (cand->size != blk->fingerprint.size || cand->lbaSize != blk->lbaSize))
+        return false;
+
+    LibSpecialDrive_DeviceHandle device = LibSpecialDriveBackendOpen(cand->backend, cand->path, DEVICE_FLAG_READ | DEVICE_FLAG_SILENCE);
+    if (device == DEVICE_INVALID)
+        return false;
+
+    LibSpecialDrive_BlockDevice current = {0};
+    bool match = false;
+
+    if (!LibSpecialDriveCandidateSizes(cand, device, &current) ||
+        current.size != blk->fingerprint.size || current.lbaSize != blk->lbaSize)
+        goto done;
+
+    // Blocos só com identidade não guardaram o cabeçalho GPT: basta o LBA 0
+    bool identity = blk->depth == PROBE_DEPTH_IDENTITY;
+    int64_t len = (int64_t)current.lbaSize * (identity ? 1 : 2);
+    uint8_t *data = LibSpecialDriveProbeBufferReserve(buffer, (size_t)len);
+    if (!data || LibSpecialDriveBackendReadAt(cand->backend, device, 0, len, data) != len)
+        goto done;
+
+    if (memcmp(data, blk->signature, sizeof(*blk->signature)) != 0)
+        goto done;
+
+    if (identity)
+    {
+        match = true;
+        goto done;
+    }
+
+    LibSpecialDrive_GPT_Header header;
+    memcpy(&header, data + current.lbaSize, sizeof(header));
+    uint32_t headerCrc = memcmp(&header.signature, GPT_SIGNATURE, 8) == 0 ? header.crc32 : 0;
+    match = headerCrc == blk->fingerprint.gptHeaderCrc;
+
+done:
+    LibSpecialDriveBackendClose(cand->backend, device);
+    return match;
+}
+
+enum LibSpecialDrive_ReloadAction
+{
+    RELOAD_SKIP = 0,  // fora do conjunto afetado
+    RELOAD_CHECK = 1, // sonda só se a impressão digital mudou
+    RELOAD_PROBE = 2  // sonda sempre
+};
+
+typedef struct
+{
+    LibSpecialDrive_CandidateList *list;
+    LibSpecialDrive_BlockDevice **previous; // bloco atual para cada candidato (ou NULL)
+    LibSpecialDrive_BlockDevice **results;  // novo bloco sondado (ou NULL)
+    uint8_t *action;                        // enum LibSpecialDrive_ReloadAction
+    bool *keep;                             // bloco atual mantido sem nova sondagem
+    LibSpecialDrive_ProbeWorker *workers;   // um por worker
+    bool stampFilter;                       // início pelo cache: mtime mudado sonda direto
+} LibSpecialDrive_ReloadJob;
+
+static void LibSpecialDriveReloadTask(size_t index, size_t worker, void *user)
+{
+    LibSpecialDrive_ReloadJob *job = user;
+    LibSpecialDrive_Candidate *cand = &job->list->items[index];
+    LibSpecialDrive_BlockDevice *prev = job->previous[index];
+
+    switch (job->action[index])
+    {
+    case RELOAD_SKIP:
+        job->keep[index] = prev != NULL;
+        return;
+    case RELOAD_CHECK:
+        // Bloco raso (ex.: vindo do cache) não atende uma sondagem mais funda
+        if (prev && prev->depth >= job->list->depth &&
+            !(job->stampFilter && LibSpecialDriveFingerprintStampMoved(prev, cand)) &&
+            LibSpecialDriveFingerprintMatches(prev, cand, &job->workers[worker].buffer))
+        {
+            job->keep[index] = true;
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    job->results[index] = LibSpecialDriveProbeCandidate(job->list, index, &job->workers[worker]);
+}
+
+// Blocos do contexto por devId e por caminho, com endereçamento aberto e
+// carga máxima de 50%. Montado uma vez por recarregamento: cada candidato
+// acha o bloco anterior sem percorrer a lista inteira.
+typedef struct
+{
+    uint32_t *byDev;  // posição + 1 dos blocos com devId; 0 = vazio
+    uint32_t *byPath; // posição + 1 de todos os blocos
+    size_t mask;
+} LibSpecialDrive_BlockIndex;
+
+static size_t LibSpecialDriveDevHash(uint64_t devId)
+{
+    uint64_t h = devId * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 32;
+    return (size_t)h;
+}
+
+// FNV-1a
+static size_t LibSpecialDrivePathHash(const char *path)
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const char *c = path; *c; c++)
+        h = (h ^ (uint8_t)*c) * 0x100000001B3ull;
+    return (size_t)(h ^ (h >> 32));
+}
+
+static LibSpecialDrive_BlockDevice *LibSpecialDriveContextBlock(LibSpecialDrive *ctx, size_t i)
+{
+    return i < ctx->commonBlockDeviceCount ? &ctx->commonBlockDevices[i]
+                                           : &ctx->specialBlockDevices[i - ctx->commonBlockDeviceCount];
+}
+
+static bool LibSpecialDriveBlockIndexBuild(LibSpecialDrive_BlockIndex *index, LibSpecialDrive *ctx)
+{
+    size_t total = ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount;
+    size_t capacity = 8;
+    while (capacity < total * 2)
+        capacity <<= 1;
+
+    index->mask = capacity - 1;
+    index->byDev = calloc(capacity, sizeof(*index->byDev));
+    index->byPath = calloc(capacity, sizeof(*index->byPath));
+    if (!index->byDev || !index->byPath)
+        return false;
+
+    // Na ordem da lista: entre blocos com a mesma chave, a sondagem linear
+    // encontra primeiro o que vem antes, como a busca sequencial
+    for (size_t i = 0; i < total; i++)
+    {
+        const LibSpecialDrive_BlockDevice *blk = LibSpecialDriveContextBlock(ctx, i);
+        size_t slot;
+        if (blk->devId)
+        {
+            for (slot = LibSpecialDriveDevHash(blk->devId) & index->mask; index->byDev[slot]; slot = (slot + 1) & index->mask)
+                ;
+            index->byDev[slot] = (uint32_t)(i + 1);
+        }
+        for (slot = LibSpecialDrivePathHash(blk->path) & index->mask; index->byPath[slot]; slot = (slot + 1) & index->mask)
+            ;
+        index->byPath[slot] = (uint32_t)(i + 1);
+    }
+    return true;
+}
+
+static void LibSpecialDriveBlockIndexFree(LibSpecialDrive_BlockIndex *index)
+{
+    free(index->byDev);
+    free(index->byPath);
+}
+
+// Mesmo dispositivo: pelo devId quando os dois lados o têm, senão pelo
+// caminho. Cada bloco anterior é reivindicado por um único candidato.
+static LibSpecialDrive_BlockDevice *LibSpecialDriveFindCandidate(LibSpecialDrive *ctx, const LibSpecialDrive_BlockIndex *index, const LibSpecialDrive_Candidate *cand, bool *claimed)
+{
+    if (cand->devId)
+    {
+        for (size_t slot = LibSpecialDriveDevHash(cand->devId) & index->mask; index->byDev[slot]; slot = (slot + 1) & index->mask)
+        {
+            size_t i = index->byDev[slot] - 1;
+            LibSpecialDrive_BlockDevice *blk = LibSpecialDriveContextBlock(ctx, i);
+            if (!claimed[i] && blk->devId == cand->devId)
+            {
+                claimed[i] = true;
+                return blk;
+            }
+        }
+    }
+
+    for (size_t slot = LibSpecialDrivePathHash(cand->path) & index->mask; index->byPath[slot]; slot = (slot + 1) & index->mask)
+    {
+        size_t i = index->byPath[slot] - 1;
+        LibSpecialDrive_BlockDevice *blk = LibSpecialDriveContextBlock(ctx, i);
+        if (!claimed[i] && (!cand->devId || !blk->devId) && strcmp(cand->path, blk->path) == 0)
+        {
+            claimed[i] = true;
+            return blk;
+        }
+    }
+    return NULL;
+}
+
+static bool LibSpecialDriveChangeListPush(LibSpecialDrive_ChangeList *changes, enum LibSpecialDrive_ChangeType type, const LibSpecialDrive_BlockDevice *blk)
+{
+    if (!changes)
+        return true;
+
+    LibSpecialDrive_Change *items = realloc(changes->items, (changes->count + 1) * sizeof(*items));
+    if (!items)
+        return false;
+    changes->items = items;
+
+    LibSpecialDrive_Change *change = &items[changes->count];
+    change->type = type;
+    change->devId = blk->devId;
+    change->path = strdup(blk->path);
+    change->special = LibSpecialDriveIsSpecial(blk->signature) != NULL;
+    if (!change->path)
+        return false;
+
+    changes->count++;
+    return true;
+}
+
+void LibSpecialDriveChangeListClear(LibSpecialDrive_ChangeList *changes)
+{
+    if (!changes)
+        return;
+
+    for (size_t i = 0; i < changes->count; i++)
+        free(changes->items[i].path);
+    free(changes->items);
+    changes->items = NULL;
+    changes->count = 0;
+}
+
+static bool LibSpecialDrivePathInSet(const char *path, const char *const *paths, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (paths[i] && strcmp(paths[i], path) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Desfaz as mudanças registradas a partir de base
+static void LibSpecialDriveChangeListTruncate(LibSpecialDrive_ChangeList *changes, size_t base)
+{
+    if (!changes)
+        return;
+
+    for (size_t i = base; i < changes->count; i++)
+        free(changes->items[i].path);
+    changes->count = base;
+}
+
+// Núcleo comum do recarregamento. Sem conjunto de caminhos, todos os
+// candidatos passam pela impressão digital; com conjunto, apenas os
+// caminhos indicados são sondados de novo e o resto fica intocado.
+// O resultado é montado numa arena nova: blocos mantidos são copiados para
+// ela, a arena anterior é liberada de uma vez no fim e layoutGeneration
+// avança. Qualquer falha, inclusive ao registrar as mudanças, deixa o
+// contexto e changes como estavam; a exceção é a falha só na publicação
+// para outros processos, relatada com o contexto e changes já atualizados.
+//
+// fromCache é o início pelo cache, com o contexto ainda não publicado: os
+// blocos cujo mtime mudou são sondados sem conferir a impressão digital
+// (ver LibSpecialDriveFingerprintStampMoved) e os mantidos são adotados
+// onde a interpretação do cache os deixou, sem cópia; a arena nova junta-se
+// à do contexto. Uma falha aqui deixa o contexto só para ser destruído.
+static bool LibSpecialDriveReloadSet(LibSpecialDrive *ctx, const char *const *paths, size_t pathCount, bool fromCache, LibSpecialDrive_ChangeList *changes)
+{
+    if (!ctx)
+        return false;
+
+    LibSpecialDrive_CandidateList list = {0};
+    list.filter = &ctx->options.filter;
+    list.depth = (enum LibSpecialDrive_ProbeDepth)ctx->options.depth;
+    list.backend = ctx->options.backend;
+    if (!LibSpecialDriveBackendDiscover(&ctx->options, LibSpecialDriveCandidateCollect, &list))
+    {
+        LibSpecialDriveCandidateListClear(&list);
+        return false;
+    }
+
+    bool mountsChanged = LibSpecialDriveBackendMountTableRefresh(ctx->options.backend);
+
+    size_t total = ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount;
+    size_t slots = list.count ? list.count : 1;
+    LibSpecialDrive_ReloadJob job = {
+        &list,
+        calloc(slots, sizeof(*job.previous)),
+        calloc(slots, sizeof(*job.results)),
+        calloc(slots, sizeof(*job.action)),
+        calloc(slots, sizeof(*job.keep)),
+        LibSpecialDriveProbeWorkersCreate(list.count, ctx->options.maxWorkers),
+        fromCache};
+    bool *claimed = calloc(total ? total : 1, sizeof(*claimed));
+    LibSpecialDrive_BlockDevice **placed = calloc(list.count + total + 1, sizeof(*placed));
+    LibSpecialDrive_BlockIndex index = {0};
+
+    if (!job.previous || !job.results || !job.action || !job.keep || !job.workers || !claimed || !placed ||
+        !LibSpecialDriveBlockIndexBuild(&index, ctx))
+    {
+        free(job.previous);
+        free(job.results);
+        free(job.action);
+        free(job.keep);
+        free(job.workers);
+        free(claimed);
+        free(placed);
+        LibSpecialDriveBlockIndexFree(&index);
+        LibSpecialDriveCandidateListClear(&list);
+        return false;
+    }
+
+    for (size_t i = 0; i < list.count; i++)
+    {
+        job.previous[i] = LibSpecialDriveFindCandidate(ctx, &index, &list.items[i], claimed);
+        if (!paths)
+            job.action[i] = RELOAD_CHECK;
+        else if (LibSpecialDrivePathInSet(list.items[i].path, paths, pathCount) ||
+                 (job.previous[i] && LibSpecialDrivePathInSet(job.previous[i]->path, paths, pathCount)))
+            job.action[i] = RELOAD_PROBE;
+        else
+            job.action[i] = RELOAD_SKIP;
+    }
+
+    LibSpecialDriveBlockIndexFree(&index);
+    LibSpecialDriveParallelFor(list.count, ctx->options.maxWorkers, LibSpecialDriveReloadTask, &job);
+
+    LibSpecialDrive next = {0};
+    LibSpecialDriveProbeWorkersFinish(job.workers, list.count, ctx->options.maxWorkers, &next.arena);
+
+    size_t placedCount = 0;
+    size_t changesBase = changes ? changes->count : 0;
+    bool changed = false; // algo a gravar no cache, mesmo sem lista de mudanças
+    bool ok = true;
+
+    for (size_t i = 0; ok && i < list.count; i++)
+    {
+        LibSpecialDrive_BlockDevice *prev = job.previous[i];
+
+        if (job.keep[i])
+        {
+            LibSpecialDrive_BlockDevice *kept = fromCache ? prev : LibSpecialDriveBlockCopy(&next.arena, prev);
+            if (!kept)
+            {
+                ok = false;
+                continue;
+            }
+
+            if (job.action[i] == RELOAD_CHECK)
+            {
+                // Conferido agora: o stat desta descoberta passa a valer
+                changed |= kept->fingerprint.stamp != list.items[i].stamp;
+                kept->fingerprint.stamp = list.items[i].stamp;
+
+                // Espaço livre em cache vale só para o mesmo ponto de montagem
+                for (int p = 0; mountsChanged && kept->depth >= PROBE_DEPTH_MOUNTS && p < kept->partitionCount; p++)
+                {
+                    LibSpecialDriveBackendPartitionRefreshMount(kept->backend, &kept->partitions[p], kept->type, &next.arena);
+                    kept->partitions[p].freeSpaceMs = 0;
+                    changed = true;
+                }
+            }
+
+            placed[placedCount++] = kept;
+            continue;
+        }
+
+        LibSpecialDrive_BlockDevice *blk = job.results[i];
+        if (prev)
+            ok = LibSpecialDriveChangeListPush(changes, blk ? CHANGE_CHANGED : CHANGE_REMOVED, blk ? blk : prev);
+        else if (blk)
+            ok = LibSpecialDriveChangeListPush(changes, CHANGE_ADDED, blk);
+        changed |= prev || blk;
+
+        if (blk)
+            placed[placedCount++] = blk;
+    }
+
+    // Blocos ausentes da descoberta foram removidos, exceto os que estão fora
+    // do conjunto pedido, que são mantidos até serem consultados
+    for (size_t i = 0; ok && i < total; i++)
+    {
+        if (claimed[i])
+            continue;
+
+        LibSpecialDrive_BlockDevice *blk = LibSpecialDriveContextBlock(ctx, i);
+        if (paths && !LibSpecialDrivePathInSet(blk->path, paths, pathCount))
+        {
+            LibSpecialDrive_BlockDevice *kept = fromCache ? blk : LibSpecialDriveBlockCopy(&next.arena, blk);
+            if (kept)
+                placed[placedCount++] = kept;
+            else
+                ok = false;
+            continue;
+        }
+
+        ok = LibSpecialDriveChangeListPush(changes, CHANGE_REMOVED, blk);
+        changed = true;
+    }
+
+    ok = ok && LibSpecialDriveContextPlace(&next, placed, placedCount);
+    if (ok)
+    {
+        // Campo a campo: a publicação do instantâneo é lida por outras threads
+        if (fromCache)
+        {
+            LibSpecialDriveArenaSplice(&ctx->arena, &next.arena);
+        }
+        else
+        {
+            LibSpecialDriveArenaFree(&ctx->arena);
+            ctx->arena = next.arena;
+        }
+        ctx->commonBlockDevices = next.commonBlockDevices;
+        ctx->commonBlockDeviceCount = next.commonBlockDeviceCount;
+        ctx->specialBlockDevices = next.specialBlockDevices;
+        ctx->specialBlockDeviceCount = next.specialBlockDeviceCount;
+        ctx->uuidIndex = next.uuidIndex;
+        ctx->layoutGeneration++;
+        ok = LibSpecialDriveContextCommit(ctx, changed);
+    }
+    else
+    {
+        // Sem memória: o contexto anterior continua válido
+        LibSpecialDriveChangeListTruncate(changes, changesBase);
+        LibSpecialDriveArenaFree(&next.arena);
+    }
+
+    free(job.previous);
+    free(job.results);
+    free(job.action);
+    free(job.keep);
+    free(claimed);
+    free(placed);
+    LibSpecialDriveCandidateListClear(&list);
+    return ok;
+}
+
+// Recarrega o contexto sondando de novo apenas dispositivos novos ou cuja
+// impressão digital mudou. Os demais blocos são mantidos com o mesmo
+// conteúdo, mas em outro endereço (ver layoutGeneration).
+bool LibSpecialDriveReloadDiff(LibSpecialDrive *ctx, LibSpecialDrive_ChangeList *changes)
+{
+    return LibSpecialDriveReloadSet(ctx, NULL, 0, false, changes);
+}
+
+// Sonda de novo somente os dispositivos indicados (novos, alterados ou
+// removidos); os outros blocos do contexto não são tocados.
+bool LibSpecialDriveReloadDevices(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_ChangeList *changes)
+{
+    if (!paths)
+        return false;
+    if (count == 0)
+        return ctx != NULL;
+
+    return LibSpecialDriveReloadSet(ctx, paths, count, false, changes);
+}
+
+// --- Marcações ---
+
+typedef struct
+{
+    LibSpecialDrive_BlockDevice **blocks; // NULL = entrada inválida
+    LibSpecialDrive_FlagResult *results;
+    LibSpecialDrive_Protective_MBR *mbrs; // MBR gravado em cada dispositivo
+    bool *stale;                          // disco mudou desde a sondagem
+    bool mark;
+} LibSpecialDrive_FlagJob;
+
+// Lê o MBR atual (não o da sondagem, que pode estar velho), troca apenas a
+// região da flag e grava o setor de volta com um único flush. stale indica
+// que o restante do MBR já não é o que o contexto conhece.
+static enum LibSpecialDrive_FlagStatus LibSpecialDriveFlagWrite(const LibSpecialDrive_BlockDevice *blk, bool mark, const uint8_t *uuid, LibSpecialDrive_Protective_MBR *mbr, bool *stale)
+{
+    LIBSPECIAL_TRACE2(mark__start, blk->path, (int)mark);
+    LibSpecialDrive_DeviceHandle device = LibSpecialDriveBackendOpen(blk->backend, blk->path, DEVICE_FLAG_READ | DEVICE_FLAG_WRITE);
+    if (device == DEVICE_INVALID)
+    {
+        LIBSPECIAL_TRACE3(mark__done, blk->path, (int)mark, (int)FLAG_STATUS_OPEN_FAILED);
+        return FLAG_STATUS_OPEN_FAILED;
+    }
+
+    enum LibSpecialDrive_FlagStatus status = FLAG_STATUS_IO_FAILED;
+
+    if (LibSpecialDriveBackendReadAt(blk->backend, device, 0, sizeof(*mbr), (uint8_t *)mbr) != (int64_t)sizeof(*mbr))
+        goto done;
+
+    size_t flagSize = sizeof(LibSpecialDrive_Flag);
+    *stale = memcmp((const uint8_t *)mbr + flagSize, (const uint8_t *)blk->signature + flagSize, sizeof(*mbr) - flagSize) != 0;
+
+    if (mark)
+    {
+        LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
+        memcpy(flag.uuid, uuid, sizeof(flag.uuid));
+        memcpy(mbr->boot_code, &flag, flagSize);
+    }
+    else
+    {
+        memset(mbr->boot_code, 0, flagSize);
+    }
+
+    if (LibSpecialDriveBackendWriteAt(blk->backend, device, 0, sizeof(*mbr), (const uint8_t *)mbr) != (int64_t)sizeof(*mbr))
+        goto done;
+
+    status = LibSpecialDriveBackendFlush(blk->backend, device) ? FLAG_STATUS_OK : FLAG_STATUS_SYNC_FAILED;
+
+done:
+    LibSpecialDriveBackendClose(blk->backend, device);
+    LIBSPECIAL_TRACE3(mark__done, blk->path, (int)mark, (int)status);
+    return status;
+}
+
+static void LibSpecialDriveFlagTask(size_t index, size_t worker, void *user)
+{
+    (void)worker;
+    LibSpecialDrive_FlagJob *job = user;
+
+    if (job->blocks[index])
+        job->results[index].status = LibSpecialDriveFlagWrite(job->blocks[index], job->mark, job->results[index].uuid, &job->mbrs[index], &job->stale[index]);
+}
+
+// Move os blocos gravados da lista de origem para o fim da de destino,
+// mantendo a ordem dos demais. Os vetores do contexto têm espaço para todos
+// os blocos, então nada é realocado.
+static void LibSpecialDriveFlagApply(LibSpecialDrive *ctx, LibSpecialDrive_FlagJob *job, size_t count, bool *moved)
+{
+    LibSpecialDrive_BlockDevice *source = job->mark ? ctx->commonBlockDevices : ctx->specialBlockDevices;
+    size_t *sourceCount = job->mark ? &ctx->commonBlockDeviceCount : &ctx->specialBlockDeviceCount;
+    LibSpecialDrive_BlockDevice *target = job->mark ? ctx->specialBlockDevices : ctx->commonBlockDevices;
+    size_t *targetCount = job->mark ? &ctx->specialBlockDeviceCount : &ctx->commonBlockDeviceCount;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        LibSpecialDrive_BlockDevice *blk = job->blocks[i];
+        if (!blk || job->stale[i] || job->results[i].status != FLAG_STATUS_OK)
+            continue;
+
+        memcpy(blk->signature, &job->mbrs[i], sizeof(*blk->signature));
+        moved[blk - source] = true;
+        ctx->layoutGeneration++;
+
+        job->results[i].index = (int)*targetCount;
+        target[*targetCount] = *blk;
+        LibSpecialDriveBlockRebind(&target[*targetCount]);
+        (*targetCount)++;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < *sourceCount; i++)
+    {
+        if (moved[i])
+            continue;
+        if (kept != i)
+        {
+            source[kept] = source[i];
+            LibSpecialDriveBlockRebind(&source[kept]);
+        }
+        kept++;
+    }
+    *sourceCount = kept;
+}
+
+// Todos os resultados começam inválidos, para que nenhuma falha antes da
+// gravação deixe o chamador lendo lixo
+static void LibSpecialDriveFlagResultsInit(LibSpecialDrive_FlagResult *results, size_t count)
+{
+    for (size_t i = 0; results && i < count; i++)
+    {
+        memset(&results[i], 0, sizeof(results[i]));
+        results[i].status = FLAG_STATUS_INVALID;
+        results[i].index = -1;
+    }
+}
+
+// Núcleo das marcações: grava as flags de todos os blocos em paralelo e
+// atualiza o contexto no lugar, movendo cada bloco gravado para a outra
+// lista. Índices de blocos não envolvidos na lista de destino continuam
+// válidos. Dispositivos cujo MBR mudou desde a sondagem são sondados de novo
+// numa única atualização incremental. blocks[i] NULL indica entrada
+// inválida. Os blocos são resolvidos antes de qualquer movimento, então as
+// entradas do lote referem-se todas às listas de antes dele. Retorna true se
+// todos foram gravados e o contexto atualizado.
+static bool LibSpecialDriveFlagBatch(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice **blocks, size_t count, bool mark, LibSpecialDrive_FlagResult *results)
+{
+    if (count == 0)
+        return true;
+
+    size_t listCount = mark ? ctx->commonBlockDeviceCount : ctx->specialBlockDeviceCount;
+    LibSpecialDrive_FlagResult *local = results ? NULL : calloc(count, sizeof(*local));
+    LibSpecialDrive_FlagJob job = {
+        blocks,
+        results ? results : local,
+        calloc(count, sizeof(*job.mbrs)),
+        calloc(count, sizeof(*job.stale)),
+        mark};
+    bool *moved = calloc(listCount ? listCount : 1, sizeof(*moved));
+    const char **paths = calloc(count, sizeof(*paths));       // cópia dos caminhos gravados
+    const char **stalePaths = calloc(count, sizeof(*stalePaths));
+    LibSpecialDrive_Arena scratch = {0};
+
+    bool ok = job.results && job.mbrs && job.stale && moved && paths && stalePaths;
+    if (!ok)
+        goto cleanup;
+
+    LibSpecialDriveFlagResultsInit(job.results, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        // O mesmo bloco duas vezes no lote conta só na primeira
+        for (size_t j = 0; blocks[i] && j < i; j++)
+        {
+            if (blocks[j] == blocks[i])
+                blocks[i] = NULL;
+        }
+
+        // rand() não é seguro entre threads: UUIDs gerados antes do pool
+        if (mark && blocks[i])
+            LibSpecialDriveGenUUID(job.results[i].uuid);
+    }
+
+    LibSpecialDriveParallelFor(count, ctx->options.maxWorkers, LibSpecialDriveFlagTask, &job);
+
+    size_t staleCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        enum LibSpecialDrive_FlagStatus status = job.results[i].status;
+        bool written = status == FLAG_STATUS_OK || status == FLAG_STATUS_SYNC_FAILED;
+        ok = ok && status == FLAG_STATUS_OK;
+        if (!written)
+            continue;
+
+        // Cópia fora do contexto: o recarregamento substitui a arena
+        paths[i] = LibSpecialDriveArenaStrdup(&scratch, blocks[i]->path);
+        if (!paths[i])
+        {
+            ok = false;
+            continue;
+        }
+
+        // Escrita sem flush confirmado ou disco alterado: a sondagem decide
+        if (job.stale[i] || status == FLAG_STATUS_SYNC_FAILED)
+        {
+            job.stale[i] = true;
+            stalePaths[staleCount++] = paths[i];
+        }
+    }
+
+    LibSpecialDriveFlagApply(ctx, &job, count, moved);
+    if (!LibSpecialDriveUUIDIndexBuild(ctx))
+        ok = false;
+
+    // O recarregamento remonta as listas na ordem da descoberta: as posições
+    // são procuradas de novo pelo caminho
+    if (staleCount > 0)
+    {
+        if (!LibSpecialDriveReloadDevices(ctx, stalePaths, staleCount, NULL))
+        {
+            LibSpecialDriveContextCommit(ctx, true);
+            ok = false;
+        }
+
+        LibSpecialDrive_BlockDevice *target = mark ? ctx->specialBlockDevices : ctx->commonBlockDevices;
+        size_t targetCount = mark ? ctx->specialBlockDeviceCount : ctx->commonBlockDeviceCount;
+        for (size_t i = 0; i < count; i++)
+        {
+            job.results[i].index = -1;
+            for (size_t t = 0; paths[i] && t < targetCount; t++)
+            {
+                if (strcmp(target[t].path, paths[i]) == 0)
+                    job.results[i].index = (int)t;
+            }
+        }
+    }
+    else if (!LibSpecialDriveContextCommit(ctx, true))
+    {
+        ok = false;
+    }
+
+cleanup:
+    free(local);
+    free(job.mbrs);
+    free(job.stale);
+    free(moved);
+    free(paths);
+    free(stalePaths);
+    LibSpecialDriveArenaFree(&scratch);
+    return ok;
+}
+
+static LibSpecialDrive_BlockDevice **LibSpecialDriveFlagBlocksByIndex(LibSpecialDrive_BlockDevice *list, size_t listCount, const int *indices, size_t count)
+{
+    LibSpecialDrive_BlockDevice **blocks = calloc(count ? count : 1, sizeof(*blocks));
+    if (!blocks)
+        return NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (indices[i] >= 0 && (size_t)indices[i] < listCount)
+            blocks[i] = &list[indices[i]];
+    }
+    return blocks;
+}
+
+static LibSpecialDrive_BlockDevice **LibSpecialDriveFlagBlocksByPath(LibSpecialDrive_BlockDevice *list, size_t listCount, const char *const *paths, size_t count)
+{
+    LibSpecialDrive_BlockDevice **blocks = calloc(count ? count : 1, sizeof(*blocks));
+    if (!blocks)
+        return NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; paths[i] && j < listCount; j++)
+        {
+            if (strcmp(list[j].path, paths[i]) == 0)
+            {
+                blocks[i] = &list[j];
+                break;
+            }
+        }
+    }
+    return blocks;
+}
+
+static bool LibSpecialDriveFlagRun(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice **blocks, size_t count, bool mark, LibSpecialDrive_FlagResult *results)
+{
+    if (!blocks)
+        return false;
+
+    bool ok = LibSpecialDriveFlagBatch(ctx, blocks, count, mark, results);
+    free(blocks);
+    return ok;
+}
+
+// Marca como especiais os blocos comuns indicados por índice
+bool LibSpecialDriveMarkBatch(LibSpecialDrive *ctx, const int *indices, size_t count, LibSpecialDrive_FlagResult *results)
+{
+    LibSpecialDriveFlagResultsInit(results, count);
+    if (!ctx || !indices)
+        return false;
+
+    return LibSpecialDriveFlagRun(ctx, LibSpecialDriveFlagBlocksByIndex(ctx->commonBlockDevices, ctx->commonBlockDeviceCount, indices, count), count, true, results);
+}
+
+// Remove a flag dos blocos especiais indicados por índice
+bool LibSpecialDriveUnmarkBatch(LibSpecialDrive *ctx, const int *indices, size_t count, LibSpecialDrive_FlagResult *results)
+{
+    LibSpecialDriveFlagResultsInit(results, count);
+    if (!ctx || !indices)
+        return false;
+
+    return LibSpecialDriveFlagRun(ctx, LibSpecialDriveFlagBlocksByIndex(ctx->specialBlockDevices, ctx->specialBlockDeviceCount, indices, count), count, false, results);
+}
+
+bool LibSpecialDriveMarkPaths(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_FlagResult *results)
+{
+    LibSpecialDriveFlagResultsInit(results, count);
+    if (!ctx || !paths)
+        return false;
+
+    return LibSpecialDriveFlagRun(ctx, LibSpecialDriveFlagBlocksByPath(ctx->commonBlockDevices, ctx->commonBlockDeviceCount, paths, count), count, true, results);
+}
+
+bool LibSpecialDriveUnmarkPaths(LibSpecialDrive *ctx, const char *const *paths, size_t count, LibSpecialDrive_FlagResult *results)
+{
+    LibSpecialDriveFlagResultsInit(results, count);
+    if (!ctx || !paths)
+        return false;
+
+    return LibSpecialDriveFlagRun(ctx, LibSpecialDriveFlagBlocksByPath(ctx->specialBlockDevices, ctx->specialBlockDeviceCount, paths, count), count, false, results);
+}
+
+// Marca o bloco comum idx como especial. newIndex, se informado, recebe a
+// posição do bloco em specialBlockDevices (-1 em caso de falha).
+bool LibSpecialDriveMarkEx(LibSpecialDrive *ctx, int idx, int *newIndex)
+{
+    LibSpecialDrive_FlagResult result = {FLAG_STATUS_INVALID, {0}, -1};
+    bool ok = LibSpecialDriveMarkBatch(ctx, &idx, 1, &result);
+    if (newIndex)
+        *newIndex = result.index;
+    return ok;
+}
+
+// Remove a flag do bloco especial idx. newIndex recebe a posição do bloco
+// em commonBlockDevices (-1 em caso de falha).
+bool LibSpecialDriveUnmarkEx(LibSpecialDrive *ctx, int idx, int *newIndex)
+{
+    LibSpecialDrive_FlagResult result = {FLAG_STATUS_INVALID, {0}, -1};
+    bool ok = LibSpecialDriveUnmarkBatch(ctx, &idx, 1, &result);
+    if (newIndex)
+        *newIndex = result.index;
+    return ok;
+}
+
+bool LibSpecialDriveMark(LibSpecialDrive *ctx, int idx)
+{
+    return LibSpecialDriveMarkEx(ctx, idx, NULL);
+}
+
+bool LibSpecialDriveUnmark(LibSpecialDrive *ctx, int idx)
+{
+    return LibSpecialDriveUnmarkEx(ctx, idx, NULL);
 }
 
 void LibSpecialDriveFree(void *ptr)
@@ -0,0 +1,159 @@
+#include <LibSpecialDrive.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Arena de alocação ---
+
+struct LibSpecialDrive_ArenaChunk
+{
+    LibSpecialDrive_ArenaChunk *next; // bloco mais antigo
+    size_t size;                      // bytes úteis após o cabeçalho
+    size_t used;
+};
+
+#define LIBSPECIAL_ARENA_ALIGN 16
+#define LIBSPECIAL_ARENA_ROUND(n) (((n) + LIBSPECIAL_ARENA_ALIGN - 1) & ~(size_t)(LIBSPECIAL_ARENA_ALIGN - 1))
+#define LIBSPECIAL_ARENA_HEADER LIBSPECIAL_ARENA_ROUND(sizeof(LibSpecialDrive_ArenaChunk))
+
+static uint8_t *LibSpecialDriveArenaData(LibSpecialDrive_ArenaChunk *chunk)
+{
+    return (uint8_t *)chunk + LIBSPECIAL_ARENA_HEADER;
+}
+
+// Reserva size bytes zerados. Os blocos dobram de tamanho até
+// LIBSPECIAL_ARENA_CHUNK_MAX, então o número de malloc cresce com o
+// logaritmo do volume e não com o número de objetos.
+void *LibSpecialDriveArenaAlloc(LibSpecialDrive_Arena *arena, size_t size)
+{
+    if (!arena || size > SIZE_MAX - LIBSPECIAL_ARENA_HEADER - LIBSPECIAL_ARENA_ALIGN)
+        return NULL;
+
+    size_t need = LIBSPECIAL_ARENA_ROUND(size);
+    LibSpecialDrive_ArenaChunk *chunk = arena->head;
+
+    if (!chunk || chunk->size - chunk->used < need)
+    {
+        size_t chunkSize = arena->chunkSize ? arena->chunkSize : LIBSPECIAL_ARENA_CHUNK_MIN;
+        if (chunkSize < need)
+            chunkSize = need;
+
+        chunk = malloc(LIBSPECIAL_ARENA_HEADER + chunkSize);
+        if (!chunk)
+            return NULL;
+
+        chunk->next = arena->head;
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        arena->head = chunk;
+
+        arena->chunkSize = chunkSize < LIBSPECIAL_ARENA_CHUNK_MAX / 2 ? chunkSize * 2 : LIBSPECIAL_ARENA_CHUNK_MAX;
+    }
+
+    void *ptr = LibSpecialDriveArenaData(chunk) + chunk->used;
+    chunk->used += need;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void *LibSpecialDriveArenaMemdup(LibSpecialDrive_Arena *arena, const void *source, size_t size)
+{
+    if (!source)
+        return NULL;
+
+    void *ptr = LibSpecialDriveArenaAlloc(arena, size);
+    if (ptr)
+        memcpy(ptr, source, size);
+    return ptr;
+}
+
+char *LibSpecialDriveArenaStrdup(LibSpecialDrive_Arena *arena, const char *str)
+{
+    if (!str)
+        return NULL;
+    return LibSpecialDriveArenaMemdup(arena, str, strlen(str) + 1);
+}
+
+LibSpecialDrive_ArenaMark LibSpecialDriveArenaGetMark(const LibSpecialDrive_Arena *arena)
+{
+    LibSpecialDrive_ArenaMark mark = {NULL, 0};
+    if (arena && arena->head)
+    {
+        mark.chunk = arena->head;
+        mark.used = arena->head->used;
+    }
+    return mark;
+}
+
+// Descarta tudo o que foi alocado depois da marca. Não pode haver
+// LibSpecialDriveArenaSplice entre a marca e o retorno.
+void LibSpecialDriveArenaRewind(LibSpecialDrive_Arena *arena, LibSpecialDrive_ArenaMark mark)
+{
+    if (!arena)
+        return;
+
+    while (arena->head && arena->head != mark.chunk)
+    {
+        LibSpecialDrive_ArenaChunk *chunk = arena->head;
+        arena->head = chunk->next;
+        free(chunk);
+    }
+
+    if (arena->head)
+        arena->head->used = mark.used;
+}
+
+// Transfere os blocos de source para target, que passa a ser o dono da
+// memória; source fica vazia. O bloco atual de target continua recebendo
+// as próximas alocações.
+void LibSpecialDriveArenaSplice(LibSpecialDrive_Arena *target, LibSpecialDrive_Arena *source)
+{
+    if (!target || !source || !source->head)
+        return;
+
+    if (!target->head)
+    {
+        target->head = source->head;
+    }
+    else
+    {
+        LibSpecialDrive_ArenaChunk *tail = source->head;
+        while (tail->next)
+            tail = tail->next;
+
+        tail->next = target->head->next;
+        target->head->next = source->head;
+    }
+
+    source->head = NULL;
+    source->chunkSize = 0;
+}
+
+// Descarta todas as alocações mas guarda o bloco mais recente, que é o
+// maior, para quem reaproveita a arena em ciclos sem voltar ao malloc
+void LibSpecialDriveArenaReset(LibSpecialDrive_Arena *arena)
+{
+    if (!arena || !arena->head)
+        return;
+
+    while (arena->head->next)
+    {
+        LibSpecialDrive_ArenaChunk *chunk = arena->head->next;
+        arena->head->next = chunk->next;
+        free(chunk);
+    }
+    arena->head->used = 0;
+}
+
+void LibSpecialDriveArenaFree(LibSpecialDrive_Arena *arena)
+{
+    if (!arena)
+        return;
+
+    while (arena->head)
+    {
+        LibSpecialDrive_ArenaChunk *chunk = arena->head;
+        arena->head = chunk->next;
+        free(chunk);
+    }
+    arena->chunkSize = 0;
+}
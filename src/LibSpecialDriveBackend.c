@@ -0,0 +1,152 @@
+#include <LibSpecialDrive.h>
+
+// --- Despacho para o backend ---
+
+// Toda descoberta e E/S de dispositivo da biblioteca passa por aqui. Sem
+// backend, ou sem a operação no backend, vale a implementação do sistema.
+// Cada chamada é medida na sua fase (LibSpecialDriveStats.c) e marcada com
+// pontos USDT de início e fim; o descritor de open__done identifica o
+// dispositivo nos pontos de leitura e escrita seguintes.
+
+bool LibSpecialDriveBackendDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user)
+{
+    const LibSpecialDrive_Backend *backend = options ? options->backend : NULL;
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool ok = backend && backend->discover
+                  ? backend->discover(backend->user, options, callback, user)
+                  : LibSpecialDriveDiscover(options, callback, user);
+    LIBSPECIAL_STATS_END(STATS_PHASE_DISCOVER, start, 0);
+    return ok;
+}
+
+LibSpecialDrive_DeviceHandle LibSpecialDriveBackendOpen(const LibSpecialDrive_Backend *backend, const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags)
+{
+    LIBSPECIAL_TRACE2(open__start, path, (int)flags);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    LibSpecialDrive_DeviceHandle device = backend && backend->open
+                                              ? backend->open(backend->user, path, flags)
+                                              : LibSpecialDriveOpenDevice(path, flags);
+    LIBSPECIAL_STATS_END(STATS_PHASE_OPEN, start, 0);
+    LIBSPECIAL_TRACE2(open__done, path, device);
+    return device;
+}
+
+void LibSpecialDriveBackendClose(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device)
+{
+    LIBSPECIAL_TRACE1(close, device);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    if (backend && backend->close)
+        backend->close(backend->user, device);
+    else
+        LibSpecialDriveCloseDevice(device);
+    LIBSPECIAL_STATS_END(STATS_PHASE_OPEN, start, 0);
+}
+
+// Leituras do LBA 0 trazem o MBR e a janela da GPT; as demais são da
+// tabela fora da janela ou da cópia de backup
+int64_t LibSpecialDriveBackendReadAt(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target)
+{
+    LIBSPECIAL_TRACE3(read__start, device, offset, len);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    int64_t bytes = backend && backend->readAt
+                        ? backend->readAt(backend->user, device, offset, len, target)
+                        : LibSpecialDriveReadAt(device, offset, len, target);
+    LIBSPECIAL_STATS_END(offset == 0 ? STATS_PHASE_READ_MBR : STATS_PHASE_READ_GPT, start, bytes);
+    LIBSPECIAL_TRACE3(read__done, device, offset, bytes);
+    return bytes;
+}
+
+int64_t LibSpecialDriveBackendWriteAt(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source)
+{
+    LIBSPECIAL_TRACE3(write__start, device, offset, len);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    int64_t bytes = backend && backend->writeAt
+                        ? backend->writeAt(backend->user, device, offset, len, source)
+                        : LibSpecialDriveWriteAt(device, offset, len, source);
+    LIBSPECIAL_STATS_END(STATS_PHASE_WRITE, start, bytes);
+    LIBSPECIAL_TRACE3(write__done, device, offset, bytes);
+    return bytes;
+}
+
+bool LibSpecialDriveBackendFlush(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device)
+{
+    LIBSPECIAL_TRACE1(flush__start, device);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool ok = backend && backend->flush
+                  ? backend->flush(backend->user, device)
+                  : LibSpecialDriveFlush(device);
+    LIBSPECIAL_STATS_END(STATS_PHASE_WRITE, start, 0);
+    LIBSPECIAL_TRACE2(flush__done, device, (int)ok);
+    return ok;
+}
+
+bool LibSpecialDriveBackendLookUpSizes(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
+{
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool ok = backend && backend->lookUpSizes
+                  ? backend->lookUpSizes(backend->user, device, blk)
+                  : LibSpecialDriveLookUpSizes(device, blk);
+    LIBSPECIAL_STATS_END(STATS_PHASE_SIZES, start, 0);
+    return ok;
+}
+
+bool LibSpecialDriveBackendLookUpIsRemovable(const LibSpecialDrive_Backend *backend, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
+{
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool ok = backend && backend->lookUpIsRemovable
+                  ? backend->lookUpIsRemovable(backend->user, device, blk)
+                  : LibSpecialDriveLookUpIsRemovable(device, blk);
+    LIBSPECIAL_STATS_END(STATS_PHASE_REMOVABLE, start, 0);
+    return ok;
+}
+
+char *LibSpecialDriveBackendPartitionPath(const LibSpecialDrive_Backend *backend, const char *path, int partNumber, LibSpecialDrive_Arena *arena)
+{
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    char *partition = backend && backend->partitionPath
+                          ? backend->partitionPath(backend->user, path, partNumber, arena)
+                          : LibSpecialDrivePartitionPathLookup(path, partNumber, arena);
+    LIBSPECIAL_STATS_END(STATS_PHASE_PARTITION_PATH, start, 0);
+    return partition;
+}
+
+void LibSpecialDriveBackendPartitionMount(const LibSpecialDrive_Backend *backend, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    LIBSPECIAL_TRACE1(mount__start, part ? part->path : NULL);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    if (backend && backend->partitionMount)
+        backend->partitionMount(backend->user, part, type, arena);
+    else
+        LibSpecialDrivePartitionGetPathMount(part, type, arena);
+    LIBSPECIAL_STATS_END(STATS_PHASE_MOUNTS, start, 0);
+    LIBSPECIAL_TRACE2(mount__done, part ? part->path : NULL, part ? part->mountPoint : NULL);
+}
+
+// O valor anterior fica na arena antiga até ela ser liberada
+void LibSpecialDriveBackendPartitionRefreshMount(const LibSpecialDrive_Backend *backend, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    LIBSPECIAL_TRACE1(mount__start, part ? part->path : NULL);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    if (!backend || !backend->partitionMount)
+    {
+        LibSpecialDrivePartitionRefreshMount(part, type, arena);
+    }
+    else if (part)
+    {
+        part->mountPoint = NULL;
+        backend->partitionMount(backend->user, part, type, arena);
+    }
+    LIBSPECIAL_STATS_END(STATS_PHASE_MOUNTS, start, 0);
+    LIBSPECIAL_TRACE2(mount__done, part ? part->path : NULL, part ? part->mountPoint : NULL);
+}
+
+bool LibSpecialDriveBackendMountTableRefresh(const LibSpecialDrive_Backend *backend)
+{
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool changed = backend && backend->mountTableRefresh
+                       ? backend->mountTableRefresh(backend->user)
+                       : LibSpecialDriveMountTableRefresh();
+    LIBSPECIAL_STATS_END(STATS_PHASE_MOUNT_TABLE, start, 0);
+    LIBSPECIAL_TRACE1(mount__table, (int)changed);
+    return changed;
+}
@@ -0,0 +1,431 @@
+#include <LibSpecialDrive.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --- Cache persistente da sondagem ---
+
+// O arquivo guarda o último resultado da sondagem para que a próxima
+// execução o use como contexto anterior de um recarregamento incremental:
+// blocos cuja impressão digital (dev_t, identidade, tamanho, diskseq, MBR
+// e cabeçalho GPT) ainda bate não são sondados de novo, e os de mtime
+// mudado vão direto à sondagem, sem a leitura da impressão digital. O
+// formato segue a ordem de bytes da máquina; o cache não é portável entre arquiteturas.
+// A mesma imagem é o conteúdo do segmento compartilhado (LibSpecialDriveShm.c).
+
+#define LIBSPECIAL_CACHE_MAGIC "LSDCACHE"
+#define LIBSPECIAL_CACHE_VERSION 3
+#define LIBSPECIAL_CACHE_NULL_STRING UINT16_MAX
+
+PACKED_BEGIN
+
+typedef struct PACKED
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t blockCount;
+    uint64_t payloadSize;
+    uint32_t payloadCrc;
+    uint16_t blockRecordSize;     // confere o layout de quem gravou
+    uint16_t partitionRecordSize;
+} LibSpecialDrive_CacheHeader;
+
+// Seguido de pathLen bytes do caminho e de partitionCount partições
+typedef struct PACKED
+{
+    uint64_t devId;
+    uint64_t size;
+    LibSpecialDrive_Fingerprint fingerprint;
+    uint32_t lbaSize;
+    uint8_t type;
+    int8_t flags;
+    uint8_t depth;
+    int8_t partitionCount;
+    uint16_t pathLen;
+    LibSpecialDrive_Protective_MBR signature;
+} LibSpecialDrive_CacheBlock;
+
+// Seguido de pathLen e mountLen bytes; LIBSPECIAL_CACHE_NULL_STRING = NULL
+typedef struct PACKED
+{
+    union LibSpecialDrive_PartitionMeta partitionMeta;
+    uint64_t freeSpace; // última consulta; relida ao carregar o cache
+    uint16_t pathLen;
+    uint16_t mountLen;
+} LibSpecialDrive_CachePartition;
+
+PACKED_END
+
+// --- Gravação ---
+
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    size_t capacity;
+    bool failed;
+} LibSpecialDrive_CacheWriter;
+
+static void LibSpecialDriveCachePut(LibSpecialDrive_CacheWriter *writer, const void *data, size_t len)
+{
+    if (writer->failed || len == 0)
+        return;
+
+    if (writer->capacity - writer->len < len)
+    {
+        size_t capacity = writer->capacity ? writer->capacity : 4096;
+        while (capacity - writer->len < len)
+            capacity *= 2;
+
+        uint8_t *grown = realloc(writer->data, capacity);
+        if (!grown)
+        {
+            writer->failed = true;
+            return;
+        }
+        writer->data = grown;
+        writer->capacity = capacity;
+    }
+
+    memcpy(writer->data + writer->len, data, len);
+    writer->len += len;
+}
+
+static uint16_t LibSpecialDriveCacheStringLen(LibSpecialDrive_CacheWriter *writer, const char *str)
+{
+    if (!str)
+        return LIBSPECIAL_CACHE_NULL_STRING;
+
+    size_t len = strlen(str);
+    if (len >= LIBSPECIAL_CACHE_NULL_STRING)
+    {
+        writer->failed = true;
+        return 0;
+    }
+    return (uint16_t)len;
+}
+
+static void LibSpecialDriveCachePutString(LibSpecialDrive_CacheWriter *writer, const char *str, uint16_t len)
+{
+    if (str && len != LIBSPECIAL_CACHE_NULL_STRING)
+        LibSpecialDriveCachePut(writer, str, len);
+}
+
+static void LibSpecialDriveCachePutBlock(LibSpecialDrive_CacheWriter *writer, const LibSpecialDrive_BlockDevice *blk)
+{
+    if (!blk->path || !blk->signature)
+        return;
+
+    LibSpecialDrive_CacheBlock record;
+    memset(&record, 0, sizeof(record));
+    record.devId = blk->devId;
+    record.size = blk->size;
+    record.fingerprint = blk->fingerprint;
+    record.lbaSize = blk->lbaSize;
+    record.type = (uint8_t)blk->type;
+    record.flags = blk->flags;
+    record.depth = blk->depth;
+    record.partitionCount = blk->partitionCount > 0 ? blk->partitionCount : 0;
+    record.pathLen = LibSpecialDriveCacheStringLen(writer, blk->path);
+    record.signature = *blk->signature;
+
+    LibSpecialDriveCachePut(writer, &record, sizeof(record));
+    LibSpecialDriveCachePutString(writer, blk->path, record.pathLen);
+
+    for (int i = 0; i < record.partitionCount; i++)
+    {
+        const LibSpecialDrive_Partition *part = &blk->partitions[i];
+
+        LibSpecialDrive_CachePartition entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.partitionMeta = part->partitionMeta;
+        entry.freeSpace = part->freeSpace;
+        entry.pathLen = LibSpecialDriveCacheStringLen(writer, part->path);
+        entry.mountLen = LibSpecialDriveCacheStringLen(writer, part->mountPoint);
+
+        LibSpecialDriveCachePut(writer, &entry, sizeof(entry));
+        LibSpecialDriveCachePutString(writer, part->path, entry.pathLen);
+        LibSpecialDriveCachePutString(writer, part->mountPoint, entry.mountLen);
+    }
+}
+
+// Imagem plana do contexto (cabeçalho + registros, sem ponteiros), em
+// memória do chamador; NULL sem memória ou com string longa demais
+uint8_t *LibSpecialDriveCacheSerialize(const LibSpecialDrive *ctx, size_t *len)
+{
+    if (!ctx || !len)
+        return NULL;
+
+    LibSpecialDrive_CacheWriter writer = {0};
+    LibSpecialDrive_CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    LibSpecialDriveCachePut(&writer, &header, sizeof(header));
+
+    size_t total = ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount;
+    for (size_t i = 0; i < total; i++)
+    {
+        const LibSpecialDrive_BlockDevice *blk = i < ctx->commonBlockDeviceCount
+                                                     ? &ctx->commonBlockDevices[i]
+                                                     : &ctx->specialBlockDevices[i - ctx->commonBlockDeviceCount];
+        if (!blk->path || !blk->signature)
+            continue;
+
+        LibSpecialDriveCachePutBlock(&writer, blk);
+        header.blockCount++;
+    }
+
+    if (writer.failed)
+    {
+        free(writer.data);
+        return NULL;
+    }
+
+    memcpy(header.magic, LIBSPECIAL_CACHE_MAGIC, sizeof(header.magic));
+    header.version = LIBSPECIAL_CACHE_VERSION;
+    header.payloadSize = writer.len - sizeof(header);
+    header.payloadCrc = LibSpecialDriveCrc32(0, writer.data + sizeof(header), writer.len - sizeof(header));
+    header.blockRecordSize = sizeof(LibSpecialDrive_CacheBlock);
+    header.partitionRecordSize = sizeof(LibSpecialDrive_CachePartition);
+    memcpy(writer.data, &header, sizeof(header));
+
+    *len = writer.len;
+    return writer.data;
+}
+
+// Grava o contexto num arquivo temporário e o renomeia sobre path, para
+// que leitores concorrentes vejam o cache antigo ou o novo, nunca metade
+bool LibSpecialDriveCacheSave(const LibSpecialDrive *ctx, const char *path)
+{
+    if (!ctx || !path)
+        return false;
+
+    size_t len;
+    uint8_t *data = LibSpecialDriveCacheSerialize(ctx, &len);
+    if (!data)
+        return false;
+
+    char temp[4096];
+#ifdef _WIN32
+    int written = snprintf(temp, sizeof(temp), "%s.%lu.tmp", path, (unsigned long)GetCurrentProcessId());
+#else
+    int written = snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+#endif
+    bool ok = written > 0 && (size_t)written < sizeof(temp);
+
+    FILE *file = ok ? fopen(temp, "wb") : NULL;
+    if (file)
+    {
+        ok = fwrite(data, 1, len, file) == len;
+        ok = fclose(file) == 0 && ok;
+#ifdef _WIN32
+        ok = ok && MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING);
+#else
+        ok = ok && rename(temp, path) == 0;
+#endif
+        if (!ok)
+            remove(temp);
+    }
+    else
+    {
+        ok = false;
+    }
+
+    free(data);
+    return ok;
+}
+
+// --- Leitura ---
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} LibSpecialDrive_CacheReader;
+
+static const void *LibSpecialDriveCacheTake(LibSpecialDrive_CacheReader *reader, size_t len)
+{
+    if (reader->len - reader->pos < len)
+        return NULL;
+
+    const void *ptr = reader->data + reader->pos;
+    reader->pos += len;
+    return ptr;
+}
+
+// Copia a string do arquivo para a arena; false se o registro estiver
+// truncado ou faltar memória
+static bool LibSpecialDriveCacheTakeString(LibSpecialDrive_CacheReader *reader, uint16_t len, char **str, LibSpecialDrive_Arena *arena)
+{
+    *str = NULL;
+    if (len == LIBSPECIAL_CACHE_NULL_STRING)
+        return true;
+
+    const char *source = LibSpecialDriveCacheTake(reader, len);
+    if (!source)
+        return false;
+
+    *str = LibSpecialDriveArenaAlloc(arena, (size_t)len + 1);
+    if (!*str)
+        return false;
+    memcpy(*str, source, len);
+    return true;
+}
+
+// Blocos do cache voltam com o backend do contexto que os carrega
+static LibSpecialDrive_BlockDevice *LibSpecialDriveCacheTakeBlock(LibSpecialDrive_CacheReader *reader, const LibSpecialDrive_Backend *backend, LibSpecialDrive_Arena *arena)
+{
+    LibSpecialDrive_CacheBlock record;
+    const void *source = LibSpecialDriveCacheTake(reader, sizeof(record));
+    if (!source)
+        return NULL;
+    memcpy(&record, source, sizeof(record));
+
+    if (record.partitionCount < 0 || record.lbaSize == 0 || record.pathLen == LIBSPECIAL_CACHE_NULL_STRING ||
+        record.type > PARTITION_TYPE_MBR || record.depth < PROBE_DEPTH_IDENTITY || record.depth > PROBE_DEPTH_FULL)
+        return NULL;
+
+    LibSpecialDrive_BlockDevice *blk = LibSpecialDriveArenaAlloc(arena, sizeof(*blk));
+    if (!blk)
+        return NULL;
+
+    blk->type = (enum LibSpecialDrive_PartitionType)record.type;
+    blk->lbaSize = record.lbaSize;
+    blk->size = record.size;
+    blk->partitionCount = record.partitionCount;
+    blk->flags = record.flags;
+    blk->devId = record.devId;
+    blk->fingerprint = record.fingerprint;
+    blk->depth = record.depth;
+    blk->backend = backend;
+    blk->signature = LibSpecialDriveArenaMemdup(arena, &record.signature, sizeof(record.signature));
+    if (!blk->signature || !LibSpecialDriveCacheTakeString(reader, record.pathLen, &blk->path, arena))
+        return NULL;
+
+    if (blk->partitionCount > 0)
+    {
+        blk->partitions = LibSpecialDriveArenaAlloc(arena, (size_t)blk->partitionCount * sizeof(*blk->partitions));
+        if (!blk->partitions)
+            return NULL;
+    }
+
+    for (int i = 0; i < blk->partitionCount; i++)
+    {
+        LibSpecialDrive_Partition *part = &blk->partitions[i];
+        LibSpecialDrive_CachePartition entry;
+        source = LibSpecialDriveCacheTake(reader, sizeof(entry));
+        if (!source)
+            return NULL;
+        memcpy(&entry, source, sizeof(entry));
+
+        part->partitionMeta = entry.partitionMeta;
+        part->freeSpace = entry.freeSpace; // freeSpaceMs 0: vencido
+        part->lbaSize = &blk->lbaSize;
+        if (!LibSpecialDriveCacheTakeString(reader, entry.pathLen, &part->path, arena) ||
+            !LibSpecialDriveCacheTakeString(reader, entry.mountLen, &part->mountPoint, arena))
+            return NULL;
+    }
+    return blk;
+}
+
+// Interpreta uma imagem de LibSpecialDriveCacheSerialize como conteúdo do
+// contexto (ainda vazio). Sem alterar o contexto se a imagem for inválida.
+bool LibSpecialDriveCacheParse(LibSpecialDrive *ctx, const uint8_t *data, size_t len)
+{
+    LibSpecialDrive_CacheHeader header;
+    if (len < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, LIBSPECIAL_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LIBSPECIAL_CACHE_VERSION ||
+        header.blockRecordSize != sizeof(LibSpecialDrive_CacheBlock) ||
+        header.partitionRecordSize != sizeof(LibSpecialDrive_CachePartition) ||
+        header.payloadSize != len - sizeof(header) ||
+        header.blockCount > header.payloadSize / sizeof(LibSpecialDrive_CacheBlock) ||
+        header.payloadCrc != LibSpecialDriveCrc32(0, data + sizeof(header), len - sizeof(header)))
+        return false;
+
+    LibSpecialDrive_BlockDevice **blocks = calloc(header.blockCount ? header.blockCount : 1, sizeof(*blocks));
+    if (!blocks)
+        return false;
+
+    LibSpecialDrive_ArenaMark mark = LibSpecialDriveArenaGetMark(&ctx->arena);
+    LibSpecialDrive_CacheReader reader = {data, len, sizeof(header)};
+    bool ok = true;
+
+    for (uint32_t i = 0; ok && i < header.blockCount; i++)
+    {
+        blocks[i] = LibSpecialDriveCacheTakeBlock(&reader, ctx->options.backend, &ctx->arena);
+        ok = blocks[i] != NULL;
+    }
+
+    ok = ok && reader.pos == len && LibSpecialDriveContextPlace(ctx, blocks, header.blockCount);
+    if (!ok)
+    {
+        LibSpecialDriveArenaRewind(&ctx->arena, mark);
+        ctx->commonBlockDevices = ctx->specialBlockDevices = NULL;
+        ctx->commonBlockDeviceCount = ctx->specialBlockDeviceCount = 0;
+        memset(&ctx->uuidIndex, 0, sizeof(ctx->uuidIndex));
+    }
+
+    free(blocks);
+    return ok;
+}
+
+// Carrega o cache como conteúdo do contexto (ainda vazio). Retorna false,
+// sem alterar o contexto, se o arquivo não existir ou estiver inválido.
+bool LibSpecialDriveCacheLoad(LibSpecialDrive *ctx, const char *path)
+{
+    if (!ctx || !path)
+        return false;
+
+    bool ok = false;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (uint64_t)size.QuadPart <= SIZE_MAX)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+    {
+        const uint8_t *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data)
+        {
+            ok = LibSpecialDriveCacheParse(ctx, data, (size_t)size.QuadPart);
+            UnmapViewOfFile(data);
+        }
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= SIZE_MAX)
+    {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            ok = LibSpecialDriveCacheParse(ctx, data, (size_t)st.st_size);
+            munmap(data, (size_t)st.st_size);
+        }
+    }
+    close(fd);
+#endif
+    return ok;
+}
@@ -0,0 +1,285 @@
+#include <LibSpecialDrive.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LIBSPECIAL_CRC32_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <wmmintrin.h>
+#include <smmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define LIBSPECIAL_CRC32_ARM 1
+#if defined(_MSC_VER)
+#include <arm64intr.h>
+#else
+#include <arm_acle.h>
+#endif
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// CRC-32 da GPT (IEEE 802.3, polinômio refletido 0xEDB88320), mesmo
+// resultado que o crc32() do zlib. O estado interno é o CRC invertido.
+
+// --- Fallback portátil: slicing-by-8 ---
+
+static uint32_t crcTable[8][256];
+
+static void LibSpecialDriveCrc32TableInit(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : c >> 1;
+        crcTable[0][i] = c;
+    }
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (int t = 1; t < 8; t++)
+            crcTable[t][i] = (crcTable[t - 1][i] >> 8) ^ crcTable[0][crcTable[t - 1][i] & 0xFF];
+    }
+}
+
+static uint32_t LibSpecialDriveCrc32Slice8(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len >= 8)
+    {
+        // Leitura em little-endian independente da arquitetura
+        uint32_t lo = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        uint32_t hi = (uint32_t)data[4] | (uint32_t)data[5] << 8 | (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+
+        crc = crcTable[7][lo & 0xFF] ^ crcTable[6][(lo >> 8) & 0xFF] ^
+              crcTable[5][(lo >> 16) & 0xFF] ^ crcTable[4][lo >> 24] ^
+              crcTable[3][hi & 0xFF] ^ crcTable[2][(hi >> 8) & 0xFF] ^
+              crcTable[1][(hi >> 16) & 0xFF] ^ crcTable[0][hi >> 24];
+
+        data += 8;
+        len -= 8;
+    }
+
+    while (len--)
+        crc = (crc >> 8) ^ crcTable[0][(crc ^ *data++) & 0xFF];
+
+    return crc;
+}
+
+// --- x86: dobra com multiplicação sem carry (PCLMULQDQ) ---
+
+#ifdef LIBSPECIAL_CRC32_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LIBSPECIAL_TARGET_PCLMUL
+#else
+#define LIBSPECIAL_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+
+// Dobra 4 x 128 bits em paralelo, reduz para 128, 64 e por Barrett para 32
+// bits ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ",
+// Intel). Exige len >= 64 e múltiplo de 16.
+LIBSPECIAL_TARGET_PCLMUL
+static uint32_t LibSpecialDriveCrc32Pclmul(uint32_t crc, const uint8_t *data, size_t len)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(const void *)(data + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(const void *)(data + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(const void *)(data + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(const void *)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+
+    data += 64;
+    len -= 64;
+
+    while (len >= 64)
+    {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(const void *)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(const void *)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(const void *)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(const void *)(data + 0x30)));
+
+        data += 64;
+        len -= 64;
+    }
+
+    // 512 -> 128 bits
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+    while (len >= 16)
+    {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)(const void *)data)), x5);
+
+        data += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    // Redução de Barrett para 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static uint32_t LibSpecialDriveCrc32X86(uint32_t crc, const uint8_t *data, size_t len)
+{
+    if (len >= 64)
+    {
+        size_t chunk = len & ~(size_t)15;
+        crc = LibSpecialDriveCrc32Pclmul(crc, data, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+    return LibSpecialDriveCrc32Slice8(crc, data, len);
+}
+
+static bool LibSpecialDriveCrc32X86Supported(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) && (info[2] & (1 << 19)); // PCLMULQDQ e SSE4.1
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif
+
+// --- ARMv8: instruções CRC32 ---
+
+#ifdef LIBSPECIAL_CRC32_ARM
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LIBSPECIAL_TARGET_CRC
+#elif defined(__clang__)
+#define LIBSPECIAL_TARGET_CRC __attribute__((target("crc")))
+#else
+#define LIBSPECIAL_TARGET_CRC __attribute__((target("+crc")))
+#endif
+
+LIBSPECIAL_TARGET_CRC
+static uint32_t LibSpecialDriveCrc32Arm(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len >= 8)
+    {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        crc = __crc32d(crc, value);
+        data += 8;
+        len -= 8;
+    }
+
+    while (len--)
+        crc = __crc32b(crc, *data++);
+
+    return crc;
+}
+
+static bool LibSpecialDriveCrc32ArmSupported(void)
+{
+#if defined(__APPLE__)
+    return true; // presente em todo Apple Silicon
+#elif defined(_WIN32)
+    return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined(__linux__) && defined(HWCAP_CRC32)
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+// --- Seleção em tempo de execução ---
+
+typedef uint32_t (*LibSpecialDrive_Crc32Fn)(uint32_t crc, const uint8_t *data, size_t len);
+
+static LibSpecialDrive_Crc32Fn crcImpl = LibSpecialDriveCrc32Slice8;
+
+static void LibSpecialDriveCrc32Init(void)
+{
+    LibSpecialDriveCrc32TableInit();
+#if defined(LIBSPECIAL_CRC32_X86)
+    if (LibSpecialDriveCrc32X86Supported())
+        crcImpl = LibSpecialDriveCrc32X86;
+#elif defined(LIBSPECIAL_CRC32_ARM)
+    if (LibSpecialDriveCrc32ArmSupported())
+        crcImpl = LibSpecialDriveCrc32Arm;
+#endif
+}
+
+#ifdef _WIN32
+static INIT_ONCE crcOnce = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK LibSpecialDriveCrc32InitOnce(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    LibSpecialDriveCrc32Init();
+    return TRUE;
+}
+#else
+static pthread_once_t crcOnce = PTHREAD_ONCE_INIT;
+#endif
+
+// Continua um CRC anterior (0 para começar), como o crc32() do zlib
+uint32_t LibSpecialDriveCrc32(uint32_t crc, const void *data, size_t len)
+{
+#ifdef _WIN32
+    InitOnceExecuteOnce(&crcOnce, LibSpecialDriveCrc32InitOnce, NULL, NULL);
+#else
+    pthread_once(&crcOnce, LibSpecialDriveCrc32Init);
+#endif
+
+    if (!data)
+        return crc;
+    return ~crcImpl(~crc, data, len);
+}
+
+// Sempre o caminho portátil; permite conferir a implementação acelerada
+uint32_t LibSpecialDriveCrc32Portable(uint32_t crc, const void *data, size_t len)
+{
+    LibSpecialDriveCrc32(0, NULL, 0);
+    if (!data)
+        return crc;
+    return ~LibSpecialDriveCrc32Slice8(~crc, data, len);
+}
@@ -0,0 +1,366 @@
+#include <LibSpecialDrive.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+// --- Consultas de espaço livre com tempo limite ---
+
+// Cada consulta roda numa thread auxiliar destacada. Um sistema de arquivos
+// travado (ex.: NFS sem servidor) prende só essa thread: o chamador desiste
+// no prazo e a thread libera a consulta quando o statvfs voltar.
+typedef struct LibSpecialDrive_FreeSpaceQuery
+{
+    struct LibSpecialDrive_FreeSpaceQuery *next; // lista de consultas em voo
+    char *directory;
+    uint64_t startedMs;
+    uint64_t freeSpace;
+    bool ok;
+    bool done;
+    int refs; // thread auxiliar + chamadores esperando
+} LibSpecialDrive_FreeSpaceQuery;
+
+#ifdef _WIN32
+static SRWLOCK queryLock = SRWLOCK_INIT;
+static CONDITION_VARIABLE queryDone = CONDITION_VARIABLE_INIT;
+#else
+static pthread_mutex_t queryLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queryDone;
+static pthread_once_t queryOnce = PTHREAD_ONCE_INIT;
+
+// Espera com relógio monotônico, imune a ajustes da hora do sistema
+static void LibSpecialDriveFreeSpaceInit(void)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queryDone, &attr);
+    pthread_condattr_destroy(&attr);
+}
+#endif
+
+static LibSpecialDrive_FreeSpaceQuery *queriesInFlight = NULL;
+
+static void LibSpecialDriveQueryLock(void)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&queryLock);
+#else
+    pthread_once(&queryOnce, LibSpecialDriveFreeSpaceInit);
+    pthread_mutex_lock(&queryLock);
+#endif
+}
+
+static void LibSpecialDriveQueryUnlock(void)
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&queryLock);
+#else
+    pthread_mutex_unlock(&queryLock);
+#endif
+}
+
+// Espera uma conclusão qualquer até deadlineMs; chamada com o lock
+static void LibSpecialDriveQueryWait(uint64_t deadlineMs)
+{
+    uint64_t now = LibSpecialDriveNowMs();
+    if (now >= deadlineMs)
+        return;
+
+#ifdef _WIN32
+    SleepConditionVariableSRW(&queryDone, &queryLock, (DWORD)(deadlineMs - now), 0);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t nsec = (uint64_t)ts.tv_nsec + (deadlineMs - now) % 1000 * 1000000u;
+    ts.tv_sec += (time_t)((deadlineMs - now) / 1000 + nsec / 1000000000u);
+    ts.tv_nsec = (long)(nsec % 1000000000u);
+    pthread_cond_timedwait(&queryDone, &queryLock, &ts);
+#endif
+}
+
+// Solta uma referência; chamada com o lock
+static void LibSpecialDriveQueryRelease(LibSpecialDrive_FreeSpaceQuery *query)
+{
+    if (--query->refs > 0)
+        return;
+    free(query->directory);
+    free(query);
+}
+
+static void LibSpecialDriveQueryRun(LibSpecialDrive_FreeSpaceQuery *query)
+{
+    uint64_t freeSpace = 0;
+    LIBSPECIAL_TRACE1(statvfs__start, query->directory);
+    uint64_t start = LIBSPECIAL_STATS_BEGIN();
+    bool ok = LibSpecialDriveDiretoryFreeSpaceLookup(query->directory, &freeSpace);
+    LIBSPECIAL_STATS_END(STATS_PHASE_FREE_SPACE, start, 0);
+    LIBSPECIAL_TRACE3(statvfs__done, query->directory, (int)ok, freeSpace);
+
+    LibSpecialDriveQueryLock();
+    query->freeSpace = freeSpace;
+    query->ok = ok;
+    query->done = true;
+
+    for (LibSpecialDrive_FreeSpaceQuery **link = &queriesInFlight; *link; link = &(*link)->next)
+    {
+        if (*link == query)
+        {
+            *link = query->next;
+            break;
+        }
+    }
+
+#ifdef _WIN32
+    WakeAllConditionVariable(&queryDone);
+#else
+    pthread_cond_broadcast(&queryDone);
+#endif
+    LibSpecialDriveQueryRelease(query);
+    LibSpecialDriveQueryUnlock();
+}
+
+#ifdef _WIN32
+static DWORD WINAPI LibSpecialDriveQueryThread(LPVOID arg)
+{
+    LibSpecialDriveQueryRun(arg);
+    return 0;
+}
+#else
+static void *LibSpecialDriveQueryThread(void *arg)
+{
+    LibSpecialDriveQueryRun(arg);
+    return NULL;
+}
+#endif
+
+// Inicia (ou reaproveita) a consulta de um diretório. Retorna NULL se não
+// há como consultar agora, inclusive quando uma consulta anterior ao mesmo
+// diretório já passou do prazo: o mount está travado e esperar de novo só
+// atrasaria o chamador. Chamada com o lock.
+static LibSpecialDrive_FreeSpaceQuery *LibSpecialDriveQueryStart(const char *directory, uint32_t timeoutMs, uint64_t now)
+{
+    for (LibSpecialDrive_FreeSpaceQuery *query = queriesInFlight; query; query = query->next)
+    {
+        if (strcmp(query->directory, directory) != 0)
+            continue;
+        if (now - query->startedMs >= timeoutMs)
+            return NULL;
+        query->refs++;
+        return query;
+    }
+
+    LibSpecialDrive_FreeSpaceQuery *query = calloc(1, sizeof(*query));
+    if (!query)
+        return NULL;
+
+    size_t len = strlen(directory) + 1;
+    query->directory = malloc(len);
+    if (!query->directory)
+    {
+        free(query);
+        return NULL;
+    }
+    memcpy(query->directory, directory, len);
+    query->startedMs = now;
+    query->refs = 2;
+
+#ifdef _WIN32
+    HANDLE thread = CreateThread(NULL, 0, LibSpecialDriveQueryThread, query, 0, NULL);
+    bool started = thread != NULL;
+    if (started)
+        CloseHandle(thread);
+#else
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    bool started = pthread_create(&thread, &attr, LibSpecialDriveQueryThread, query) == 0;
+    pthread_attr_destroy(&attr);
+#endif
+
+    if (!started)
+    {
+        free(query->directory);
+        free(query);
+        return NULL;
+    }
+
+    query->next = queriesInFlight;
+    queriesInFlight = query;
+    return query;
+}
+
+static bool LibSpecialDriveFreeSpaceExpired(const LibSpecialDrive_Partition *part, uint64_t maxAgeMs, uint64_t now)
+{
+    return part->freeSpaceMs == 0 || now - part->freeSpaceMs >= maxAgeMs;
+}
+
+// Atualiza as partições montadas cujo valor tem mais de maxAgeMs (0 = todas),
+// com todas as consultas em paralelo e um único prazo de timeoutMs. Quem
+// estoura o prazo mantém o valor anterior. Retorna quantas foram atualizadas.
+size_t LibSpecialDriveFreeSpaceRefresh(LibSpecialDrive_Partition *const *parts, size_t count, uint64_t maxAgeMs, uint32_t timeoutMs)
+{
+    if (!parts || count == 0)
+        return 0;
+
+    LibSpecialDrive_FreeSpaceQuery **queries = calloc(count, sizeof(*queries));
+    if (!queries)
+        return 0;
+
+    uint64_t now = LibSpecialDriveNowMs();
+    uint64_t deadline = now + timeoutMs;
+    size_t pending = 0, updated = 0;
+
+    LibSpecialDriveQueryLock();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!parts[i] || !parts[i]->mountPoint || !LibSpecialDriveFreeSpaceExpired(parts[i], maxAgeMs, now))
+            continue;
+        queries[i] = LibSpecialDriveQueryStart(parts[i]->mountPoint, timeoutMs, now);
+        pending += queries[i] != NULL;
+    }
+
+    while (pending > 0 && LibSpecialDriveNowMs() < deadline)
+    {
+        LibSpecialDriveQueryWait(deadline);
+
+        pending = 0;
+        for (size_t i = 0; i < count; i++)
+            pending += queries[i] && !queries[i]->done;
+    }
+
+    now = LibSpecialDriveNowMs();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!queries[i])
+            continue;
+
+        if (queries[i]->done)
+        {
+            // Falha do statvfs também fica em cache, com valor 0
+            parts[i]->freeSpace = queries[i]->ok ? queries[i]->freeSpace : 0;
+            parts[i]->freeSpaceMs = now;
+            updated++;
+        }
+        LibSpecialDriveQueryRelease(queries[i]);
+    }
+    LibSpecialDriveQueryUnlock();
+
+    free(queries);
+    return updated;
+}
+
+// --- Contexto ---
+
+static size_t LibSpecialDriveFreeSpaceCollect(LibSpecialDrive_BlockDevice *blk, LibSpecialDrive_Partition **parts, size_t count)
+{
+    if (blk->depth < PROBE_DEPTH_FULL)
+        return count;
+
+    for (int i = 0; i < blk->partitionCount; i++)
+    {
+        if (blk->partitions[i].mountPoint)
+            parts[count++] = &blk->partitions[i];
+    }
+    return count;
+}
+
+// Consulta agora o espaço livre das partições montadas de blocks (entradas
+// NULL são ignoradas), sem contexto nem cache; usado na enumeração em fluxo
+size_t LibSpecialDriveFreeSpaceRefreshList(LibSpecialDrive_BlockDevice *const *blocks, size_t count, uint32_t timeoutMs)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += blocks[i] && blocks[i]->partitionCount > 0 ? (size_t)blocks[i]->partitionCount : 0;
+    if (total == 0)
+        return 0;
+
+    LibSpecialDrive_Partition **parts = malloc(total * sizeof(*parts));
+    if (!parts)
+        return 0;
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (blocks[i])
+            found = LibSpecialDriveFreeSpaceCollect(blocks[i], parts, found);
+    }
+
+    size_t updated = LibSpecialDriveFreeSpaceRefresh(parts, found, 0, timeoutMs);
+    free(parts);
+    return updated;
+}
+
+// Atualiza o espaço livre de um bloco (ou de todos, com blk NULL) sondado
+// com PROBE_DEPTH_FULL. Sem force, respeita a validade do cache.
+size_t LibSpecialDriveFreeSpaceRefreshBlocks(LibSpecialDrive *ctx, LibSpecialDrive_BlockDevice *blk, bool force)
+{
+    if (!ctx)
+        return 0;
+
+    size_t total = 0;
+    if (blk)
+    {
+        total = (size_t)(blk->partitionCount > 0 ? blk->partitionCount : 0);
+    }
+    else
+    {
+        for (size_t i = 0; i < ctx->commonBlockDeviceCount; i++)
+            total += (size_t)(ctx->commonBlockDevices[i].partitionCount > 0 ? ctx->commonBlockDevices[i].partitionCount : 0);
+        for (size_t i = 0; i < ctx->specialBlockDeviceCount; i++)
+            total += (size_t)(ctx->specialBlockDevices[i].partitionCount > 0 ? ctx->specialBlockDevices[i].partitionCount : 0);
+    }
+    if (total == 0)
+        return 0;
+
+    LibSpecialDrive_Partition **parts = malloc(total * sizeof(*parts));
+    if (!parts)
+        return 0;
+
+    size_t count = 0;
+    if (blk)
+    {
+        count = LibSpecialDriveFreeSpaceCollect(blk, parts, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < ctx->commonBlockDeviceCount; i++)
+            count = LibSpecialDriveFreeSpaceCollect(&ctx->commonBlockDevices[i], parts, count);
+        for (size_t i = 0; i < ctx->specialBlockDeviceCount; i++)
+            count = LibSpecialDriveFreeSpaceCollect(&ctx->specialBlockDevices[i], parts, count);
+    }
+
+    size_t updated = LibSpecialDriveFreeSpaceRefresh(parts, count, force ? 0 : ctx->options.freeSpaceTtlMs, ctx->options.freeSpaceTimeoutMs);
+    free(parts);
+    return updated;
+}
+
+// Atualização em lote, antes de listar ou em laços de monitoramento:
+// consulta em paralelo todas as partições montadas com valor vencido (ou
+// todas, com force) e publica uma única vez
+size_t LibSpecialDriveRefreshFreeSpace(LibSpecialDrive *ctx, bool force)
+{
+    size_t updated = LibSpecialDriveFreeSpaceRefreshBlocks(ctx, NULL, force);
+    if (updated > 0)
+        LibSpecialDriveContextPublish(ctx);
+    return updated;
+}
+
+// Espaço livre de uma partição montada, consultado só quando o valor em
+// cache passou da validade. Espera no máximo freeSpaceTimeoutMs. O valor
+// novo não é publicado aqui: leitores de outras threads e processos o veem
+// na próxima LibSpecialDriveRefreshFreeSpace ou alteração do contexto.
+uint64_t LibSpecialDriveGetFreeSpace(LibSpecialDrive *ctx, LibSpecialDrive_Partition *part)
+{
+    if (!ctx || !part)
+        return 0;
+
+    LibSpecialDriveFreeSpaceRefresh(&part, 1, ctx->options.freeSpaceTtlMs, ctx->options.freeSpaceTimeoutMs);
+    return part->freeSpace;
+}
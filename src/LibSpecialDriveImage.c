@@ -0,0 +1,272 @@
+#include <LibSpecialDrive.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+// --- Backend de imagens de disco ---
+
+// Apresenta cada arquivo regular de um diretório (ex.: imagens esparsas
+// GPT/MBR criadas com truncate) como um dispositivo de bloco. Abertura,
+// leitura, escrita e flush são as do sistema, que já funcionam em arquivos;
+// o backend troca a descoberta, os tamanhos, os caminhos de partição e as
+// montagens (imagens nunca estão montadas). Serve para reproduzir hosts com
+// milhares de discos sem root e sem discos reais, inclusive Mark/Unmark.
+
+typedef struct
+{
+    LibSpecialDrive_Backend backend; // primeiro campo: o ponteiro exportado
+    char *directory;
+    uint32_t lbaSize;
+} LibSpecialDrive_ImageBackend;
+
+// Identidade estável pelo nome do arquivo: serve de devId e de hash de
+// número de série; nunca 0
+static uint64_t LibSpecialDriveImageHash(const char *name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (; *name; name++)
+        hash = (hash ^ (uint8_t)*name) * 0x100000001b3ull;
+    return hash ? hash : 1;
+}
+
+static int LibSpecialDriveImageCompare(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static bool LibSpecialDriveImageAppend(char ***names, size_t *count, size_t *capacity, const char *name)
+{
+    if (name[0] == '.')
+        return true;
+
+    if (*count == *capacity)
+    {
+        size_t grown = *capacity ? *capacity * 2 : 64;
+        char **items = realloc(*names, grown * sizeof(*items));
+        if (!items)
+            return false;
+        *names = items;
+        *capacity = grown;
+    }
+
+    size_t len = strlen(name) + 1;
+    char *copy = malloc(len);
+    if (!copy)
+        return false;
+    memcpy(copy, name, len);
+    (*names)[(*count)++] = copy;
+    return true;
+}
+
+// Nomes do diretório em ordem alfabética, para que a enumeração seja a
+// mesma em toda execução
+static bool LibSpecialDriveImageList(const char *directory, char ***names, size_t *count)
+{
+    size_t capacity = 0;
+    bool ok = true;
+    *names = NULL;
+    *count = 0;
+
+#ifdef _WIN32
+    char pattern[MAX_PATH];
+    int written = snprintf(pattern, sizeof(pattern), "%s\\*", directory);
+    if (written <= 0 || (size_t)written >= sizeof(pattern))
+        return false;
+
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE)
+        return false;
+    do
+    {
+        if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            ok = LibSpecialDriveImageAppend(names, count, &capacity, entry.cFileName);
+    } while (ok && FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    DIR *dir = opendir(directory);
+    if (!dir)
+    {
+        perror("opendir");
+        return false;
+    }
+
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL)
+        ok = LibSpecialDriveImageAppend(names, count, &capacity, entry->d_name);
+    closedir(dir);
+#endif
+
+    if (ok)
+        qsort(*names, *count, sizeof(**names), LibSpecialDriveImageCompare);
+    return ok;
+}
+
+// Tamanho, permissão de escrita e mtime do arquivo; false se não for um
+// arquivo regular utilizável
+static bool LibSpecialDriveImageStat(const char *path, uint64_t *size, bool *readOnly, uint64_t *stamp)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        return false;
+    *size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    *readOnly = (data.dwFileAttributes & FILE_ATTRIBUTE_READONLY) != 0;
+    *stamp = (((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+    *size = (uint64_t)st.st_size;
+    *readOnly = access(path, W_OK) != 0;
+#ifdef __APPLE__
+    *stamp = (uint64_t)st.st_mtimespec.tv_sec * 1000000000u + (uint64_t)st.st_mtimespec.tv_nsec;
+#else
+    *stamp = (uint64_t)st.st_mtim.tv_sec * 1000000000u + (uint64_t)st.st_mtim.tv_nsec;
+#endif
+#endif
+    return true;
+}
+
+static bool LibSpecialDriveImageDiscover(void *user, const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *callbackUser)
+{
+    (void)options;
+    LibSpecialDrive_ImageBackend *image = user;
+
+    char **names;
+    size_t count;
+    if (!LibSpecialDriveImageList(image->directory, &names, &count))
+        return false;
+
+    bool ok = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        char path[4096];
+        int written = snprintf(path, sizeof(path), "%s/%s", image->directory, names[i]);
+
+        uint64_t size, stamp;
+        bool readOnly;
+        if (ok && written > 0 && (size_t)written < sizeof(path) &&
+            LibSpecialDriveImageStat(path, &size, &readOnly, &stamp) && size >= (uint64_t)image->lbaSize * 2)
+        {
+            uint64_t identity = LibSpecialDriveImageHash(names[i]);
+            LibSpecialDrive_Candidate cand = {path, readOnly ? BLOCK_FLAG_IS_READ_ONLY : 0, identity, 0,
+                                              size - size % image->lbaSize, image->lbaSize, true, identity, NULL, stamp};
+            ok = callback(&cand, callbackUser);
+        }
+        free(names[i]);
+    }
+
+    free(names);
+    return ok;
+}
+
+static bool LibSpecialDriveImageLookUpSizes(void *user, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
+{
+    LibSpecialDrive_ImageBackend *image = user;
+    uint64_t size;
+
+#ifdef _WIN32
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(device, &length))
+        return false;
+    size = (uint64_t)length.QuadPart;
+#else
+    struct stat st;
+    if (fstat(device, &st) != 0)
+        return false;
+    size = (uint64_t)st.st_size;
+#endif
+
+    blk->lbaSize = image->lbaSize;
+    blk->size = size - size % image->lbaSize;
+    return true;
+}
+
+// Removível/somente leitura já vêm da descoberta
+static bool LibSpecialDriveImageLookUpIsRemovable(void *user, LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
+{
+    (void)user;
+    (void)device;
+    (void)blk;
+    return false;
+}
+
+// Partições ganham o sufixo pN, como em /dev/nvme0n1p1; partNumber começa em 0
+static char *LibSpecialDriveImagePartitionPath(void *user, const char *path, int partNumber, LibSpecialDrive_Arena *arena)
+{
+    (void)user;
+    char partition[4096];
+    int written = snprintf(partition, sizeof(partition), "%sp%d", path, partNumber + 1);
+    if (written <= 0 || (size_t)written >= sizeof(partition))
+        return NULL;
+    return LibSpecialDriveArenaStrdup(arena, partition);
+}
+
+static void LibSpecialDriveImagePartitionMount(void *user, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    (void)user;
+    (void)part;
+    (void)type;
+    (void)arena;
+}
+
+static bool LibSpecialDriveImageMountTableRefresh(void *user)
+{
+    (void)user;
+    return false;
+}
+
+// Backend sobre o diretório directory, com setores de lbaSize bytes
+// (0 = 512). Usado em LibSpecialDrive_Options.backend; deve viver mais que
+// os contextos que o usam.
+LibSpecialDrive_Backend *LibSpecialDriveBackendImageCreate(const char *directory, uint32_t lbaSize)
+{
+    if (!directory)
+        return NULL;
+    if (lbaSize == 0)
+        lbaSize = 512;
+    if (lbaSize < sizeof(LibSpecialDrive_Protective_MBR))
+        return NULL;
+
+    LibSpecialDrive_ImageBackend *image = calloc(1, sizeof(*image));
+    size_t len = strlen(directory) + 1;
+    char *copy = malloc(len);
+    if (!image || !copy)
+    {
+        free(image);
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy, directory, len);
+
+    image->directory = copy;
+    image->lbaSize = lbaSize;
+    image->backend.user = image;
+    image->backend.discover = LibSpecialDriveImageDiscover;
+    image->backend.lookUpSizes = LibSpecialDriveImageLookUpSizes;
+    image->backend.lookUpIsRemovable = LibSpecialDriveImageLookUpIsRemovable;
+    image->backend.partitionPath = LibSpecialDriveImagePartitionPath;
+    image->backend.partitionMount = LibSpecialDriveImagePartitionMount;
+    image->backend.mountTableRefresh = LibSpecialDriveImageMountTableRefresh;
+    return &image->backend;
+}
+
+void LibSpecialDriveBackendImageDestroy(LibSpecialDrive_Backend **backend)
+{
+    if (!backend || !*backend)
+        return;
+
+    LibSpecialDrive_ImageBackend *image = (*backend)->user;
+    free(image->directory);
+    free(image);
+    *backend = NULL;
+}
@@ -1,5 +1,6 @@
 #ifdef __linux__
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,40 +12,152 @@
 #include <sys/ioctl.h>
 #include <sys/file.h>
 #include <sys/stat.h>
+#include <dirent.h>
+#include <sys/sysmacros.h>
 #include <sys/statvfs.h>
-#include <mntent.h>
+#include <poll.h>
+#include <pthread.h>
 #include <limits.h>
 #include <LibSpecialDrive.h>
 #include <ctype.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 
-void LibSpecialDriveDiretoryFreeSpaceLookup(LibSpecialDrive_Partition *part)
+bool LibSpecialDriveDiretoryFreeSpaceLookup(const char *directory, uint64_t *freeSpace)
 {
-    if (!part && !part->mountPoint)
-        return;
+    if (!directory || !freeSpace)
+        return false;
+
     struct statvfs stat;
+    if (statvfs(directory, &stat) != 0)
+        return false;
+
+    *freeSpace = (uint64_t)stat.f_bavail * (uint64_t)stat.f_frsize;
+    return true;
+}
+
+// --- Atributos do sysfs ---
+
+#define LIBSPECIAL_SYSFS_BLOCK "/sys/class/block"
+
+// Lê um atributo curto (ex.: "size", "queue/logical_block_size") sem o '\n'
+static bool LibSpecialDriveSysfsRead(const char *dir, const char *attr, char *value, size_t size)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir, attr);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    ssize_t len;
+    do
+        len = read(fd, value, size - 1);
+    while (len < 0 && errno == EINTR);
+    close(fd);
+
+    if (len <= 0)
+        return false;
+
+    value[len] = '\0';
+    value[strcspn(value, "\n")] = '\0';
+    return true;
+}
+
+static bool LibSpecialDriveSysfsReadU64(const char *dir, const char *attr, uint64_t *value)
+{
+    char text[64];
+    if (!LibSpecialDriveSysfsRead(dir, attr, text, sizeof(text)))
+        return false;
+
+    char *end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno != 0 || end == text)
+        return false;
+
+    *value = (uint64_t)parsed;
+    return true;
+}
+
+// Identidade estável do disco: o primeiro WWID ou número de série que o
+// driver expõe, reduzido a um hash FNV-1a (0 = indisponível)
+static uint64_t LibSpecialDriveSysfsIdentity(const char *dir)
+{
+    static const char *const attrs[] = {"wwid", "device/wwid", "serial", "device/serial"};
+    char value[256];
+
+    for (size_t i = 0; i < sizeof(attrs) / sizeof(attrs[0]); i++)
+    {
+        if (!LibSpecialDriveSysfsRead(dir, attrs[i], value, sizeof(value)) || value[0] == '\0')
+            continue;
+
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (const char *c = value; *c; c++)
+            hash = (hash ^ (uint8_t)*c) * 0x100000001B3ull;
+        return hash ? hash : 1;
+    }
+    return 0;
+}
 
-    if (statvfs(part->mountPoint, &stat) != 0)
+// No sysfs '/' do nome do dispositivo vira '!' (ex.: "cciss!c0d0")
+static void LibSpecialDriveSysfsName(char *name, char from, char to)
+{
+    for (char *c = name; *c; c++)
     {
-        part->freeSpace = 0;
+        if (*c == from)
+            *c = to;
     }
+}
 
-    unsigned long block_size = stat.f_frsize;
-    part->freeSpace = stat.f_bavail * block_size;
+// Partições são filhas do disco no sysfs ("sda/sda1", "nvme0n1/nvme0n1p1"),
+// o que evita abrir nós de dispositivo só para descobrir o nome
+static bool LibSpecialDriveSysfsPartitionName(const char *path, int partitionNumber, char *target, size_t size)
+{
+    if (strncmp(path, "/dev/", 5) != 0)
+        return false;
+
+    char disk[NAME_MAX + 1];
+    snprintf(disk, sizeof(disk), "%s", path + 5);
+    LibSpecialDriveSysfsName(disk, '/', '!');
+
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), LIBSPECIAL_SYSFS_BLOCK "/%s", disk);
+    if (access(dir, F_OK) != 0)
+        return false;
+
+    static const char *const formats[] = {"%s/%s%d/partition", "%s/%sp%d/partition"};
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+    {
+        char child[PATH_MAX];
+        snprintf(child, sizeof(child), formats[i], dir, disk, partitionNumber + 1);
+        if (access(child, F_OK) != 0)
+            continue;
+
+        snprintf(target, size, i == 0 ? "%s%d" : "%sp%d", path, partitionNumber + 1);
+        return true;
+    }
+
+    return false;
 }
 
-char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber)
+char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber, LibSpecialDrive_Arena *arena)
 {
     if (!path || partitionNumber < 0)
         return NULL;
 
     char partitionPath[PATH_MAX];
+    if (LibSpecialDriveSysfsPartitionName(path, partitionNumber, partitionPath, sizeof(partitionPath)))
+        return LibSpecialDriveArenaStrdup(arena, partitionPath);
+
+    // Sem sysfs (ou caminho fora de /dev): tenta abrir os dois formatos
     snprintf(partitionPath, sizeof(partitionPath), "%s%d", path, partitionNumber + 1);
 
     int fd = open(partitionPath, O_RDONLY);
     if (!(fd < 0))
     {
         close(fd);
-        return strdup(partitionPath);
+        return LibSpecialDriveArenaStrdup(arena, partitionPath);
     }
     snprintf(partitionPath, sizeof(partitionPath), "%sp%d", path, partitionNumber + 1);
     fd = open(partitionPath, O_RDONLY);
@@ -53,30 +166,285 @@ char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber)
         return NULL;
     }
 
-    return strdup(partitionPath);
+    close(fd);
+    return LibSpecialDriveArenaStrdup(arena, partitionPath);
+}
+
+// --- Índice de montagens (/proc/self/mountinfo) ---
+
+typedef struct
+{
+    dev_t dev;
+    const char *source;
+    const char *mountPoint;
+    bool rootMount; // raiz do sistema de arquivos (não é bind de subdiretório)
+    size_t order;   // posição no arquivo, desempate entre iguais
+} LibSpecialDrive_MountEntry;
+
+static struct
+{
+    pthread_rwlock_t lock;
+    int fd; // mantido aberto para poll(POLLPRI) detectar mudanças
+    bool valid;
+    char *content; // conteúdo lido; as entradas apontam para ele
+    LibSpecialDrive_MountEntry *byDev;
+    LibSpecialDrive_MountEntry *bySource;
+    size_t count;
+} mountIndex = {PTHREAD_RWLOCK_INITIALIZER, -1, false, NULL, NULL, NULL, 0};
+
+// Desfaz os escapes octais do mountinfo (ex.: "\040" para espaço)
+static void LibSpecialDriveMountUnescape(char *field)
+{
+    char *out = field;
+    for (char *in = field; *in; in++)
+    {
+        if (in[0] == '\\' && in[1] >= '0' && in[1] <= '7' && in[2] >= '0' && in[2] <= '7' && in[3] >= '0' && in[3] <= '7')
+        {
+            *out++ = (char)(((in[1] - '0') << 6) | ((in[2] - '0') << 3) | (in[3] - '0'));
+            in += 3;
+            continue;
+        }
+        *out++ = *in;
+    }
+    *out = '\0';
+}
+
+static int LibSpecialDriveMountCompareDev(const void *a, const void *b)
+{
+    const LibSpecialDrive_MountEntry *x = a, *y = b;
+    if (x->dev != y->dev)
+        return x->dev < y->dev ? -1 : 1;
+    if (x->rootMount != y->rootMount)
+        return x->rootMount ? -1 : 1;
+    return x->order < y->order ? -1 : (x->order > y->order);
+}
+
+static int LibSpecialDriveMountCompareSource(const void *a, const void *b)
+{
+    const LibSpecialDrive_MountEntry *x = a, *y = b;
+    int cmp = strcmp(x->source, y->source);
+    if (cmp != 0)
+        return cmp;
+    if (x->rootMount != y->rootMount)
+        return x->rootMount ? -1 : 1;
+    return x->order < y->order ? -1 : (x->order > y->order);
 }
 
-void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type)
+static char *LibSpecialDriveMountReadAll(int fd)
+{
+    size_t capacity = 64 * 1024, len = 0;
+    char *content = malloc(capacity);
+    if (!content || lseek(fd, 0, SEEK_SET) < 0)
+    {
+        free(content);
+        return NULL;
+    }
+
+    for (;;)
+    {
+        if (len + 1 >= capacity)
+        {
+            char *grown = realloc(content, capacity * 2);
+            if (!grown)
+            {
+                free(content);
+                return NULL;
+            }
+            content = grown;
+            capacity *= 2;
+        }
+
+        ssize_t n = read(fd, content + len, capacity - len - 1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            free(content);
+            return NULL;
+        }
+        if (n == 0)
+            break;
+        len += (size_t)n;
+    }
+
+    content[len] = '\0';
+    return content;
+}
+
+// Lê e indexa o mountinfo. Chamado com o lock de escrita.
+static bool LibSpecialDriveMountIndexBuild(void)
+{
+    if (mountIndex.fd < 0)
+    {
+        mountIndex.fd = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+        if (mountIndex.fd < 0)
+            return false;
+    }
+
+    char *content = LibSpecialDriveMountReadAll(mountIndex.fd);
+    if (!content)
+        return false;
+
+    size_t lines = 0;
+    for (char *c = content; *c; c++)
+        lines += *c == '\n';
+
+    LibSpecialDrive_MountEntry *byDev = calloc(lines + 1, sizeof(*byDev));
+    LibSpecialDrive_MountEntry *bySource = calloc(lines + 1, sizeof(*bySource));
+    if (!byDev || !bySource)
+    {
+        free(byDev);
+        free(bySource);
+        free(content);
+        return false;
+    }
+
+    size_t count = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(content, "\n", &save); line; line = strtok_r(NULL, "\n", &save))
+    {
+        // id pai maj:min raiz ponto opções [opcionais...] - tipo origem opções
+        char *fields[6] = {0};
+        char *fieldSave = NULL;
+        char *field = strtok_r(line, " ", &fieldSave);
+        for (int i = 0; field && i < 5; i++, field = strtok_r(NULL, " ", &fieldSave))
+            fields[i] = field;
+
+        while (field && strcmp(field, "-") != 0)
+            field = strtok_r(NULL, " ", &fieldSave);
+        if (!field || !fields[4])
+            continue;
+
+        strtok_r(NULL, " ", &fieldSave); // tipo
+        fields[5] = strtok_r(NULL, " ", &fieldSave);
+
+        unsigned int major, minor;
+        if (!fields[5] || sscanf(fields[2], "%u:%u", &major, &minor) != 2)
+            continue;
+
+        LibSpecialDriveMountUnescape(fields[4]);
+        LibSpecialDriveMountUnescape(fields[5]);
+
+        LibSpecialDrive_MountEntry *entry = &byDev[count];
+        entry->order = count++;
+        entry->dev = makedev(major, minor);
+        entry->source = fields[5];
+        entry->mountPoint = fields[4];
+        entry->rootMount = strcmp(fields[3], "/") == 0;
+    }
+
+    memcpy(bySource, byDev, count * sizeof(*byDev));
+    qsort(byDev, count, sizeof(*byDev), LibSpecialDriveMountCompareDev);
+    qsort(bySource, count, sizeof(*bySource), LibSpecialDriveMountCompareSource);
+
+    free(mountIndex.content);
+    free(mountIndex.byDev);
+    free(mountIndex.bySource);
+    mountIndex.content = content;
+    mountIndex.byDev = byDev;
+    mountIndex.bySource = bySource;
+    mountIndex.count = count;
+    mountIndex.valid = true;
+    return true;
+}
+
+// Revalida o índice com um poll sem espera: o kernel sinaliza POLLPRI no
+// mountinfo quando a tabela muda. Retorna true se o índice foi refeito.
+bool LibSpecialDriveMountTableRefresh(void)
+{
+    pthread_rwlock_wrlock(&mountIndex.lock);
+
+    bool changed = !mountIndex.valid;
+    if (!changed)
+    {
+        struct pollfd pfd = {mountIndex.fd, POLLPRI, 0};
+        changed = poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLPRI | POLLERR));
+    }
+
+    if (changed && !LibSpecialDriveMountIndexBuild())
+    {
+        mountIndex.valid = false;
+        changed = false;
+    }
+
+    pthread_rwlock_unlock(&mountIndex.lock);
+    return changed;
+}
+
+int LibSpecialDriveMountTableGetFd(void)
+{
+    LibSpecialDriveMountTableRefresh();
+    return mountIndex.fd;
+}
+
+// Busca binária do primeiro elemento igual (raízes vêm antes de binds)
+static const LibSpecialDrive_MountEntry *LibSpecialDriveMountFind(const LibSpecialDrive_MountEntry *entries, const LibSpecialDrive_MountEntry *key, int (*compare)(const LibSpecialDrive_MountEntry *, const LibSpecialDrive_MountEntry *))
+{
+    size_t lo = 0, hi = mountIndex.count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (compare(&entries[mid], key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo < mountIndex.count && compare(&entries[lo], key) == 0) ? &entries[lo] : NULL;
+}
+
+static int LibSpecialDriveMountKeyDev(const LibSpecialDrive_MountEntry *a, const LibSpecialDrive_MountEntry *b)
+{
+    return a->dev == b->dev ? 0 : (a->dev < b->dev ? -1 : 1);
+}
+
+static int LibSpecialDriveMountKeySource(const LibSpecialDrive_MountEntry *a, const LibSpecialDrive_MountEntry *b)
+{
+    return strcmp(a->source, b->source);
+}
+
+void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
 {
     (void)type;
     if (!part || !part->path)
         return;
 
-    FILE *fp = setmntent("/etc/mtab", "r");
-    if (!fp)
-        return;
+    pthread_rwlock_rdlock(&mountIndex.lock);
+    if (!mountIndex.valid)
+    {
+        pthread_rwlock_unlock(&mountIndex.lock);
+        LibSpecialDriveMountTableRefresh();
+        pthread_rwlock_rdlock(&mountIndex.lock);
+    }
 
-    struct mntent *mnt;
-    while ((mnt = getmntent(fp)) != NULL)
+    // Pelo número do dispositivo pega também aliases (/dev/mapper, by-uuid);
+    // pelo nome de origem cobre sistemas com dev anônimo (ex.: btrfs)
+    const LibSpecialDrive_MountEntry *entry = NULL;
+    struct stat st;
+    if (stat(part->path, &st) == 0 && S_ISBLK(st.st_mode))
     {
-        if (strcmp(mnt->mnt_fsname, part->path) == 0)
-        {
-            part->mountPoint = strdup(mnt->mnt_dir);
-            break;
-        }
+        LibSpecialDrive_MountEntry key = {st.st_rdev, NULL, NULL, false, 0};
+        entry = LibSpecialDriveMountFind(mountIndex.byDev, &key, LibSpecialDriveMountKeyDev);
+    }
+    if (!entry)
+    {
+        LibSpecialDrive_MountEntry key = {0, part->path, NULL, false, 0};
+        entry = LibSpecialDriveMountFind(mountIndex.bySource, &key, LibSpecialDriveMountKeySource);
     }
 
-    endmntent(fp);
+    if (entry)
+        part->mountPoint = LibSpecialDriveArenaStrdup(arena, entry->mountPoint);
+
+    pthread_rwlock_unlock(&mountIndex.lock);
+}
+
+// O valor anterior fica na arena antiga até ela ser liberada
+void LibSpecialDrivePartitionRefreshMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    if (!part)
+        return;
+
+    part->mountPoint = NULL;
+    LibSpecialDrivePartitionGetPathMount(part, type, arena);
 }
 
 bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
@@ -96,29 +464,191 @@ bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialD
     return true;
 }
 
+void LibSpecialDriveDevIdSplit(uint64_t devId, uint32_t *major, uint32_t *minor)
+{
+    *major = major((dev_t)devId);
+    *minor = minor((dev_t)devId);
+}
+
+// Consulta removable e ro no sysfs pelo número do dispositivo aberto;
+// arquivos comuns (imagens) não são removíveis
 bool LibSpecialDriveLookUpIsRemovable(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
 {
-    (void)device;
-    (void)blk;
-    return true; // Pode ser melhorado com verificação real via udev/sysfs
+    struct stat st;
+    if (!blk || fstat(device, &st) != 0 || !S_ISBLK(st.st_mode))
+        return false;
+
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "/sys/dev/block/%u:%u", major(st.st_rdev), minor(st.st_rdev));
+
+    uint64_t value = 0;
+    if (LibSpecialDriveSysfsReadU64(dir, "ro", &value) && value)
+        blk->flags |= BLOCK_FLAG_IS_READ_ONLY;
+
+    if (!LibSpecialDriveSysfsReadU64(dir, "removable", &value) || !value)
+        return false;
+
+    blk->flags |= BLOCK_FLAG_IS_REMOVABLE;
+    return true;
+}
+
+// mtime do nó em ns, sem abrir o dispositivo: escritas pelo nó o atualizam
+static uint64_t LibSpecialDriveNodeStamp(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return 0;
+    return (uint64_t)st.st_mtim.tv_sec * 1000000000u + (uint64_t)st.st_mtim.tv_nsec;
 }
 
-LibSpecialDrive *LibSpecialDriveGet(void)
+// diskseq é incrementado pelo kernel a cada troca de mídia (Linux 5.15+)
+static uint64_t LibSpecialDriveLookUpDiskSeq(const char *name)
 {
-    LibSpecialDrive *ctx = calloc(1, sizeof(LibSpecialDrive));
-    if (!ctx)
-        return NULL;
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), LIBSPECIAL_SYSFS_BLOCK "/%s", name);
 
+    uint64_t seq = 0;
+    if (!LibSpecialDriveSysfsReadU64(dir, "diskseq", &seq))
+        return 0;
+    return seq;
+}
+
+// --- Descoberta pelo sysfs ---
+
+typedef struct
+{
+    dev_t dev;
+    char name[NAME_MAX + 1];
+} LibSpecialDrive_SysfsDisk;
+
+static int LibSpecialDriveSysfsCompareDisk(const void *a, const void *b)
+{
+    const LibSpecialDrive_SysfsDisk *x = a, *y = b;
+    if (major(x->dev) != major(y->dev))
+        return major(x->dev) < major(y->dev) ? -1 : 1;
+    if (minor(x->dev) != minor(y->dev))
+        return minor(x->dev) < minor(y->dev) ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// Monta o candidato só com atributos do sysfs: nenhum dispositivo é aberto
+// (nem acordado) antes da leitura do MBR
+static bool LibSpecialDriveSysfsCandidate(const LibSpecialDrive_SysfsDisk *disk, LibSpecialDrive_DiscoverCallback callback, void *user)
+{
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), LIBSPECIAL_SYSFS_BLOCK "/%s", disk->name);
+
+    // "size" é sempre em setores de 512 bytes, qualquer que seja o LBA
+    uint64_t sectors = 0, lbaSize = 0, value = 0;
+    if (!LibSpecialDriveSysfsReadU64(dir, "size", &sectors) || sectors == 0)
+        return true; // sem mídia (leitor vazio, loop livre)
+
+    LibSpecialDrive_Candidate cand = {0};
+    cand.devId = (uint64_t)disk->dev;
+    cand.diskSeq = LibSpecialDriveLookUpDiskSeq(disk->name);
+    cand.size = sectors * 512;
+    if (LibSpecialDriveSysfsReadU64(dir, "queue/logical_block_size", &lbaSize) && lbaSize <= UINT32_MAX)
+        cand.lbaSize = (uint32_t)lbaSize;
+
+    if (LibSpecialDriveSysfsReadU64(dir, "removable", &value) && value)
+        cand.flags |= BLOCK_FLAG_IS_REMOVABLE;
+    if (LibSpecialDriveSysfsReadU64(dir, "ro", &value) && value)
+        cand.flags |= BLOCK_FLAG_IS_READ_ONLY;
+    cand.flagsKnown = true;
+    cand.identity = LibSpecialDriveSysfsIdentity(dir);
+
+    char name[NAME_MAX + 1];
+    snprintf(name, sizeof(name), "%s", disk->name);
+    LibSpecialDriveSysfsName(name, '!', '/');
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "/dev/%s", name);
+    cand.path = path;
+    cand.stamp = LibSpecialDriveNodeStamp(path);
+
+    return callback(&cand, user);
+}
+
+// Discos inteiros são as entradas de /sys/class/block sem o atributo
+// "partition", então nvme0n1 e mmcblk0 não se confundem com partições.
+// *available fica false quando o sysfs não está montado.
+static bool LibSpecialDriveDiscoverSysfs(LibSpecialDrive_DiscoverCallback callback, void *user, bool *available)
+{
+    DIR *dir = opendir(LIBSPECIAL_SYSFS_BLOCK);
+    *available = dir != NULL;
+    if (!dir)
+        return false;
+
+    LibSpecialDrive_SysfsDisk *disks = NULL;
+    size_t count = 0, capacity = 0;
+    bool ok = true;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)))
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        char attr[PATH_MAX];
+        snprintf(attr, sizeof(attr), "%s/partition", entry->d_name);
+        if (faccessat(dirfd(dir), attr, F_OK, 0) == 0)
+            continue; // pular partições
+
+        char dev[32], hidden[8];
+        snprintf(attr, sizeof(attr), LIBSPECIAL_SYSFS_BLOCK "/%s", entry->d_name);
+        if (LibSpecialDriveSysfsRead(attr, "hidden", hidden, sizeof(hidden)) && strcmp(hidden, "1") == 0)
+            continue; // caminho oculto de multipath NVMe, ausente de /proc/partitions
+
+        unsigned int devMajor, devMinor;
+        if (!LibSpecialDriveSysfsRead(attr, "dev", dev, sizeof(dev)) || sscanf(dev, "%u:%u", &devMajor, &devMinor) != 2)
+            continue;
+
+        if (count == capacity)
+        {
+            size_t grown = capacity ? capacity * 2 : 32;
+            LibSpecialDrive_SysfsDisk *items = realloc(disks, grown * sizeof(*items));
+            if (!items)
+            {
+                ok = false;
+                break;
+            }
+            disks = items;
+            capacity = grown;
+        }
+
+        disks[count].dev = makedev(devMajor, devMinor);
+        snprintf(disks[count].name, sizeof(disks[count].name), "%s", entry->d_name);
+        count++;
+    }
+    closedir(dir);
+
+    // Mesma ordem de /proc/partitions (major, minor), não a do readdir
+    if (ok && count > 1)
+        qsort(disks, count, sizeof(*disks), LibSpecialDriveSysfsCompareDisk);
+
+    for (size_t i = 0; ok && i < count; i++)
+        ok = LibSpecialDriveSysfsCandidate(&disks[i], callback, user);
+
+    free(disks);
+    return ok;
+}
+
+// --- Descoberta legada (/proc/partitions) ---
+
+// Nomes terminados em dígito são tratados como partições, o que também
+// descarta nvme0n1 e mmcblk0; os tamanhos ficam para o ioctl
+static bool LibSpecialDriveDiscoverProcPartitions(LibSpecialDrive_DiscoverCallback callback, void *user)
+{
     FILE *fp = fopen("/proc/partitions", "r");
     if (!fp)
     {
         perror("fopen");
-        free(ctx);
-        return NULL;
+        return false;
     }
 
+    bool ok = true;
     char line[256];
-    while (fgets(line, sizeof(line), fp))
+    while (ok && fgets(line, sizeof(line), fp))
     {
         unsigned int major, minor;
         unsigned long long blocks;
@@ -135,15 +665,125 @@ LibSpecialDrive *LibSpecialDriveGet(void)
         char path[PATH_MAX];
         snprintf(path, sizeof(path), "/dev/%s", name);
 
-        LibSpecialDrive_BlockDevice *blk = LibSpecialDriveGetBlock(path);
-        if (!blk)
+        LibSpecialDrive_Candidate cand = {path, 0, (uint64_t)makedev(major, minor), LibSpecialDriveLookUpDiskSeq(name), 0, 0, false, 0, NULL,
+                                          LibSpecialDriveNodeStamp(path)};
+        ok = callback(&cand, user);
+    }
+
+    fclose(fp);
+    return ok;
+}
+
+bool LibSpecialDriveDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user)
+{
+    if (!callback)
+        return false;
+
+    if (!options || !(options->flags & LIBSPECIAL_OPT_PROC_PARTITIONS))
+    {
+        bool available;
+        bool ok = LibSpecialDriveDiscoverSysfs(callback, user, &available);
+        if (available)
+            return ok;
+    }
+
+    return LibSpecialDriveDiscoverProcPartitions(callback, user);
+}
+
+// --- Fonte de eventos netlink (NETLINK_KOBJECT_UEVENT) ---
+
+static int LibSpecialDriveNetlinkGetFd(void *user)
+{
+    return (int)(intptr_t)user;
+}
+
+static void LibSpecialDriveNetlinkCopy(char *target, size_t size, const char *value)
+{
+    snprintf(target, size, "%s", value);
+}
+
+static int LibSpecialDriveNetlinkNext(void *user, LibSpecialDrive_UEvent *event)
+{
+    int fd = (int)(intptr_t)user;
+    char buffer[8192];
+
+    for (;;)
+    {
+        ssize_t len = recv(fd, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // ENOBUFS: o kernel descartou eventos, o chamador deve recarregar tudo
+            return errno == ENOBUFS ? -1 : 0;
+        }
+        buffer[len] = '\0';
+
+        // Ignora mensagens do udevd ("libudev" + cabeçalho binário)
+        if (strchr(buffer, '@') == NULL)
             continue;
 
-        LibSpecialDriveBlockAppend(ctx, &blk);
+        memset(event, 0, sizeof(*event));
+        bool isBlock = false;
+
+        for (char *field = buffer + strlen(buffer) + 1; field < buffer + len; field += strlen(field) + 1)
+        {
+            if (strncmp(field, "ACTION=", 7) == 0)
+                LibSpecialDriveNetlinkCopy(event->action, sizeof(event->action), field + 7);
+            else if (strncmp(field, "DEVNAME=", 8) == 0)
+                LibSpecialDriveNetlinkCopy(event->devName, sizeof(event->devName), field + 8);
+            else if (strncmp(field, "DEVTYPE=", 8) == 0)
+                LibSpecialDriveNetlinkCopy(event->devType, sizeof(event->devType), field + 8);
+            else if (strncmp(field, "DEVPATH=", 8) == 0)
+                LibSpecialDriveNetlinkCopy(event->devPath, sizeof(event->devPath), field + 8);
+            else if (strcmp(field, "SUBSYSTEM=block") == 0)
+                isBlock = true;
+        }
+
+        if (isBlock)
+            return 1;
     }
+}
 
-    fclose(fp);
-    return ctx;
+static void LibSpecialDriveNetlinkClose(void *user)
+{
+    close((int)(intptr_t)user);
+}
+
+bool LibSpecialDriveEventSourceNetlink(LibSpecialDrive_EventSource *source)
+{
+    if (!source)
+        return false;
+
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0)
+    {
+        perror("socket(NETLINK_KOBJECT_UEVENT)");
+        return false;
+    }
+
+    // Buffer grande para absorver rajadas (ex.: gaveta de 24 discos)
+    int rcvbuf = 4 * 1024 * 1024;
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) < 0)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl addr = {0};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1; // eventos do kernel
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind(NETLINK_KOBJECT_UEVENT)");
+        close(fd);
+        return false;
+    }
+
+    source->user = (void *)(intptr_t)fd;
+    source->getFd = LibSpecialDriveNetlinkGetFd;
+    source->next = LibSpecialDriveNetlinkNext;
+    source->close = LibSpecialDriveNetlinkClose;
+    source->devDirectory = NULL;
+    return true;
 }
 
 LibSpecialDrive_DeviceHandle LibSpecialDriveOpenDevice(const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags)
@@ -191,6 +831,58 @@ int64_t LibSpecialDriveRead(LibSpecialDrive_DeviceHandle device, int64_t len, ui
     return (int64_t)bytesRead;
 }
 
+// Leitura posicional: não depende nem altera o offset do descritor
+int64_t LibSpecialDriveReadAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target)
+{
+    int64_t total = 0;
+    while (total < len)
+    {
+        ssize_t bytesRead = pread(device, target + total, (size_t)(len - total), (off_t)(offset + total));
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("pread");
+            return -1;
+        }
+        if (bytesRead == 0)
+            break;
+        total += bytesRead;
+    }
+    return total;
+}
+
+int64_t LibSpecialDriveWriteAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source)
+{
+    int64_t total = 0;
+    while (total < len)
+    {
+        ssize_t bytesWritten = pwrite(device, source + total, (size_t)(len - total), (off_t)(offset + total));
+        if (bytesWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("pwrite");
+            return -1;
+        }
+        if (bytesWritten == 0)
+            break;
+        total += bytesWritten;
+    }
+    return total;
+}
+
+// Garante que as escritas chegaram ao dispositivo
+bool LibSpecialDriveFlush(LibSpecialDrive_DeviceHandle device)
+{
+    if (fsync(device) != 0)
+    {
+        perror("fsync");
+        return false;
+    }
+    return true;
+}
+
 int64_t LibSpecialDriveWrite(LibSpecialDrive_DeviceHandle device, int64_t len, const uint8_t *source)
 {
     ssize_t bytesWritten = write(device, source, (size_t)len);
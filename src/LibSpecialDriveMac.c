@@ -11,40 +11,38 @@
 #include <sys/disk.h>
 #include <sys/mount.h>
 #include <sys/statvfs.h>
+#include <sys/stat.h>
 #include <IOKit/IOKitLib.h>
 #include <IOKit/storage/IOMedia.h>
 #include <CoreFoundation/CoreFoundation.h>
 #include <LibSpecialDrive.h>
 
-void LibSpecialDriveDiretoryFreeSpaceLookup(LibSpecialDrive_Partition *part)
+bool LibSpecialDriveDiretoryFreeSpaceLookup(const char *directory, uint64_t *freeSpace)
 {
-    if (!part && !part->mountPoint)
-        return;
-    struct statvfs stat;
+    if (!directory || !freeSpace)
+        return false;
 
-    if (statvfs(part->mountPoint, &stat) != 0)
-    {
-        part->freeSpace = 0;
-        return;
-    }
+    struct statvfs stat;
+    if (statvfs(directory, &stat) != 0)
+        return false;
 
-    unsigned long block_size = stat.f_frsize;
-    part->freeSpace = stat.f_bavail * block_size;
+    *freeSpace = (uint64_t)stat.f_bavail * (uint64_t)stat.f_frsize;
+    return true;
 }
 
 // Cria caminho para uma partição: ex. "/dev/disk2" + 1 => "/dev/disk2s1"
-char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber)
+char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber, LibSpecialDrive_Arena *arena)
 {
     if (!path || partitionNumber < 0)
         return NULL;
 
     char partitionPath[PATH_MAX];
     snprintf(partitionPath, sizeof(partitionPath), "%ss%d", path, partitionNumber + 1);
-    return strdup(partitionPath);
+    return LibSpecialDriveArenaStrdup(arena, partitionPath);
 }
 
 // Obtém o ponto de montagem da partição, se houver
-void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type)
+void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
 {
     (void)type;
     if (!part || !part->path)
@@ -62,12 +60,32 @@ void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum
     {
         if (strcmp(mounts[i].f_mntfromname, part->path) == 0)
         {
-            part->mountPoint = strdup(mounts[i].f_mntonname);
+            part->mountPoint = LibSpecialDriveArenaStrdup(arena, mounts[i].f_mntonname);
             return;
         }
     }
 }
 
+void LibSpecialDrivePartitionRefreshMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    if (!part)
+        return;
+
+    part->mountPoint = NULL;
+    LibSpecialDrivePartitionGetPathMount(part, type, arena);
+}
+
+// getmntinfo já é consultado a cada busca; não há índice a revalidar
+bool LibSpecialDriveMountTableRefresh(void)
+{
+    return true;
+}
+
+int LibSpecialDriveMountTableGetFd(void)
+{
+    return -1;
+}
+
 // Obtém tamanho do dispositivo em bytes e tamanho do setor lógico
 bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
 {
@@ -92,6 +110,12 @@ bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialD
     return true;
 }
 
+void LibSpecialDriveDevIdSplit(uint64_t devId, uint32_t *major, uint32_t *minor)
+{
+    *major = (uint32_t)major((dev_t)devId);
+    *minor = (uint32_t)minor((dev_t)devId);
+}
+
 // Placeholder, assume que dispositivos são removíveis (implementação real é externa)
 bool LibSpecialDriveLookUpIsRemovable(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
 {
@@ -173,7 +197,58 @@ int64_t LibSpecialDriveRead(LibSpecialDrive_DeviceHandle device, int64_t len, ui
     return (int64_t)bytesRead;
 }
 
+// Leitura posicional: não depende nem altera o offset do descritor
+int64_t LibSpecialDriveReadAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target)
+{
+    int64_t total = 0;
+    while (total < len)
+    {
+        ssize_t bytesRead = pread(device, target + total, (size_t)(len - total), (off_t)(offset + total));
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("pread");
+            return -1;
+        }
+        if (bytesRead == 0)
+            break;
+        total += bytesRead;
+    }
+    return total;
+}
+
 // Escreve bytes do buffer para o dispositivo
+int64_t LibSpecialDriveWriteAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source)
+{
+    int64_t total = 0;
+    while (total < len)
+    {
+        ssize_t bytesWritten = pwrite(device, source + total, (size_t)(len - total), (off_t)(offset + total));
+        if (bytesWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("pwrite");
+            return -1;
+        }
+        if (bytesWritten == 0)
+            break;
+        total += bytesWritten;
+    }
+    return total;
+}
+
+// F_FULLFSYNC pede ao disco que esvazie o próprio cache; fsync não garante
+bool LibSpecialDriveFlush(LibSpecialDrive_DeviceHandle device)
+{
+    if (fcntl(device, F_FULLFSYNC) == 0 || fsync(device) == 0)
+        return true;
+
+    perror("fsync");
+    return false;
+}
+
 int64_t LibSpecialDriveWrite(LibSpecialDrive_DeviceHandle device, int64_t len, const uint8_t *source)
 {
     ssize_t bytesWritten = write(device, source, (size_t)len);
@@ -193,13 +268,17 @@ void LibSpecialDriveCloseDevice(LibSpecialDrive_DeviceHandle device)
 }
 
 // Itera pelos dispositivos IOMedia e coleta os que são "whole" (inteiros)
-LibSpecialDrive *LibSpecialDriveGet(void)
+bool LibSpecialDriveDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user)
 {
+    (void)options;
+    if (!callback)
+        return false;
+
     CFMutableDictionaryRef matchingDict = IOServiceMatching(kIOMediaClass);
     if (!matchingDict)
     {
         fprintf(stderr, "IOServiceMatching failed\n");
-        return NULL;
+        return false;
     }
 
     CFDictionarySetValue(matchingDict, CFSTR(kIOMediaWholeKey), kCFBooleanTrue);
@@ -208,13 +287,13 @@ LibSpecialDrive *LibSpecialDriveGet(void)
     if (IOServiceGetMatchingServices(kIOMainPortDefault, matchingDict, &iterator) != KERN_SUCCESS)
     {
         fprintf(stderr, "IOServiceGetMatchingServices failed\n");
-        return NULL;
+        return false;
     }
 
-    LibSpecialDrive *ctx = NULL;
+    bool ok = true;
     io_object_t media;
 
-    while ((media = IOIteratorNext(iterator)))
+    while (ok && (media = IOIteratorNext(iterator)))
     {
         CFStringRef bsdName = IORegistryEntryCreateCFProperty(media, CFSTR("BSD Name"), kCFAllocatorDefault, 0);
         if (bsdName)
@@ -226,28 +305,66 @@ LibSpecialDrive *LibSpecialDriveGet(void)
             snprintf(path, sizeof(path), "/dev/%s", name);
             CFRelease(bsdName);
 
-            LibSpecialDrive_BlockDevice *blk = LibSpecialDriveGetBlock(path);
-            if (blk)
+            LibSpecialDrive_Candidate cand = {path, 0, 0, 0, 0, 0, true, 0, NULL, 0};
+
+            struct stat st;
+            if (stat(path, &st) == 0)
+            {
+                cand.devId = (uint64_t)st.st_rdev;
+                cand.stamp = (uint64_t)st.st_mtimespec.tv_sec * 1000000000u + (uint64_t)st.st_mtimespec.tv_nsec;
+            }
+
+            CFBooleanRef removable = IORegistryEntryCreateCFProperty(media, CFSTR(kIOMediaRemovableKey), kCFAllocatorDefault, 0);
+            if (removable)
             {
-                if (!ctx)
-                    ctx = calloc(1, sizeof(LibSpecialDrive));
+                if (CFBooleanGetValue(removable))
+                    cand.flags |= BLOCK_FLAG_IS_REMOVABLE;
+                CFRelease(removable);
+            }
 
-                CFBooleanRef removable = IORegistryEntryCreateCFProperty(media, CFSTR("Removable"), kCFAllocatorDefault, 0);
-                if (removable && CFBooleanGetValue(removable))
-                {
-                    blk->flags |= BLOCK_FLAG_IS_REMOVABLE;
-                    CFRelease(removable);
-                }
+            CFBooleanRef writable = IORegistryEntryCreateCFProperty(media, CFSTR(kIOMediaWritableKey), kCFAllocatorDefault, 0);
+            if (writable)
+            {
+                if (!CFBooleanGetValue(writable))
+                    cand.flags |= BLOCK_FLAG_IS_READ_ONLY;
+                CFRelease(writable);
+            }
 
-                LibSpecialDriveBlockAppend(ctx, &blk);
+            // Tamanhos do registro do IOKit, sem abrir o disco
+            int64_t size = 0, blockSize = 0;
+            CFNumberRef number = IORegistryEntryCreateCFProperty(media, CFSTR(kIOMediaSizeKey), kCFAllocatorDefault, 0);
+            if (number)
+            {
+                CFNumberGetValue(number, kCFNumberSInt64Type, &size);
+                CFRelease(number);
             }
+            number = IORegistryEntryCreateCFProperty(media, CFSTR(kIOMediaPreferredBlockSizeKey), kCFAllocatorDefault, 0);
+            if (number)
+            {
+                CFNumberGetValue(number, kCFNumberSInt64Type, &blockSize);
+                CFRelease(number);
+            }
+            if (size > 0 && blockSize > 0 && blockSize <= UINT32_MAX)
+            {
+                cand.size = (uint64_t)size;
+                cand.lbaSize = (uint32_t)blockSize;
+            }
+
+            ok = callback(&cand, user);
         }
         IOObjectRelease(media);
     }
 
     IOObjectRelease(iterator);
-    return ctx;
+    return ok;
+}
+// Sem NETLINK_KOBJECT_UEVENT nesta plataforma: use uma fonte própria
+bool LibSpecialDriveEventSourceNetlink(LibSpecialDrive_EventSource *source)
+{
+    (void)source;
+    return false;
 }
+
 #else
 #define LIBSPECIALDRIVEMAC_C_EMPTY
 void LibSpecialDriveMAC_dummy(void) {}
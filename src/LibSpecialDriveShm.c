@@ -0,0 +1,653 @@
+#include <LibSpecialDrive.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --- Publicação entre processos em memória compartilhada ---
+
+// Um único processo por máquina sonda os discos e publica o resultado em
+// memória compartilhada. O conteúdo é a imagem plana do cache persistente,
+// sem ponteiros, protegida por um seqlock: o publicador deixa a sequência
+// ímpar durante a escrita e par ao terminar; o leitor copia a imagem e
+// confere se a sequência não mudou. Sem mudança desde a última leitura, o
+// leitor devolve o contexto que já tem, sem chamadas de sistema nem E/S de
+// dispositivo.
+//
+// São dois objetos nomeados (shm_open, ou mapeamento nomeado no Windows):
+// o de controle, em name, diz qual segmento de dados está em uso; o de
+// dados, em name.N, guarda a imagem. Um segmento de dados nasce do tamanho
+// da primeira imagem com folga e nunca é redimensionado, então leitores já
+// mapeados seguem válidos. Quando uma imagem não cabe, o publicador cria
+// name.N+1 maior, escreve nele e só então troca o número no controle; o
+// leitor confere o número a cada leitura e remapeia quando ele muda. Os
+// objetos sobrevivem ao publicador: um publicador novo reaproveita o
+// segmento atual e leitores abertos continuam lendo.
+
+#define LIBSPECIAL_SHM_MAGIC "LSDSHM\0"
+#define LIBSPECIAL_SHM_DATA_MAGIC "LSDSHMD"
+#define LIBSPECIAL_SHM_VERSION 2
+#define LIBSPECIAL_SHM_READ_RETRIES 1000
+#define LIBSPECIAL_SHM_MIN_CAPACITY 4096
+#define LIBSPECIAL_SHM_CREATE_ATTEMPTS 16
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    volatile uint64_t segment; // segmento de dados atual (0 = nada publicado)
+} LibSpecialDrive_ShmControl;
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t capacity;          // bytes de dados após o cabeçalho
+    volatile uint64_t sequence; // ímpar durante a escrita; 0 = nada publicado
+    uint64_t length;            // bytes válidos da imagem
+    uint64_t generation;        // publicações concluídas, somando os segmentos anteriores
+} LibSpecialDrive_ShmHeader;
+
+// Um objeto nomeado mapeado
+typedef struct
+{
+    uint8_t *base;
+    size_t size;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+} LibSpecialDrive_ShmMap;
+
+struct LibSpecialDrive_ShmPublisher
+{
+    char name[256];
+    LibSpecialDrive_ShmMap controlMap;
+    LibSpecialDrive_ShmControl *control;
+    LibSpecialDrive_ShmMap dataMap;    // vazio até a primeira publicação
+    LibSpecialDrive_ShmHeader *header; // do segmento de dados mapeado
+    uint64_t segment;                  // número do último segmento de dados
+    size_t capacity;                   // pedida na criação (0 = pela primeira imagem)
+#ifdef _WIN32
+    HANDLE lock; // mutex nomeado: um publicador por segmento
+#else
+    int fd; // controle; mantém o flock exclusivo
+#endif
+};
+
+struct LibSpecialDrive_ShmReader
+{
+    char name[256];
+    LibSpecialDrive_ShmMap controlMap;
+    const LibSpecialDrive_ShmControl *control;
+    LibSpecialDrive_ShmMap dataMap;          // vazio até a primeira leitura publicada
+    const LibSpecialDrive_ShmHeader *header; // do segmento de dados mapeado
+    uint64_t segment;                        // número do segmento de dados mapeado
+    size_t capacity;
+    uint8_t *copy;       // imagem consistente da última leitura
+    uint64_t sequence;   // do contexto atual (0 = nenhum)
+    uint64_t generation; // publicação do contexto atual
+    LibSpecialDrive *view;
+};
+
+static uint64_t LibSpecialDriveShmLoad(const volatile uint64_t *value)
+{
+#ifdef _WIN32
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)(uintptr_t)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static void LibSpecialDriveShmStore(volatile uint64_t *value, uint64_t next)
+{
+#ifdef _WIN32
+    InterlockedExchange64((volatile LONG64 *)value, (LONG64)next);
+#else
+    __atomic_store_n(value, next, __ATOMIC_RELEASE);
+#endif
+}
+
+// Ordena as escritas da imagem depois da sequência ímpar (publicador) e as
+// leituras da imagem antes da nova conferência da sequência (leitor)
+static void LibSpecialDriveShmFence(void)
+{
+#ifdef _WIN32
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+static void LibSpecialDriveShmYield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// shm_open exige a barra inicial; no Windows o nome vai para o namespace
+// da sessão
+static bool LibSpecialDriveShmName(const char *name, const char *suffix, char *out, size_t size)
+{
+    if (!name || !*name)
+        return false;
+#ifdef _WIN32
+    int written = snprintf(out, size, "Local\\%s%s", name + (name[0] == '/'), suffix);
+#else
+    int written = snprintf(out, size, "%s%s%s", name[0] == '/' ? "" : "/", name, suffix);
+#endif
+    return written > 0 && (size_t)written < size;
+}
+
+static bool LibSpecialDriveShmDataName(const char *name, uint64_t segment, char *out, size_t size)
+{
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%llu", (unsigned long long)segment);
+    return LibSpecialDriveShmName(name, suffix, out, size);
+}
+
+// Mapeia um objeto existente com o tamanho que ele tem
+static bool LibSpecialDriveShmMapOpen(const char *shmName, bool writable, LibSpecialDrive_ShmMap *map)
+{
+    memset(map, 0, sizeof(*map));
+#ifdef _WIN32
+    DWORD access = writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ;
+    map->mapping = OpenFileMappingA(access, FALSE, shmName);
+    map->base = map->mapping ? MapViewOfFile(map->mapping, access, 0, 0, 0) : NULL;
+    MEMORY_BASIC_INFORMATION info;
+    if (!map->base || !VirtualQuery(map->base, &info, sizeof(info)))
+    {
+        if (map->base)
+            UnmapViewOfFile(map->base);
+        if (map->mapping)
+            CloseHandle(map->mapping);
+        memset(map, 0, sizeof(*map));
+        return false;
+    }
+    map->size = info.RegionSize;
+#else
+    int fd = shm_open(shmName, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        base = mmap(NULL, (size_t)st.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+    map->base = base;
+    map->size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+// Cria e mapeia um objeto novo de size bytes. Uma sobra com o mesmo nome
+// (publicador interrompido antes de anunciar o número) é substituída no
+// POSIX; no Windows ela ainda está aberta por alguém e o nome é recusado.
+static bool LibSpecialDriveShmMapCreate(const char *shmName, size_t size, LibSpecialDrive_ShmMap *map)
+{
+    memset(map, 0, sizeof(*map));
+#ifdef _WIN32
+    map->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, shmName);
+    if (!map->mapping)
+        return false;
+    if (GetLastError() == ERROR_ALREADY_EXISTS ||
+        (map->base = MapViewOfFile(map->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)) == NULL)
+    {
+        CloseHandle(map->mapping);
+        map->mapping = NULL;
+        return false;
+    }
+#else
+    shm_unlink(shmName);
+    int fd = shm_open(shmName, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    void *base = ftruncate(fd, (off_t)size) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        shm_unlink(shmName);
+        return false;
+    }
+    map->base = base;
+#endif
+    map->size = size;
+    return true;
+}
+
+static void LibSpecialDriveShmUnmap(LibSpecialDrive_ShmMap *map)
+{
+#ifdef _WIN32
+    if (map->base)
+        UnmapViewOfFile(map->base);
+    if (map->mapping)
+        CloseHandle(map->mapping);
+#else
+    if (map->base)
+        munmap(map->base, map->size);
+#endif
+    memset(map, 0, sizeof(*map));
+}
+
+// Cabeçalho do segmento de dados mapeado; NULL se não for um segmento válido
+static LibSpecialDrive_ShmHeader *LibSpecialDriveShmDataHeader(const LibSpecialDrive_ShmMap *map)
+{
+    if (!map->base || map->size < sizeof(LibSpecialDrive_ShmHeader))
+        return NULL;
+
+    LibSpecialDrive_ShmHeader *header = (LibSpecialDrive_ShmHeader *)map->base;
+    if (memcmp(header->magic, LIBSPECIAL_SHM_DATA_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != LIBSPECIAL_SHM_VERSION || header->headerSize != sizeof(LibSpecialDrive_ShmHeader) ||
+        header->capacity > map->size - sizeof(LibSpecialDrive_ShmHeader))
+        return NULL;
+    return header;
+}
+
+static bool LibSpecialDriveShmControlValid(const LibSpecialDrive_ShmMap *map)
+{
+    const LibSpecialDrive_ShmControl *control = (const LibSpecialDrive_ShmControl *)map->base;
+    return map->size >= sizeof(*control) && memcmp(control->magic, LIBSPECIAL_SHM_MAGIC, sizeof(control->magic)) == 0 &&
+           control->version == LIBSPECIAL_SHM_VERSION && control->headerSize == sizeof(*control);
+}
+
+// --- Publicador ---
+
+// Cria (ou reaproveita) o segmento name. capacity é a capacidade do
+// primeiro segmento de dados (0 = tamanho da primeira imagem com folga);
+// imagens maiores fazem um segmento novo. Retorna NULL se outro processo já
+// publica nele.
+LibSpecialDrive_ShmPublisher *LibSpecialDriveShmPublisherCreate(const char *name, size_t capacity)
+{
+    char shmName[256];
+    if (!LibSpecialDriveShmName(name, "", shmName, sizeof(shmName)))
+        return NULL;
+
+    LibSpecialDrive_ShmPublisher *publisher = calloc(1, sizeof(*publisher));
+    if (!publisher)
+        return NULL;
+    publisher->capacity = capacity;
+#ifndef _WIN32
+    publisher->fd = -1;
+#endif
+    int written = snprintf(publisher->name, sizeof(publisher->name), "%s", name);
+    if (written < 0 || (size_t)written >= sizeof(publisher->name))
+        goto error;
+
+#ifdef _WIN32
+    char lockName[256];
+    if (!LibSpecialDriveShmName(name, ".lock", lockName, sizeof(lockName)))
+        goto error;
+
+    publisher->lock = CreateMutexA(NULL, FALSE, lockName);
+    DWORD wait = publisher->lock ? WaitForSingleObject(publisher->lock, 0) : WAIT_FAILED;
+    if (wait != WAIT_OBJECT_0 && wait != WAIT_ABANDONED)
+    {
+        fprintf(stderr, "Segmento %s já tem publicador\n", name);
+        goto error;
+    }
+
+    // Controle existente é aberto com o tamanho que tem
+    publisher->controlMap.mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)sizeof(LibSpecialDrive_ShmControl), shmName);
+    publisher->controlMap.base = publisher->controlMap.mapping ? MapViewOfFile(publisher->controlMap.mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0) : NULL;
+    if (!publisher->controlMap.base)
+        goto error;
+    publisher->controlMap.size = sizeof(LibSpecialDrive_ShmControl);
+#else
+    publisher->fd = shm_open(shmName, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (publisher->fd < 0)
+    {
+        perror("shm_open");
+        goto error;
+    }
+
+    // Sistemas sem flock em shm (ENOTSUP) ficam sem a garantia
+    if (flock(publisher->fd, LOCK_EX | LOCK_NB) != 0 && errno == EWOULDBLOCK)
+    {
+        fprintf(stderr, "Segmento %s já tem publicador\n", name);
+        goto error;
+    }
+
+    struct stat st;
+    if (fstat(publisher->fd, &st) != 0)
+        goto error;
+    if ((size_t)st.st_size < sizeof(LibSpecialDrive_ShmControl) && ftruncate(publisher->fd, sizeof(LibSpecialDrive_ShmControl)) != 0)
+    {
+        perror("ftruncate");
+        goto error;
+    }
+
+    void *base = mmap(NULL, sizeof(LibSpecialDrive_ShmControl), PROT_READ | PROT_WRITE, MAP_SHARED, publisher->fd, 0);
+    if (base == MAP_FAILED)
+        goto error;
+    publisher->controlMap.base = base;
+    publisher->controlMap.size = sizeof(LibSpecialDrive_ShmControl);
+#endif
+
+    LibSpecialDrive_ShmControl *control = (LibSpecialDrive_ShmControl *)publisher->controlMap.base;
+    publisher->control = control;
+    if (!LibSpecialDriveShmControlValid(&publisher->controlMap))
+    {
+        // Controle novo (ou de outra versão): leitores veem "nada publicado"
+        LibSpecialDriveShmStore(&control->segment, 0);
+        control->version = LIBSPECIAL_SHM_VERSION;
+        control->headerSize = sizeof(LibSpecialDrive_ShmControl);
+        LibSpecialDriveShmFence();
+        memcpy(control->magic, LIBSPECIAL_SHM_MAGIC, sizeof(control->magic));
+    }
+
+    // Segmento de dados de um publicador anterior: a contagem continua nele
+    publisher->segment = LibSpecialDriveShmLoad(&control->segment);
+    if (publisher->segment && LibSpecialDriveShmDataName(name, publisher->segment, shmName, sizeof(shmName)) &&
+        LibSpecialDriveShmMapOpen(shmName, true, &publisher->dataMap))
+    {
+        publisher->header = LibSpecialDriveShmDataHeader(&publisher->dataMap);
+        if (!publisher->header)
+            LibSpecialDriveShmUnmap(&publisher->dataMap);
+    }
+    return publisher;
+
+error:
+    LibSpecialDriveShmPublisherDestroy(&publisher);
+    return NULL;
+}
+
+// Cria o próximo segmento de dados com espaço para len bytes e folga, já
+// com o cabeçalho pronto, e o põe no lugar do atual, que fica em retired
+// até o controle apontar para o novo
+static bool LibSpecialDriveShmGrow(LibSpecialDrive_ShmPublisher *publisher, size_t len, LibSpecialDrive_ShmMap *retired)
+{
+    if (len > SIZE_MAX / 2 - sizeof(LibSpecialDrive_ShmHeader))
+        return false;
+
+    const LibSpecialDrive_ShmHeader *current = publisher->header;
+    size_t capacity = current ? (size_t)current->capacity * 2 : publisher->capacity;
+    if (capacity < len + len / 2)
+        capacity = len + len / 2;
+    if (capacity < LIBSPECIAL_SHM_MIN_CAPACITY)
+        capacity = LIBSPECIAL_SHM_MIN_CAPACITY;
+
+    LibSpecialDrive_ShmMap map;
+    uint64_t segment = publisher->segment;
+    bool created = false;
+    for (int attempt = 0; !created && attempt < LIBSPECIAL_SHM_CREATE_ATTEMPTS; attempt++)
+    {
+        char shmName[256];
+        segment++;
+        created = LibSpecialDriveShmDataName(publisher->name, segment, shmName, sizeof(shmName)) &&
+                  LibSpecialDriveShmMapCreate(shmName, sizeof(LibSpecialDrive_ShmHeader) + capacity, &map);
+    }
+    if (!created)
+        return false;
+
+    // Ainda não anunciado: nenhum leitor o vê antes de estar pronto
+    LibSpecialDrive_ShmHeader *header = (LibSpecialDrive_ShmHeader *)map.base;
+    memcpy(header->magic, LIBSPECIAL_SHM_DATA_MAGIC, sizeof(header->magic));
+    header->version = LIBSPECIAL_SHM_VERSION;
+    header->headerSize = sizeof(LibSpecialDrive_ShmHeader);
+    header->capacity = capacity;
+    header->sequence = 0;
+    header->length = 0;
+    header->generation = current ? current->generation : 0;
+
+    *retired = publisher->dataMap;
+    publisher->dataMap = map;
+    publisher->header = header;
+    publisher->segment = segment;
+    return true;
+}
+
+// Escreve o contexto no segmento. Uma imagem maior que a capacidade vai
+// para um segmento de dados novo, anunciado depois de escrito. Retorna
+// false, sem tocar no que os leitores veem, se o segmento novo não puder
+// ser criado.
+bool LibSpecialDriveShmPublish(LibSpecialDrive_ShmPublisher *publisher, const LibSpecialDrive *ctx)
+{
+    if (!publisher || !ctx)
+        return false;
+
+    size_t len;
+    uint8_t *image = LibSpecialDriveCacheSerialize(ctx, &len);
+    if (!image)
+        return false;
+
+    LibSpecialDrive_ShmMap retired = {0};
+    uint64_t retiredSegment = publisher->segment;
+    if ((!publisher->header || len > publisher->header->capacity) && !LibSpecialDriveShmGrow(publisher, len, &retired))
+    {
+        free(image);
+        return false;
+    }
+
+    // Único escritor; uma escrita interrompida (sequência ímpar) é retomada
+    LibSpecialDrive_ShmHeader *header = publisher->header;
+    uint64_t sequence = LibSpecialDriveShmLoad(&header->sequence) | 1;
+    LibSpecialDriveShmStore(&header->sequence, sequence);
+    LibSpecialDriveShmFence();
+
+    memcpy(publisher->dataMap.base + sizeof(LibSpecialDrive_ShmHeader), image, len);
+    header->length = len;
+    header->generation++;
+
+    LibSpecialDriveShmStore(&header->sequence, sequence + 1);
+    free(image);
+
+    // Segmento novo: anunciado já com a imagem, o anterior sai de cena
+    // (leitores que o mapearam seguem com ele até verem o número novo)
+    if (LibSpecialDriveShmLoad(&publisher->control->segment) != publisher->segment)
+    {
+        LibSpecialDriveShmStore(&publisher->control->segment, publisher->segment);
+#ifndef _WIN32
+        char shmName[256];
+        if (retired.base && LibSpecialDriveShmDataName(publisher->name, retiredSegment, shmName, sizeof(shmName)))
+            shm_unlink(shmName);
+#endif
+        LibSpecialDriveShmUnmap(&retired);
+    }
+    return true;
+}
+
+// Solta o segmento sem removê-lo: leitores mantêm a última publicação e o
+// próximo publicador continua de onde este parou
+void LibSpecialDriveShmPublisherDestroy(LibSpecialDrive_ShmPublisher **publisher)
+{
+    if (!publisher || !*publisher)
+        return;
+
+    LibSpecialDrive_ShmPublisher *owned = *publisher;
+    LibSpecialDriveShmUnmap(&owned->dataMap);
+    LibSpecialDriveShmUnmap(&owned->controlMap);
+#ifdef _WIN32
+    if (owned->lock)
+    {
+        ReleaseMutex(owned->lock);
+        CloseHandle(owned->lock);
+    }
+#else
+    if (owned->fd >= 0)
+        close(owned->fd);
+#endif
+    free(owned);
+    *publisher = NULL;
+}
+
+// Remove os nomes do segmento name (controle e dados atuais). Publicador e
+// leitores abertos seguem com o que já mapearam. No Windows os objetos somem
+// sozinhos com o último handle.
+bool LibSpecialDriveShmUnlink(const char *name)
+{
+    char shmName[256];
+    if (!LibSpecialDriveShmName(name, "", shmName, sizeof(shmName)))
+        return false;
+#ifdef _WIN32
+    return true;
+#else
+    LibSpecialDrive_ShmMap control;
+    if (LibSpecialDriveShmMapOpen(shmName, false, &control))
+    {
+        char dataName[256];
+        uint64_t segment = LibSpecialDriveShmControlValid(&control)
+                               ? LibSpecialDriveShmLoad(&((const LibSpecialDrive_ShmControl *)control.base)->segment)
+                               : 0;
+        if (segment && LibSpecialDriveShmDataName(name, segment, dataName, sizeof(dataName)))
+            shm_unlink(dataName);
+        LibSpecialDriveShmUnmap(&control);
+    }
+    return shm_unlink(shmName) == 0;
+#endif
+}
+
+// --- Leitor ---
+
+// Mapeia o segmento name para leitura. Retorna NULL se ele ainda não existe.
+LibSpecialDrive_ShmReader *LibSpecialDriveShmReaderOpen(const char *name)
+{
+    char shmName[256];
+    if (!LibSpecialDriveShmName(name, "", shmName, sizeof(shmName)))
+        return NULL;
+
+    LibSpecialDrive_ShmReader *reader = calloc(1, sizeof(*reader));
+    if (!reader)
+        return NULL;
+
+    int written = snprintf(reader->name, sizeof(reader->name), "%s", name);
+    if (written < 0 || (size_t)written >= sizeof(reader->name) ||
+        !LibSpecialDriveShmMapOpen(shmName, false, &reader->controlMap) ||
+        !LibSpecialDriveShmControlValid(&reader->controlMap))
+    {
+        LibSpecialDriveShmReaderClose(&reader);
+        return NULL;
+    }
+    reader->control = (const LibSpecialDrive_ShmControl *)reader->controlMap.base;
+    return reader;
+}
+
+// Passa a ler o segmento de dados número segment. false, com o mapeamento
+// anterior intacto, se ele já não existir (trocado de novo no meio tempo).
+static bool LibSpecialDriveShmReaderRemap(LibSpecialDrive_ShmReader *reader, uint64_t segment)
+{
+    char shmName[256];
+    LibSpecialDrive_ShmMap map;
+    if (!LibSpecialDriveShmDataName(reader->name, segment, shmName, sizeof(shmName)) ||
+        !LibSpecialDriveShmMapOpen(shmName, false, &map))
+        return false;
+
+    const LibSpecialDrive_ShmHeader *header = LibSpecialDriveShmDataHeader(&map);
+    uint8_t *copy = header ? realloc(reader->copy, header->capacity ? (size_t)header->capacity : 1) : NULL;
+    if (!copy)
+    {
+        LibSpecialDriveShmUnmap(&map);
+        return false;
+    }
+
+    LibSpecialDriveShmUnmap(&reader->dataMap);
+    reader->dataMap = map;
+    reader->header = header;
+    reader->segment = segment;
+    reader->capacity = (size_t)header->capacity;
+    reader->copy = copy;
+    reader->sequence = 0; // as sequências recomeçam em cada segmento
+    return true;
+}
+
+// Contexto somente leitura com a última publicação consistente, válido até
+// a próxima chamada ou o Close; NULL se nada foi publicado ainda. Só lê o
+// segmento de novo quando a sequência mudou, e remapeia quando o
+// publicador passou para outro segmento de dados. generation (opcional)
+// recebe o número da publicação.
+const LibSpecialDrive *LibSpecialDriveShmReaderGet(LibSpecialDrive_ShmReader *reader, uint64_t *generation)
+{
+    if (!reader)
+        return NULL;
+
+    for (int attempt = 0; attempt < LIBSPECIAL_SHM_READ_RETRIES; attempt++)
+    {
+        uint64_t segment = LibSpecialDriveShmLoad(&reader->control->segment);
+        if (segment == 0)
+            break;
+        if (segment != reader->segment && !LibSpecialDriveShmReaderRemap(reader, segment))
+        {
+            LibSpecialDriveShmYield();
+            continue;
+        }
+
+        const LibSpecialDrive_ShmHeader *header = reader->header;
+        uint64_t sequence = LibSpecialDriveShmLoad(&header->sequence);
+        if (sequence == reader->sequence && reader->view)
+            break;
+
+        // Nada publicado neste segmento ou escrita em andamento
+        if (sequence == 0)
+            break;
+        if (sequence & 1)
+        {
+            LibSpecialDriveShmYield();
+            continue;
+        }
+
+        const uint8_t *data = reader->dataMap.base + sizeof(LibSpecialDrive_ShmHeader);
+        size_t len = (size_t)header->length;
+        uint64_t published = header->generation;
+        if (len <= reader->capacity)
+            memcpy(reader->copy, data, len);
+
+        LibSpecialDriveShmFence();
+        if (LibSpecialDriveShmLoad(&header->sequence) != sequence || len > reader->capacity)
+        {
+            LibSpecialDriveShmYield();
+            continue;
+        }
+
+        LibSpecialDrive *view = calloc(1, sizeof(*view));
+        if (!view)
+            break;
+        if (!LibSpecialDriveCacheParse(view, reader->copy, len))
+        {
+            LibSpecialDriveDestroy(&view);
+            break;
+        }
+
+        LibSpecialDriveDestroy(&reader->view);
+        reader->view = view;
+        reader->sequence = sequence;
+        reader->generation = published;
+        break;
+    }
+
+    // Publicador parado no meio da escrita: fica a última versão consistente
+    if (generation && reader->view)
+        *generation = reader->generation;
+    return reader->view;
+}
+
+void LibSpecialDriveShmReaderClose(LibSpecialDrive_ShmReader **reader)
+{
+    if (!reader || !*reader)
+        return;
+
+    LibSpecialDrive_ShmReader *owned = *reader;
+    LibSpecialDriveDestroy(&owned->view);
+    free(owned->copy);
+    LibSpecialDriveShmUnmap(&owned->dataMap);
+    LibSpecialDriveShmUnmap(&owned->controlMap);
+    free(owned);
+    *reader = NULL;
+}
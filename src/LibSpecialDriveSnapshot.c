@@ -0,0 +1,191 @@
+#include <LibSpecialDrive.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+// --- Instantâneos para leitores concorrentes ---
+
+// Quem altera o contexto (Get, Reload, marcações, Deepen) publica uma cópia
+// nova e troca o ponteiro atomicamente. O leitor fixa o instantâneo com
+// contadores atômicos, sem lock e sem esperar. Antes de soltar a referência
+// do contexto ao instantâneo anterior, quem publica espera os leitores que
+// estavam no meio da fixação, contados por paridade da época: leitores que
+// chegam depois usam a outra paridade, então a espera é limitada. O leitor
+// confere a época depois de fixar e refaz a fixação se ela mudou. Um único
+// escritor por vez, como nas demais funções que alteram o contexto.
+
+static int64_t LibSpecialDriveAtomicAdd(volatile int64_t *value, int64_t delta)
+{
+#ifdef _WIN32
+    return InterlockedExchangeAdd64((volatile LONG64 *)value, delta) + delta;
+#else
+    return __atomic_add_fetch(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static int64_t LibSpecialDriveAtomicLoad(volatile int64_t *value)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange64((volatile LONG64 *)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static LibSpecialDrive_Snapshot *LibSpecialDriveSnapshotLoad(LibSpecialDrive *ctx)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchangePointer((PVOID volatile *)&ctx->snapshot, NULL, NULL);
+#else
+    return __atomic_load_n(&ctx->snapshot, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static LibSpecialDrive_Snapshot *LibSpecialDriveSnapshotExchange(LibSpecialDrive *ctx, LibSpecialDrive_Snapshot *snapshot)
+{
+#ifdef _WIN32
+    return InterlockedExchangePointer((PVOID volatile *)&ctx->snapshot, snapshot);
+#else
+    return __atomic_exchange_n(&ctx->snapshot, snapshot, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static void LibSpecialDriveThreadYield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static void LibSpecialDriveSnapshotFree(LibSpecialDrive_Snapshot *snapshot)
+{
+    LibSpecialDriveArenaFree(&snapshot->view.arena);
+    free(snapshot);
+}
+
+// Cópia profunda das listas para a arena do instantâneo; a ordem das
+// listas e as posições usadas por Mark/Unmark são preservadas
+static LibSpecialDrive_Snapshot *LibSpecialDriveSnapshotBuild(const LibSpecialDrive *ctx)
+{
+    LibSpecialDrive_Snapshot *snapshot = calloc(1, sizeof(*snapshot));
+    size_t total = ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount;
+    LibSpecialDrive_BlockDevice **blocks = calloc(total ? total : 1, sizeof(*blocks));
+    if (!snapshot || !blocks)
+        goto error;
+
+    snapshot->view.options = ctx->options;
+    memset(&snapshot->view.options.filter, 0, sizeof(snapshot->view.options.filter));
+    snapshot->view.options.cachePath = NULL;
+    snapshot->view.options.shmName = NULL;
+    snapshot->refs = 1;
+
+    for (size_t i = 0; i < total; i++)
+    {
+        const LibSpecialDrive_BlockDevice *blk = i < ctx->commonBlockDeviceCount
+                                                     ? &ctx->commonBlockDevices[i]
+                                                     : &ctx->specialBlockDevices[i - ctx->commonBlockDeviceCount];
+        blocks[i] = LibSpecialDriveBlockCopy(&snapshot->view.arena, blk);
+        if (!blocks[i])
+            goto error;
+    }
+
+    if (!LibSpecialDriveContextPlace(&snapshot->view, blocks, total))
+        goto error;
+
+    free(blocks);
+    return snapshot;
+
+error:
+    if (snapshot)
+        LibSpecialDriveSnapshotFree(snapshot);
+    free(blocks);
+    return NULL;
+}
+
+// Troca o instantâneo publicado e solta a referência do contexto ao
+// anterior depois que nenhum leitor pode mais estar fixando-o
+static void LibSpecialDriveSnapshotSwap(LibSpecialDrive *ctx, LibSpecialDrive_Snapshot *snapshot)
+{
+    LibSpecialDrive_Snapshot *old = LibSpecialDriveSnapshotExchange(ctx, snapshot);
+
+    int64_t parity = (LibSpecialDriveAtomicAdd(&ctx->snapshotEpoch, 1) - 1) & 1;
+    while (LibSpecialDriveAtomicLoad(&ctx->snapshotPins[parity]) != 0)
+        LibSpecialDriveThreadYield();
+
+    if (old)
+    {
+        const LibSpecialDrive_Snapshot *release = old;
+        LibSpecialDriveSnapshotRelease(&release);
+    }
+}
+
+// Publica o estado atual do contexto. Sem memória, os leitores continuam
+// vendo o instantâneo anterior e retorna false.
+bool LibSpecialDriveSnapshotPublish(LibSpecialDrive *ctx)
+{
+    if (!ctx)
+        return false;
+
+    LibSpecialDrive_Snapshot *snapshot = LibSpecialDriveSnapshotBuild(ctx);
+    if (!snapshot)
+        return false;
+
+    snapshot->generation = ++ctx->snapshotGeneration;
+    LibSpecialDriveSnapshotSwap(ctx, snapshot);
+    return true;
+}
+
+// Retira a publicação na destruição do contexto; instantâneos ainda
+// fixados continuam válidos até o último Release
+void LibSpecialDriveSnapshotRetire(LibSpecialDrive *ctx)
+{
+    if (ctx)
+        LibSpecialDriveSnapshotSwap(ctx, NULL);
+}
+
+// Fixa o último instantâneo publicado. Nunca bloqueia, mesmo durante um
+// recarregamento em outra thread. Cada Acquire pede um Release.
+const LibSpecialDrive_Snapshot *LibSpecialDriveSnapshotAcquire(LibSpecialDrive *ctx)
+{
+    if (!ctx)
+        return NULL;
+
+    // A fixação só vale se a época não mudou entre a leitura e o
+    // incremento: senão uma publicação seguinte, que espera só a outra
+    // paridade, poderia liberar o instantâneo carregado abaixo
+    volatile int64_t *pins;
+    for (;;)
+    {
+        int64_t epoch = LibSpecialDriveAtomicLoad(&ctx->snapshotEpoch);
+        pins = &ctx->snapshotPins[epoch & 1];
+        LibSpecialDriveAtomicAdd(pins, 1);
+        if (LibSpecialDriveAtomicLoad(&ctx->snapshotEpoch) == epoch)
+            break;
+        LibSpecialDriveAtomicAdd(pins, -1);
+    }
+
+    LibSpecialDrive_Snapshot *snapshot = LibSpecialDriveSnapshotLoad(ctx);
+    if (snapshot)
+        LibSpecialDriveAtomicAdd(&snapshot->refs, 1);
+
+    LibSpecialDriveAtomicAdd(pins, -1);
+    return snapshot;
+}
+
+void LibSpecialDriveSnapshotRelease(const LibSpecialDrive_Snapshot **snapshot)
+{
+    if (!snapshot || !*snapshot)
+        return;
+
+    LibSpecialDrive_Snapshot *owned = (LibSpecialDrive_Snapshot *)(uintptr_t)*snapshot; // const só para o leitor
+    if (LibSpecialDriveAtomicAdd(&owned->refs, -1) == 0)
+        LibSpecialDriveSnapshotFree(owned);
+    *snapshot = NULL;
+}
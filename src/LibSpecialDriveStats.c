@@ -0,0 +1,253 @@
+#include <LibSpecialDrive.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define LIBSPECIAL_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#include <time.h>
+#define LIBSPECIAL_THREAD_LOCAL __thread
+#endif
+
+// --- Contadores por fase ---
+
+// As funções de despacho do backend medem cada chamada e somam tempo,
+// quantidade e bytes da fase em contadores atômicos do processo. Enquanto
+// uma thread sonda um dispositivo, o registro dele fica ativo na thread e
+// recebe as mesmas medições; ao final entra na lista dos mais lentos com a
+// fase que dominou. Nada é medido até LibSpecialDriveStatsEnable(true).
+
+static const char *statsPhaseNames[STATS_PHASE_COUNT] = {
+    "discover", "open", "sizes", "removable", "read-mbr", "read-gpt",
+    "partition-path", "mount-table", "mounts", "free-space", "write"};
+
+const char *LibSpecialDriveStatsPhaseName(enum LibSpecialDrive_StatsPhase phase)
+{
+    return (unsigned)phase < STATS_PHASE_COUNT ? statsPhaseNames[phase] : "unknown";
+}
+
+#ifdef LIBSPECIAL_STATS
+
+static volatile int64_t statsEnabled = 0;
+static volatile int64_t statsNs[STATS_PHASE_COUNT];
+static volatile int64_t statsCalls[STATS_PHASE_COUNT];
+static volatile int64_t statsBytes[STATS_PHASE_COUNT];
+static volatile int64_t statsDevices = 0;
+
+// Lista dos mais lentos, sob lock; floor evita o lock para quem não entra
+static LibSpecialDrive_DeviceStats statsSlowest[LIBSPECIAL_STATS_SLOWEST];
+static size_t statsSlowestCount = 0;
+static volatile int64_t statsSlowestFloor = 0;
+
+#ifdef _WIN32
+static SRWLOCK statsLock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static LIBSPECIAL_THREAD_LOCAL LibSpecialDrive_StatsDevice *statsDevice = NULL;
+
+static int64_t LibSpecialDriveStatsAdd(volatile int64_t *value, int64_t delta)
+{
+#ifdef _WIN32
+    return InterlockedExchangeAdd64((volatile LONG64 *)value, delta) + delta;
+#else
+    return __atomic_add_fetch(value, delta, __ATOMIC_RELAXED);
+#endif
+}
+
+static int64_t LibSpecialDriveStatsLoad(volatile int64_t *value)
+{
+#ifdef _WIN32
+    return InterlockedCompareExchange64((volatile LONG64 *)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#endif
+}
+
+static void LibSpecialDriveStatsStore(volatile int64_t *value, int64_t set)
+{
+#ifdef _WIN32
+    InterlockedExchange64((volatile LONG64 *)value, set);
+#else
+    __atomic_store_n(value, set, __ATOMIC_RELAXED);
+#endif
+}
+
+static void LibSpecialDriveStatsLock(void)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&statsLock);
+#else
+    pthread_mutex_lock(&statsLock);
+#endif
+}
+
+static void LibSpecialDriveStatsUnlock(void)
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&statsLock);
+#else
+    pthread_mutex_unlock(&statsLock);
+#endif
+}
+
+static uint64_t LibSpecialDriveStatsNowNs(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ull +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ull / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Início de uma medição; 0 = desligado, e o End correspondente não faz nada
+uint64_t LibSpecialDriveStatsBegin(void)
+{
+    if (!LibSpecialDriveStatsLoad(&statsEnabled))
+        return 0;
+    uint64_t now = LibSpecialDriveStatsNowNs();
+    return now ? now : 1;
+}
+
+void LibSpecialDriveStatsEnd(enum LibSpecialDrive_StatsPhase phase, uint64_t start, int64_t bytes)
+{
+    if (!start || (unsigned)phase >= STATS_PHASE_COUNT)
+        return;
+
+    uint64_t elapsed = LibSpecialDriveStatsNowNs() - start;
+    LibSpecialDriveStatsAdd(&statsNs[phase], (int64_t)elapsed);
+    LibSpecialDriveStatsAdd(&statsCalls[phase], 1);
+    if (bytes > 0)
+        LibSpecialDriveStatsAdd(&statsBytes[phase], bytes);
+
+    if (statsDevice)
+        statsDevice->ns[phase] += elapsed;
+}
+
+// Torna device (zerado pelo chamador) o registro ativo da thread
+void LibSpecialDriveStatsDeviceEnter(LibSpecialDrive_StatsDevice *device)
+{
+    device->previous = statsDevice;
+    statsDevice = device;
+}
+
+// Restaura o registro anterior; com path, o dispositivo terminou e entra
+// na contagem e, se for o caso, na lista dos mais lentos
+void LibSpecialDriveStatsDeviceLeave(LibSpecialDrive_StatsDevice *device, const char *path)
+{
+    statsDevice = device->previous;
+    if (!path || !LibSpecialDriveStatsLoad(&statsEnabled))
+        return;
+
+    LibSpecialDrive_DeviceStats entry = {{0}, 0, 0, 0};
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+    {
+        entry.ns += device->ns[i];
+        if (device->ns[i] > entry.phaseNs)
+        {
+            entry.phaseNs = device->ns[i];
+            entry.phase = (uint8_t)i;
+        }
+    }
+
+    LibSpecialDriveStatsAdd(&statsDevices, 1);
+    if (entry.ns <= (uint64_t)LibSpecialDriveStatsLoad(&statsSlowestFloor))
+        return;
+
+    size_t len = strlen(path);
+    if (len >= sizeof(entry.path))
+        len = sizeof(entry.path) - 1;
+    memcpy(entry.path, path, len);
+
+    LibSpecialDriveStatsLock();
+    size_t pos = statsSlowestCount;
+    while (pos > 0 && statsSlowest[pos - 1].ns < entry.ns)
+        pos--;
+    if (pos < LIBSPECIAL_STATS_SLOWEST)
+    {
+        size_t moved = statsSlowestCount < LIBSPECIAL_STATS_SLOWEST ? statsSlowestCount - pos : LIBSPECIAL_STATS_SLOWEST - 1 - pos;
+        memmove(&statsSlowest[pos + 1], &statsSlowest[pos], moved * sizeof(statsSlowest[0]));
+        statsSlowest[pos] = entry;
+        if (statsSlowestCount < LIBSPECIAL_STATS_SLOWEST)
+            statsSlowestCount++;
+        if (statsSlowestCount == LIBSPECIAL_STATS_SLOWEST)
+            LibSpecialDriveStatsStore(&statsSlowestFloor, (int64_t)statsSlowest[LIBSPECIAL_STATS_SLOWEST - 1].ns);
+    }
+    LibSpecialDriveStatsUnlock();
+}
+
+// Liga ou desliga a coleta; false se a biblioteca foi compilada sem
+// LIBSPECIAL_STATS
+bool LibSpecialDriveStatsEnable(bool enable)
+{
+    LibSpecialDriveStatsStore(&statsEnabled, enable);
+    return true;
+}
+
+bool LibSpecialDriveGetStats(LibSpecialDrive_Stats *stats)
+{
+    if (!stats)
+        return false;
+
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+    {
+        stats->phases[i].ns = (uint64_t)LibSpecialDriveStatsLoad(&statsNs[i]);
+        stats->phases[i].calls = (uint64_t)LibSpecialDriveStatsLoad(&statsCalls[i]);
+        stats->phases[i].bytes = (uint64_t)LibSpecialDriveStatsLoad(&statsBytes[i]);
+    }
+    stats->devices = (uint64_t)LibSpecialDriveStatsLoad(&statsDevices);
+
+    LibSpecialDriveStatsLock();
+    memcpy(stats->slowest, statsSlowest, statsSlowestCount * sizeof(statsSlowest[0]));
+    stats->slowestCount = statsSlowestCount;
+    LibSpecialDriveStatsUnlock();
+    return true;
+}
+
+// Medições em andamento durante o reset ainda podem somar no novo período
+void LibSpecialDriveResetStats(void)
+{
+    LibSpecialDriveStatsLock();
+    for (int i = 0; i < STATS_PHASE_COUNT; i++)
+    {
+        LibSpecialDriveStatsStore(&statsNs[i], 0);
+        LibSpecialDriveStatsStore(&statsCalls[i], 0);
+        LibSpecialDriveStatsStore(&statsBytes[i], 0);
+    }
+    LibSpecialDriveStatsStore(&statsDevices, 0);
+    LibSpecialDriveStatsStore(&statsSlowestFloor, 0);
+    statsSlowestCount = 0;
+    LibSpecialDriveStatsUnlock();
+}
+
+#else
+
+bool LibSpecialDriveStatsEnable(bool enable)
+{
+    (void)enable;
+    return false;
+}
+
+bool LibSpecialDriveGetStats(LibSpecialDrive_Stats *stats)
+{
+    if (stats)
+        memset(stats, 0, sizeof(*stats));
+    return false;
+}
+
+void LibSpecialDriveResetStats(void)
+{
+}
+
+#endif
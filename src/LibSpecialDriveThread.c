@@ -0,0 +1,135 @@
+#include <LibSpecialDrive.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+// --- Relógio ---
+
+uint64_t LibSpecialDriveNowMs(void)
+{
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
+}
+
+// --- Pool de trabalho limitado ---
+
+typedef struct
+{
+    volatile int64_t next;
+    size_t count;
+    LibSpecialDrive_TaskFn fn;
+    void *user;
+} LibSpecialDrive_ParallelJob;
+
+typedef struct
+{
+    LibSpecialDrive_ParallelJob *job;
+    size_t worker;
+} LibSpecialDrive_ParallelWorker;
+
+static size_t LibSpecialDriveJobNext(LibSpecialDrive_ParallelJob *job)
+{
+#ifdef _WIN32
+    return (size_t)(InterlockedIncrement64((volatile LONG64 *)&job->next) - 1);
+#else
+    return (size_t)__atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+static void LibSpecialDriveJobRun(LibSpecialDrive_ParallelWorker *worker)
+{
+    LibSpecialDrive_ParallelJob *job = worker->job;
+    size_t i;
+    while ((i = LibSpecialDriveJobNext(job)) < job->count)
+        job->fn(i, worker->worker, job->user);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI LibSpecialDriveJobThread(LPVOID arg)
+{
+    LibSpecialDriveJobRun(arg);
+    return 0;
+}
+#else
+static void *LibSpecialDriveJobThread(void *arg)
+{
+    LibSpecialDriveJobRun(arg);
+    return NULL;
+}
+#endif
+
+size_t LibSpecialDriveParallelWorkers(size_t count, size_t maxWorkers)
+{
+    size_t workers = maxWorkers < count ? maxWorkers : count;
+    return workers ? workers : 1;
+}
+
+// Executa fn(i, worker) para i em [0, count) com no máximo maxWorkers
+// threads; worker identifica a thread em [0, LibSpecialDriveParallelWorkers)
+// para que cada uma use seus próprios buffers. A thread chamadora é o
+// worker 0; se não for possível criar threads ela faz o trabalho restante.
+void LibSpecialDriveParallelFor(size_t count, size_t maxWorkers, LibSpecialDrive_TaskFn fn, void *user)
+{
+    if (!fn || count == 0)
+        return;
+
+    LibSpecialDrive_ParallelJob job = {0, count, fn, user};
+    LibSpecialDrive_ParallelWorker self = {&job, 0};
+
+    size_t workers = LibSpecialDriveParallelWorkers(count, maxWorkers);
+    if (workers <= 1)
+    {
+        LibSpecialDriveJobRun(&self);
+        return;
+    }
+
+    LibSpecialDrive_ParallelWorker *slots = calloc(workers - 1, sizeof(*slots));
+#ifdef _WIN32
+    HANDLE *threads = calloc(workers - 1, sizeof(*threads));
+#else
+    pthread_t *threads = calloc(workers - 1, sizeof(*threads));
+#endif
+    size_t started = 0;
+
+    if (threads && slots)
+    {
+        for (; started < workers - 1; started++)
+        {
+            slots[started].job = &job;
+            slots[started].worker = started + 1;
+#ifdef _WIN32
+            threads[started] = CreateThread(NULL, 0, LibSpecialDriveJobThread, &slots[started], 0, NULL);
+            if (!threads[started])
+                break;
+#else
+            if (pthread_create(&threads[started], NULL, LibSpecialDriveJobThread, &slots[started]) != 0)
+                break;
+#endif
+        }
+    }
+
+    LibSpecialDriveJobRun(&self);
+
+    for (size_t i = 0; i < started; i++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    free(threads);
+    free(slots);
+}
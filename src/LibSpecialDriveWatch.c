@@ -0,0 +1,209 @@
+#include <LibSpecialDrive.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// --- Observador de hotplug ---
+
+struct LibSpecialDrive_Watcher
+{
+    LibSpecialDrive *ctx;
+    LibSpecialDrive_EventSource source;
+    uint32_t debounceMs;
+    LibSpecialDrive_WatchCallback callback;
+    void *user;
+
+    char **pending; // caminhos de discos afetados, sem repetição
+    size_t pendingCount;
+    size_t pendingCapacity;
+    bool fullReload; // eventos foram perdidos: recarrega tudo
+    uint64_t firstEventMs;
+    uint64_t lastEventMs;
+};
+
+// Reduz um evento ao nome do disco inteiro: partições apontam para o pai,
+// que é o penúltimo componente de DEVPATH.
+static bool LibSpecialDriveWatcherDiskName(const LibSpecialDrive_UEvent *event, char *name, size_t size)
+{
+    const char *devName = event->devName;
+
+    if (strcmp(event->devType, "partition") == 0)
+    {
+        const char *last = strrchr(event->devPath, '/');
+        if (!last || last == event->devPath)
+            return false;
+
+        const char *parent = last - 1;
+        while (parent > event->devPath && *parent != '/')
+            parent--;
+        if (*parent == '/')
+            parent++;
+
+        snprintf(name, size, "%.*s", (int)(last - parent), parent);
+        return name[0] != '\0';
+    }
+
+    if (strcmp(event->devType, "disk") != 0 || devName[0] == '\0')
+        return false;
+
+    snprintf(name, size, "%s", devName);
+    return true;
+}
+
+static bool LibSpecialDriveWatcherQueue(LibSpecialDrive_Watcher *watcher, const LibSpecialDrive_UEvent *event)
+{
+    char name[128];
+    if (!LibSpecialDriveWatcherDiskName(event, name, sizeof(name)))
+        return false;
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s", watcher->source.devDirectory ? watcher->source.devDirectory : "/dev", name);
+
+    for (size_t i = 0; i < watcher->pendingCount; i++)
+    {
+        if (strcmp(watcher->pending[i], path) == 0)
+            return true; // rajada coalescida no mesmo disco
+    }
+
+    if (watcher->pendingCount == watcher->pendingCapacity)
+    {
+        size_t capacity = watcher->pendingCapacity ? watcher->pendingCapacity * 2 : 16;
+        char **pending = realloc(watcher->pending, capacity * sizeof(*pending));
+        if (!pending)
+        {
+            watcher->fullReload = true;
+            return true;
+        }
+        watcher->pending = pending;
+        watcher->pendingCapacity = capacity;
+    }
+
+    watcher->pending[watcher->pendingCount] = strdup(path);
+    if (!watcher->pending[watcher->pendingCount])
+    {
+        watcher->fullReload = true;
+        return true;
+    }
+
+    watcher->pendingCount++;
+    return true;
+}
+
+static void LibSpecialDriveWatcherClearPending(LibSpecialDrive_Watcher *watcher)
+{
+    for (size_t i = 0; i < watcher->pendingCount; i++)
+        free(watcher->pending[i]);
+    watcher->pendingCount = 0;
+    watcher->fullReload = false;
+}
+
+static bool LibSpecialDriveWatcherHasPending(const LibSpecialDrive_Watcher *watcher)
+{
+    return watcher->pendingCount > 0 || watcher->fullReload;
+}
+
+LibSpecialDrive_Watcher *LibSpecialDriveWatcherCreate(LibSpecialDrive *ctx, const LibSpecialDrive_EventSource *source, uint32_t debounceMs, LibSpecialDrive_WatchCallback callback, void *user)
+{
+    if (!ctx || !source || !source->next)
+        return NULL;
+
+    LibSpecialDrive_Watcher *watcher = calloc(1, sizeof(*watcher));
+    if (!watcher)
+        return NULL;
+
+    watcher->ctx = ctx;
+    watcher->source = *source;
+    watcher->debounceMs = debounceMs;
+    watcher->callback = callback;
+    watcher->user = user;
+    return watcher;
+}
+
+int LibSpecialDriveWatcherGetFd(LibSpecialDrive_Watcher *watcher)
+{
+    if (!watcher || !watcher->source.getFd)
+        return -1;
+    return watcher->source.getFd(watcher->source.user);
+}
+
+// Milissegundos até a próxima aplicação pendente; -1 quando não há nada
+// pendente (basta esperar o fd).
+int LibSpecialDriveWatcherGetTimeout(LibSpecialDrive_Watcher *watcher)
+{
+    if (!watcher || !LibSpecialDriveWatcherHasPending(watcher))
+        return -1;
+
+    uint64_t now = LibSpecialDriveNowMs();
+    uint64_t quietAt = watcher->lastEventMs + watcher->debounceMs;
+    uint64_t limitAt = watcher->firstEventMs + (uint64_t)watcher->debounceMs * LIBSPECIAL_WATCH_MAX_DELAY_FACTOR;
+    uint64_t dueAt = quietAt < limitAt ? quietAt : limitAt;
+
+    return dueAt <= now ? 0 : (int)(dueAt - now);
+}
+
+// Consome os eventos disponíveis e, passado o debounce, aplica as mudanças
+// coalescidas ao contexto. Retorna true quando o contexto foi atualizado.
+bool LibSpecialDriveWatcherDispatch(LibSpecialDrive_Watcher *watcher, LibSpecialDrive_ChangeList *changes)
+{
+    if (!watcher)
+        return false;
+
+    LibSpecialDrive_UEvent event;
+    int result;
+    while ((result = watcher->source.next(watcher->source.user, &event)) != 0)
+    {
+        bool wasEmpty = !LibSpecialDriveWatcherHasPending(watcher);
+
+        if (result < 0)
+            watcher->fullReload = true;
+        else if (!LibSpecialDriveWatcherQueue(watcher, &event))
+            continue;
+
+        uint64_t now = LibSpecialDriveNowMs();
+        if (wasEmpty)
+            watcher->firstEventMs = now;
+        watcher->lastEventMs = now;
+
+        if (result < 0)
+            break;
+    }
+
+    if (LibSpecialDriveWatcherGetTimeout(watcher) != 0)
+        return false;
+
+    LibSpecialDrive_ChangeList local = {0};
+    LibSpecialDrive_ChangeList *target = changes ? changes : &local;
+
+    bool ok = watcher->fullReload
+                  ? LibSpecialDriveReloadDiff(watcher->ctx, target)
+                  : LibSpecialDriveReloadDevices(watcher->ctx, (const char *const *)watcher->pending, watcher->pendingCount, target);
+
+    // Recarga que falha não muda o contexto: os discos pendentes (ou a
+    // recarga completa) ficam para uma nova tentativa depois de outro
+    // debounce, em vez de se perderem até o próximo evento deles
+    if (ok)
+        LibSpecialDriveWatcherClearPending(watcher);
+    else
+        watcher->firstEventMs = watcher->lastEventMs = LibSpecialDriveNowMs();
+
+    if (ok && watcher->callback && target->count > 0)
+        watcher->callback(watcher->ctx, target, watcher->user);
+
+    LibSpecialDriveChangeListClear(&local);
+    return ok;
+}
+
+void LibSpecialDriveWatcherDestroy(LibSpecialDrive_Watcher **watcher)
+{
+    if (!watcher || !*watcher)
+        return;
+
+    LibSpecialDriveWatcherClearPending(*watcher);
+    free((*watcher)->pending);
+
+    if ((*watcher)->source.close)
+        (*watcher)->source.close((*watcher)->source.user);
+
+    free(*watcher);
+    *watcher = NULL;
+}
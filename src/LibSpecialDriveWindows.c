@@ -21,37 +21,31 @@ static bool IsMatchingExtent(const DISK_EXTENT *ext, DWORD diskNumber, LONGLONG
            ext->StartingOffset.QuadPart == lbaStart * lbaSize;
 }
 
-void LibSpecialDriveDiretoryFreeSpaceLookup(LibSpecialDrive_Partition *part)
+bool LibSpecialDriveDiretoryFreeSpaceLookup(const char *directory, uint64_t *freeSpace)
 {
-    if (!part)
-        return;
-    part->freeSpace = 0;
-    if (!part->path)
-        return;
+    if (!directory || !freeSpace)
+        return false;
 
     ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
+    if (!GetDiskFreeSpaceExA(directory, &freeBytesAvailable, &totalBytes, &totalFreeBytes))
+        return false;
 
-    if (GetDiskFreeSpaceExA(part->path, &freeBytesAvailable, &totalBytes, &totalFreeBytes))
-    {
-        part->freeSpace = freeBytesAvailable.QuadPart;
-        return;
-    }
+    *freeSpace = freeBytesAvailable.QuadPart;
+    return true;
 }
 
-char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber)
+char *LibSpecialDrivePartitionPathLookup(const char *path, int partitionNumber, LibSpecialDrive_Arena *arena)
 {
     (void)partitionNumber;
-    return strdup(path);
+    return LibSpecialDriveArenaStrdup(arena, path);
 }
 
-void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type)
+void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
 {
     if (!part || !part->path)
         return;
 
     int diskNumber = ExtractDiskNumber(part->path);
-    free(part->path);
-
     if (diskNumber < 0)
         return;
 
@@ -92,12 +86,12 @@ void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum
                     char mountPaths[MAX_PATH] = {0};
                     DWORD pathLen = 0;
 
-                    part->path = strdup(volumeName); // Retém o nome da volume
+                    part->path = LibSpecialDriveArenaStrdup(arena, volumeName); // Retém o nome da volume
 
                     if (GetVolumePathNamesForVolumeNameA(volumeName, mountPaths, MAX_PATH, &pathLen) && pathLen > 0)
                     {
                         if (strlen(mountPaths) >= 2)
-                            part->mountPoint = strdup(mountPaths);
+                            part->mountPoint = LibSpecialDriveArenaStrdup(arena, mountPaths);
                         CloseHandle(hVolume);
                         FindVolumeClose(hVol);
                         return;
@@ -112,6 +106,25 @@ void LibSpecialDrivePartitionGetPathMount(LibSpecialDrive_Partition *part, enum
     FindVolumeClose(hVol);
 }
 
+// O caminho da partição já foi trocado pelo nome do volume na sondagem e o
+// ponto de montagem é resolvido junto; não há o que atualizar depois
+void LibSpecialDrivePartitionRefreshMount(LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    (void)part;
+    (void)type;
+    (void)arena;
+}
+
+bool LibSpecialDriveMountTableRefresh(void)
+{
+    return true;
+}
+
+int LibSpecialDriveMountTableGetFd(void)
+{
+    return -1;
+}
+
 bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
 {
     GET_LENGTH_INFORMATION lenInfo;
@@ -130,6 +143,13 @@ bool LibSpecialDriveLookUpSizes(LibSpecialDrive_DeviceHandle device, LibSpecialD
     return true;
 }
 
+// Discos são identificados só pelo número de PhysicalDrive
+void LibSpecialDriveDevIdSplit(uint64_t devId, uint32_t *major, uint32_t *minor)
+{
+    *major = 0;
+    *minor = (uint32_t)devId;
+}
+
 bool LibSpecialDriveLookUpIsRemovable(LibSpecialDrive_DeviceHandle device, LibSpecialDrive_BlockDevice *blk)
 {
     STORAGE_PROPERTY_QUERY query = {StorageDeviceProperty, PropertyStandardQuery, {0}};
@@ -150,21 +170,22 @@ bool LibSpecialDriveLookUpIsRemovable(LibSpecialDrive_DeviceHandle device, LibSp
     return false;
 }
 
-LibSpecialDrive *LibSpecialDriveGet(void)
+bool LibSpecialDriveDiscover(const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *user)
 {
-    LibSpecialDrive *driver = calloc(1, sizeof(LibSpecialDrive));
-    if (!driver)
-        return NULL;
+    (void)options;
+    if (!callback)
+        return false;
 
+    char name[32];
     char path[MAX_PATH];
+    char target[MAX_PATH];
     int failed = 0;
 
+    // QueryDosDevice consulta o nome sem abrir o disco
     for (DWORD i = 0;; ++i)
     {
-        snprintf(path, sizeof(path), "\\\\.\\PhysicalDrive%lu", i);
-        LibSpecialDrive_BlockDevice *blk = LibSpecialDriveGetBlock(path);
-
-        if (!blk)
+        snprintf(name, sizeof(name), "PhysicalDrive%lu", i);
+        if (!QueryDosDeviceA(name, target, MAX_PATH))
         {
             if (++failed > 8)
                 break;
@@ -172,10 +193,14 @@ LibSpecialDrive *LibSpecialDriveGet(void)
         }
 
         failed = 0;
-        LibSpecialDriveBlockAppend(driver, &blk);
+        snprintf(path, sizeof(path), "\\\\.\\%s", name);
+
+        LibSpecialDrive_Candidate cand = {path, 0, i, 0, 0, 0, false, 0, NULL, 0};
+        if (!callback(&cand, user))
+            return false;
     }
 
-    return driver;
+    return true;
 }
 
 LibSpecialDrive_DeviceHandle LibSpecialDriveOpenDevice(const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags)
@@ -222,6 +247,40 @@ int64_t LibSpecialDriveRead(LibSpecialDrive_DeviceHandle device, int64_t len, ui
     return bytesRead;
 }
 
+int64_t LibSpecialDriveReadAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, uint8_t *target)
+{
+    OVERLAPPED overlapped = {0};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD bytesRead = 0;
+    if (!ReadFile(device, target, (DWORD)len, &bytesRead, &overlapped))
+        return -1;
+    return bytesRead;
+}
+
+int64_t LibSpecialDriveWriteAt(LibSpecialDrive_DeviceHandle device, int64_t offset, int64_t len, const uint8_t *source)
+{
+    OVERLAPPED overlapped = {0};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD bytesWritten = 0;
+    if (!WriteFile(device, source, (DWORD)len, &bytesWritten, &overlapped))
+        return -1;
+    return bytesWritten;
+}
+
+bool LibSpecialDriveFlush(LibSpecialDrive_DeviceHandle device)
+{
+    if (!FlushFileBuffers(device))
+    {
+        fprintf(stderr, "FlushFileBuffers failed (Error: %lu)\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
 int64_t LibSpecialDriveWrite(LibSpecialDrive_DeviceHandle device, int64_t len, const uint8_t *source)
 {
     DWORD bytesWritten = 0;
@@ -238,6 +297,13 @@ void LibSpecialDriveCloseDevice(LibSpecialDrive_DeviceHandle device)
     }
 }
 
+// Sem NETLINK_KOBJECT_UEVENT nesta plataforma: use uma fonte própria
+bool LibSpecialDriveEventSourceNetlink(LibSpecialDrive_EventSource *source)
+{
+    (void)source;
+    return false;
+}
+
 BOOL WINAPI DllMain(HINSTANCE hinstDLL,DWORD fdwReason,LPVOID lpvReserved)
 {
     // Perform actions based on the reason for calling.
@@ -0,0 +1,407 @@
+#include <LibSpecialDrive.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <limits.h>
+#else
+#include <unistd.h>
+#endif
+
+// --- Saída em fluxo (JSON Lines e binário) ---
+
+// Tudo é escrito direto no buffer do chamador, sem alocação por campo nem
+// snprintf. Formato binário, little-endian em qualquer arquitetura:
+//
+//   cabeçalho (uma vez): "LSDS", u16 versão (1), u16 reservado
+//   bloco:     u8 tipo do registro (1), u8 especial, u8 tipo da tabela,
+//              u8 profundidade, u8 flags, u8 partições, u16 tamanho do caminho,
+//              u32 posição na lista, u32 lbaSize, u64 tamanho, u64 devId,
+//              16 bytes do UUID da flag (zeros se comum), caminho
+//   partição:  16 bytes do GUID único (zeros se MBR), u64 espaço livre,
+//              u16 tamanho do caminho, u16 tamanho do ponto de montagem
+//              (0xFFFF = ausente), caminho, ponto de montagem
+//   mudança:   u8 tipo do registro (2), u8 enum LibSpecialDrive_ChangeType,
+//              u8 especial, u8 reservado, u64 devId, u16 tamanho do caminho,
+//              caminho
+//   espaço:    u8 tipo do registro (3), 3 bytes reservados, u64 espaço livre,
+//              u64 valor anterior, u16 tamanho do caminho, u16 tamanho do
+//              ponto de montagem (0xFFFF = ausente), caminho, ponto de montagem
+
+#define LIBSPECIAL_WRITER_MAGIC "LSDS"
+#define LIBSPECIAL_WRITER_VERSION 1
+#define LIBSPECIAL_WRITER_RECORD_BLOCK 1
+#define LIBSPECIAL_WRITER_RECORD_CHANGE 2
+#define LIBSPECIAL_WRITER_RECORD_FREE_SPACE 3
+#define LIBSPECIAL_WRITER_NULL_STRING UINT16_MAX
+
+static bool LibSpecialDriveWriterDrain(LibSpecialDrive_Writer *writer)
+{
+    size_t done = 0;
+    while (done < writer->len)
+    {
+#ifdef _WIN32
+        unsigned chunk = writer->len - done > INT_MAX ? INT_MAX : (unsigned)(writer->len - done);
+        int written = _write(writer->fd, writer->buffer + done, chunk);
+#else
+        ssize_t written = write(writer->fd, writer->buffer + done, writer->len - done);
+        if (written < 0 && errno == EINTR)
+            continue;
+#endif
+        if (written <= 0)
+        {
+            writer->failed = true;
+            return false;
+        }
+        done += (size_t)written;
+    }
+    writer->len = 0;
+    return true;
+}
+
+static bool LibSpecialDriveWriterPut(LibSpecialDrive_Writer *writer, const void *data, size_t len)
+{
+    const uint8_t *bytes = data;
+    while (len > 0)
+    {
+        if (writer->failed)
+            return false;
+
+        if (writer->len == writer->capacity)
+        {
+            if (writer->fd < 0 || !LibSpecialDriveWriterDrain(writer))
+                return false;
+        }
+
+        size_t chunk = writer->capacity - writer->len;
+        if (chunk > len)
+            chunk = len;
+        memcpy(writer->buffer + writer->len, bytes, chunk);
+        writer->len += chunk;
+        bytes += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+static bool LibSpecialDriveWriterText(LibSpecialDrive_Writer *writer, const char *text)
+{
+    return LibSpecialDriveWriterPut(writer, text, strlen(text));
+}
+
+// --- JSON ---
+
+static bool LibSpecialDriveWriterNumber(LibSpecialDrive_Writer *writer, uint64_t value)
+{
+    char digits[20];
+    size_t count = 0;
+    do
+    {
+        digits[sizeof(digits) - 1 - count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return LibSpecialDriveWriterPut(writer, digits + sizeof(digits) - count, count);
+}
+
+static bool LibSpecialDriveWriterString(LibSpecialDrive_Writer *writer, const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+    if (!str)
+        return LibSpecialDriveWriterText(writer, "null");
+
+    bool ok = LibSpecialDriveWriterPut(writer, "\"", 1);
+    const char *run = str;
+    for (const char *c = str; ok && *c; c++)
+    {
+        uint8_t ch = (uint8_t)*c;
+        if (ch >= 0x20 && ch != '"' && ch != '\\')
+            continue;
+
+        // Trecho sem escape copiado de uma vez
+        ok = LibSpecialDriveWriterPut(writer, run, (size_t)(c - run));
+        char escape[6] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0x0F]};
+        if (ch == '"' || ch == '\\')
+        {
+            escape[1] = (char)ch;
+            ok = ok && LibSpecialDriveWriterPut(writer, escape, 2);
+        }
+        else
+        {
+            ok = ok && LibSpecialDriveWriterPut(writer, escape, sizeof(escape));
+        }
+        run = c + 1;
+    }
+    ok = ok && LibSpecialDriveWriterText(writer, run);
+    return ok && LibSpecialDriveWriterPut(writer, "\"", 1);
+}
+
+static bool LibSpecialDriveWriterUUID(LibSpecialDrive_Writer *writer, const uint8_t *uuid)
+{
+    char text[LIBSPECIAL_UUID_STRING_SIZE];
+    return LibSpecialDriveWriterString(writer, uuid ? LibSpecialDriveFormatUUID(uuid, text) : NULL);
+}
+
+static bool LibSpecialDriveWriterField(LibSpecialDrive_Writer *writer, const char *name, uint64_t value)
+{
+    return LibSpecialDriveWriterText(writer, name) && LibSpecialDriveWriterNumber(writer, value);
+}
+
+static bool LibSpecialDriveWriterBool(LibSpecialDrive_Writer *writer, const char *name, bool value)
+{
+    return LibSpecialDriveWriterText(writer, name) && LibSpecialDriveWriterText(writer, value ? "true" : "false");
+}
+
+static const uint8_t *LibSpecialDriveWriterPartitionUUID(const LibSpecialDrive_BlockDevice *blk, const LibSpecialDrive_Partition *part)
+{
+    return blk->type == PARTITION_TYPE_GPT ? part->partitionMeta.gpt.uniquePartitionGuid : NULL;
+}
+
+static bool LibSpecialDriveWriterJsonBlock(LibSpecialDrive_Writer *writer, const LibSpecialDrive_BlockDevice *blk, bool special, size_t index)
+{
+    static const char *const types[] = {"unknown", "gpt", "mbr"};
+    LibSpecialDrive_Flag *flag = special ? LibSpecialDriveIsSpecial(blk->signature) : NULL;
+
+    bool ok = LibSpecialDriveWriterText(writer, special ? "{\"list\":\"special\"" : "{\"list\":\"common\"") &&
+              LibSpecialDriveWriterField(writer, ",\"index\":", index) &&
+              LibSpecialDriveWriterText(writer, ",\"path\":") && LibSpecialDriveWriterString(writer, blk->path) &&
+              LibSpecialDriveWriterField(writer, ",\"devId\":", blk->devId) &&
+              LibSpecialDriveWriterField(writer, ",\"size\":", blk->size) &&
+              LibSpecialDriveWriterField(writer, ",\"lbaSize\":", blk->lbaSize) &&
+              LibSpecialDriveWriterText(writer, ",\"type\":\"") &&
+              LibSpecialDriveWriterText(writer, types[blk->type <= PARTITION_TYPE_MBR ? blk->type : 0]) &&
+              LibSpecialDriveWriterField(writer, "\",\"depth\":", blk->depth) &&
+              LibSpecialDriveWriterField(writer, ",\"flags\":", (uint8_t)blk->flags) &&
+              LibSpecialDriveWriterBool(writer, ",\"removable\":", blk->flags & BLOCK_FLAG_IS_REMOVABLE) &&
+              LibSpecialDriveWriterBool(writer, ",\"readOnly\":", blk->flags & BLOCK_FLAG_IS_READ_ONLY) &&
+              LibSpecialDriveWriterText(writer, ",\"uuid\":") && LibSpecialDriveWriterUUID(writer, flag ? flag->uuid : NULL);
+
+    if (!(writer->flags & WRITER_FLAG_NO_PARTITIONS))
+    {
+        ok = ok && LibSpecialDriveWriterText(writer, ",\"partitions\":[");
+        for (int i = 0; ok && i < blk->partitionCount; i++)
+        {
+            const LibSpecialDrive_Partition *part = &blk->partitions[i];
+            ok = LibSpecialDriveWriterText(writer, i ? ",{\"path\":" : "{\"path\":") && LibSpecialDriveWriterString(writer, part->path) &&
+                 LibSpecialDriveWriterText(writer, ",\"mountPoint\":") && LibSpecialDriveWriterString(writer, part->mountPoint) &&
+                 LibSpecialDriveWriterText(writer, ",\"uuid\":") && LibSpecialDriveWriterUUID(writer, LibSpecialDriveWriterPartitionUUID(blk, part)) &&
+                 LibSpecialDriveWriterField(writer, ",\"freeSpace\":", part->freeSpace) &&
+                 LibSpecialDriveWriterText(writer, "}");
+        }
+        ok = ok && LibSpecialDriveWriterText(writer, "]");
+    }
+    return ok && LibSpecialDriveWriterText(writer, "}\n");
+}
+
+// --- Binário ---
+
+static bool LibSpecialDriveWriterLE(LibSpecialDrive_Writer *writer, uint64_t value, size_t size)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < size; i++)
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    return LibSpecialDriveWriterPut(writer, bytes, size);
+}
+
+static uint16_t LibSpecialDriveWriterStringLen(const char *str)
+{
+    if (!str)
+        return LIBSPECIAL_WRITER_NULL_STRING;
+    size_t len = strlen(str);
+    return len < LIBSPECIAL_WRITER_NULL_STRING ? (uint16_t)len : LIBSPECIAL_WRITER_NULL_STRING - 1;
+}
+
+static bool LibSpecialDriveWriterBytes(LibSpecialDrive_Writer *writer, const char *str, uint16_t len)
+{
+    return len == LIBSPECIAL_WRITER_NULL_STRING || LibSpecialDriveWriterPut(writer, str, len);
+}
+
+static bool LibSpecialDriveWriterBinaryBlock(LibSpecialDrive_Writer *writer, const LibSpecialDrive_BlockDevice *blk, bool special, size_t index)
+{
+    static const uint8_t zero[16] = {0};
+    LibSpecialDrive_Flag *flag = special ? LibSpecialDriveIsSpecial(blk->signature) : NULL;
+    int partitions = (writer->flags & WRITER_FLAG_NO_PARTITIONS) || blk->partitionCount < 0 ? 0 : blk->partitionCount;
+    uint16_t pathLen = LibSpecialDriveWriterStringLen(blk->path);
+    if (pathLen == LIBSPECIAL_WRITER_NULL_STRING)
+        pathLen = 0;
+
+    uint8_t head[8] = {LIBSPECIAL_WRITER_RECORD_BLOCK, special, (uint8_t)blk->type, blk->depth,
+                       (uint8_t)blk->flags, (uint8_t)partitions, (uint8_t)pathLen, (uint8_t)(pathLen >> 8)};
+    bool ok = LibSpecialDriveWriterPut(writer, head, sizeof(head)) &&
+              LibSpecialDriveWriterLE(writer, index, 4) &&
+              LibSpecialDriveWriterLE(writer, blk->lbaSize, 4) &&
+              LibSpecialDriveWriterLE(writer, blk->size, 8) &&
+              LibSpecialDriveWriterLE(writer, blk->devId, 8) &&
+              LibSpecialDriveWriterPut(writer, flag ? flag->uuid : zero, 16) &&
+              LibSpecialDriveWriterPut(writer, blk->path, pathLen);
+
+    for (int i = 0; ok && i < partitions; i++)
+    {
+        const LibSpecialDrive_Partition *part = &blk->partitions[i];
+        const uint8_t *uuid = LibSpecialDriveWriterPartitionUUID(blk, part);
+        uint16_t partPathLen = LibSpecialDriveWriterStringLen(part->path);
+        uint16_t mountLen = LibSpecialDriveWriterStringLen(part->mountPoint);
+
+        ok = LibSpecialDriveWriterPut(writer, uuid ? uuid : zero, 16) &&
+             LibSpecialDriveWriterLE(writer, part->freeSpace, 8) &&
+             LibSpecialDriveWriterLE(writer, partPathLen, 2) &&
+             LibSpecialDriveWriterLE(writer, mountLen, 2) &&
+             LibSpecialDriveWriterBytes(writer, part->path, partPathLen) &&
+             LibSpecialDriveWriterBytes(writer, part->mountPoint, mountLen);
+    }
+    return ok;
+}
+
+// --- API ---
+
+void LibSpecialDriveWriterInit(LibSpecialDrive_Writer *writer, enum LibSpecialDrive_WriterFormat format, uint32_t flags, void *buffer, size_t capacity)
+{
+    LibSpecialDriveWriterInitFd(writer, format, flags, -1, buffer, capacity);
+}
+
+void LibSpecialDriveWriterInitFd(LibSpecialDrive_Writer *writer, enum LibSpecialDrive_WriterFormat format, uint32_t flags, int fd, void *buffer, size_t capacity)
+{
+    if (!writer)
+        return;
+
+    memset(writer, 0, sizeof(*writer));
+    writer->buffer = buffer;
+    writer->capacity = buffer ? capacity : 0;
+    writer->fd = fd;
+    writer->format = (uint8_t)format;
+    writer->flags = flags;
+    writer->failed = !buffer || capacity == 0;
+}
+
+// Abre um registro: cabeçalho do formato binário na primeira vez e marca
+// para descartar o registro inteiro se ele não couber no buffer
+static bool LibSpecialDriveWriterBegin(LibSpecialDrive_Writer *writer, size_t *mark, bool *header)
+{
+    if (!writer || writer->failed)
+        return false;
+
+    *mark = writer->len;
+    *header = writer->headerWritten;
+    if (writer->format != WRITER_FORMAT_BINARY || writer->headerWritten)
+        return true;
+
+    writer->headerWritten = LibSpecialDriveWriterPut(writer, LIBSPECIAL_WRITER_MAGIC, 4) &&
+                            LibSpecialDriveWriterLE(writer, LIBSPECIAL_WRITER_VERSION, 2) &&
+                            LibSpecialDriveWriterLE(writer, 0, 2);
+    return writer->headerWritten;
+}
+
+static bool LibSpecialDriveWriterEnd(LibSpecialDrive_Writer *writer, bool ok, size_t mark, bool header)
+{
+    if (!ok && writer->fd < 0)
+    {
+        writer->len = mark;
+        writer->headerWritten = header;
+    }
+    return ok;
+}
+
+// Escreve um dispositivo; special e index dizem em que lista e posição ele
+// está. Sem fd, um registro que não cabe no buffer é descartado inteiro.
+bool LibSpecialDriveWriterBlock(LibSpecialDrive_Writer *writer, const LibSpecialDrive_BlockDevice *blk, bool special, size_t index)
+{
+    size_t mark;
+    bool header;
+    if (!blk || !LibSpecialDriveWriterBegin(writer, &mark, &header))
+        return false;
+
+    bool ok = writer->format == WRITER_FORMAT_BINARY
+                  ? LibSpecialDriveWriterBinaryBlock(writer, blk, special, index)
+                  : LibSpecialDriveWriterJsonBlock(writer, blk, special, index);
+    return LibSpecialDriveWriterEnd(writer, ok, mark, header);
+}
+
+// Escreve uma mudança de um recarregamento (LibSpecialDriveReloadDiff etc.)
+bool LibSpecialDriveWriterChange(LibSpecialDrive_Writer *writer, const LibSpecialDrive_Change *change)
+{
+    static const char *const types[] = {"added", "removed", "changed"};
+    size_t mark;
+    bool header;
+    if (!change || change->type > CHANGE_CHANGED || !LibSpecialDriveWriterBegin(writer, &mark, &header))
+        return false;
+
+    bool ok;
+    if (writer->format == WRITER_FORMAT_BINARY)
+    {
+        uint16_t pathLen = LibSpecialDriveWriterStringLen(change->path);
+        if (pathLen == LIBSPECIAL_WRITER_NULL_STRING)
+            pathLen = 0;
+
+        uint8_t head[4] = {LIBSPECIAL_WRITER_RECORD_CHANGE, (uint8_t)change->type, change->special, 0};
+        ok = LibSpecialDriveWriterPut(writer, head, sizeof(head)) &&
+             LibSpecialDriveWriterLE(writer, change->devId, 8) &&
+             LibSpecialDriveWriterLE(writer, pathLen, 2) &&
+             LibSpecialDriveWriterPut(writer, change->path, pathLen);
+    }
+    else
+    {
+        ok = LibSpecialDriveWriterText(writer, "{\"event\":\"") &&
+             LibSpecialDriveWriterText(writer, types[change->type]) &&
+             LibSpecialDriveWriterText(writer, change->special ? "\",\"list\":\"special\"" : "\",\"list\":\"common\"") &&
+             LibSpecialDriveWriterText(writer, ",\"path\":") && LibSpecialDriveWriterString(writer, change->path) &&
+             LibSpecialDriveWriterField(writer, ",\"devId\":", change->devId) &&
+             LibSpecialDriveWriterText(writer, "}\n");
+    }
+    return LibSpecialDriveWriterEnd(writer, ok, mark, header);
+}
+
+// Escreve a variação do espaço livre de uma partição desde previous
+bool LibSpecialDriveWriterFreeSpace(LibSpecialDrive_Writer *writer, const LibSpecialDrive_Partition *part, uint64_t previous)
+{
+    size_t mark;
+    bool header;
+    if (!part || !LibSpecialDriveWriterBegin(writer, &mark, &header))
+        return false;
+
+    bool ok;
+    if (writer->format == WRITER_FORMAT_BINARY)
+    {
+        uint16_t pathLen = LibSpecialDriveWriterStringLen(part->path);
+        uint16_t mountLen = LibSpecialDriveWriterStringLen(part->mountPoint);
+        uint8_t head[4] = {LIBSPECIAL_WRITER_RECORD_FREE_SPACE, 0, 0, 0};
+
+        ok = LibSpecialDriveWriterPut(writer, head, sizeof(head)) &&
+             LibSpecialDriveWriterLE(writer, part->freeSpace, 8) &&
+             LibSpecialDriveWriterLE(writer, previous, 8) &&
+             LibSpecialDriveWriterLE(writer, pathLen, 2) &&
+             LibSpecialDriveWriterLE(writer, mountLen, 2) &&
+             LibSpecialDriveWriterBytes(writer, part->path, pathLen) &&
+             LibSpecialDriveWriterBytes(writer, part->mountPoint, mountLen);
+    }
+    else
+    {
+        ok = LibSpecialDriveWriterText(writer, "{\"event\":\"freeSpace\",\"path\":") && LibSpecialDriveWriterString(writer, part->path) &&
+             LibSpecialDriveWriterText(writer, ",\"mountPoint\":") && LibSpecialDriveWriterString(writer, part->mountPoint) &&
+             LibSpecialDriveWriterField(writer, ",\"freeSpace\":", part->freeSpace) &&
+             LibSpecialDriveWriterField(writer, ",\"previous\":", previous) &&
+             LibSpecialDriveWriterText(writer, "}\n");
+    }
+    return LibSpecialDriveWriterEnd(writer, ok, mark, header);
+}
+
+// Escreve todos os dispositivos, comuns e depois especiais
+bool LibSpecialDriveWriterContext(LibSpecialDrive_Writer *writer, const LibSpecialDrive *ctx)
+{
+    if (!writer || !ctx)
+        return false;
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < ctx->commonBlockDeviceCount; i++)
+        ok = LibSpecialDriveWriterBlock(writer, &ctx->commonBlockDevices[i], false, i);
+    for (size_t i = 0; ok && i < ctx->specialBlockDeviceCount; i++)
+        ok = LibSpecialDriveWriterBlock(writer, &ctx->specialBlockDevices[i], true, i);
+    return ok;
+}
+
+// Descarrega no fd o que estiver no buffer; sem fd não faz nada
+bool LibSpecialDriveWriterFlush(LibSpecialDrive_Writer *writer)
+{
+    if (!writer || writer->failed)
+        return false;
+    return writer->fd < 0 || LibSpecialDriveWriterDrain(writer);
+}
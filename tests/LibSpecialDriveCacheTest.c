@@ -0,0 +1,192 @@
+#include "LibSpecialDriveTest.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// --- Cache persistente ---
+
+// O contexto volta do cache igual ao sondado. No início pelo cache cada
+// dispositivo é aberto uma única vez: para conferir a impressão digital ou,
+// com o mtime mudado, para a sondagem. Sem mudanças o arquivo não é
+// regravado. Uma escrita que não mexe no mtime também é vista, e um cache
+// corrompido cai na sondagem completa.
+
+#define OPENS_MAX 64
+
+static LibSpecialDrive_Backend *imageBackend;
+static char openedPaths[OPENS_MAX][4096];
+static int opens = 0;
+
+static LibSpecialDrive_DeviceHandle countingOpen(void *user, const char *path, enum LibSpecialDrive_DeviceHandle_Flags flags)
+{
+    (void)user;
+    if (opens < OPENS_MAX)
+        snprintf(openedPaths[opens], sizeof(openedPaths[0]), "%s", path);
+    opens++;
+    return imageBackend->open ? imageBackend->open(imageBackend->user, path, flags) : LibSpecialDriveOpenDevice(path, flags);
+}
+
+// Cada um dos count dispositivos aberto exatamente uma vez
+static bool testOpenedOnce(int count)
+{
+    for (int i = 0; i < opens && i < OPENS_MAX; i++)
+    {
+        for (int j = 0; j < i; j++)
+        {
+            if (strcmp(openedPaths[i], openedPaths[j]) == 0)
+                return false;
+        }
+    }
+    return opens == count;
+}
+
+static bool testBlockEqual(const LibSpecialDrive_BlockDevice *a, const LibSpecialDrive_BlockDevice *b)
+{
+    if (strcmp(a->path, b->path) != 0 || a->type != b->type || a->lbaSize != b->lbaSize || a->size != b->size ||
+        a->partitionCount != b->partitionCount || a->flags != b->flags || a->depth != b->depth || a->devId != b->devId ||
+        memcmp(a->signature, b->signature, sizeof(*a->signature)) != 0 ||
+        memcmp(&a->fingerprint, &b->fingerprint, sizeof(a->fingerprint)) != 0)
+        return false;
+
+    for (int i = 0; i < a->partitionCount; i++)
+    {
+        const LibSpecialDrive_Partition *x = &a->partitions[i], *y = &b->partitions[i];
+        if (memcmp(&x->partitionMeta, &y->partitionMeta, sizeof(x->partitionMeta)) != 0 ||
+            (x->path == NULL) != (y->path == NULL) || (x->path && strcmp(x->path, y->path) != 0) ||
+            *x->lbaSize != a->lbaSize || *y->lbaSize != b->lbaSize)
+            return false;
+    }
+    return true;
+}
+
+static bool testContextEqual(const LibSpecialDrive *a, const LibSpecialDrive *b)
+{
+    if (a->commonBlockDeviceCount != b->commonBlockDeviceCount || a->specialBlockDeviceCount != b->specialBlockDeviceCount)
+        return false;
+    for (size_t i = 0; i < a->commonBlockDeviceCount; i++)
+    {
+        if (!testBlockEqual(&a->commonBlockDevices[i], &b->commonBlockDevices[i]))
+            return false;
+    }
+    for (size_t i = 0; i < a->specialBlockDeviceCount; i++)
+    {
+        if (!testBlockEqual(&a->specialBlockDevices[i], &b->specialBlockDevices[i]))
+            return false;
+    }
+    return true;
+}
+
+// O cache é gravado num temporário renomeado: inode igual, arquivo não regravado
+static bool testSameFile(const char *path, const struct stat *before)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && st.st_ino == before->st_ino && st.st_dev == before->st_dev;
+}
+
+// Grava a flag direto no arquivo. Com advance, adianta o mtime, como faria
+// outra ferramenta escrevendo pelo nó do disco; sem, o mtime fica como
+// estava, como numa escrita por outro nó do mesmo disco
+static bool testImageFlag(const char *directory, const char *name, uint8_t uuidSeed, bool advance)
+{
+    char path[4096];
+    if (!testPath(path, sizeof(path), directory, name))
+        return false;
+
+    LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
+    memset(flag.uuid, uuidSeed, sizeof(flag.uuid));
+
+    struct stat st;
+    int fd = stat(path, &st) == 0 ? open(path, O_WRONLY) : -1;
+    if (fd < 0)
+        return false;
+    bool ok = pwrite(fd, &flag, sizeof(flag), 0) == (ssize_t)sizeof(flag);
+    close(fd);
+
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    times[1].tv_sec += advance ? 10 : 0;
+    return ok && utimensat(AT_FDCWD, path, times, 0) == 0;
+}
+
+int main(void)
+{
+    char directory[4096], cacheDirectory[4096], cachePath[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testTempDir(cacheDirectory, sizeof(cacheDirectory)));
+    TEST_CHECK(testPath(cachePath, sizeof(cachePath), cacheDirectory, "probe.cache"));
+
+    TEST_CHECK(testImageCreate(directory, "sda.img", 2, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdc.img", 4, 0x5A));
+    TEST_CHECK(testImageCreate(directory, "sdd.img", 0, 0));
+
+    imageBackend = LibSpecialDriveBackendImageCreate(directory, 0);
+    TEST_CHECK(imageBackend != NULL);
+    if (!imageBackend)
+        return TEST_RESULT();
+    LibSpecialDrive_Backend backend = *imageBackend;
+    backend.open = countingOpen;
+
+    // Sem cache: sondagem completa, que grava o cache
+    LibSpecialDrive *probed = testContext(&backend, cachePath);
+    TEST_CHECK(probed && probed->commonBlockDeviceCount == 3 && probed->specialBlockDeviceCount == 1);
+    TEST_CHECK(opens >= 4);
+    struct stat st;
+    TEST_CHECK(stat(cachePath, &st) == 0 && st.st_size > 0);
+    if (!probed)
+        return TEST_RESULT();
+
+    // Início pelo cache: mesmo conteúdo, só a leitura da impressão digital
+    // e nada regravado
+    opens = 0;
+    LibSpecialDrive *cached = testContext(&backend, cachePath);
+    TEST_CHECK(cached != NULL);
+    TEST_CHECK(testOpenedOnce(4));
+    TEST_CHECK(testSameFile(cachePath, &st));
+    TEST_CHECK(cached && testContextEqual(probed, cached));
+    LibSpecialDriveDestroy(&cached);
+
+    // mtime mudado: a imagem vai direto à sondagem e a mudança aparece
+    TEST_CHECK(testImageFlag(directory, "sdb.img", 0x33, true));
+    opens = 0;
+    cached = testContext(&backend, cachePath);
+    TEST_CHECK(cached && cached->commonBlockDeviceCount == 2 && cached->specialBlockDeviceCount == 2);
+    TEST_CHECK(testOpenedOnce(4));
+    TEST_CHECK(!testSameFile(cachePath, &st));
+    LibSpecialDriveDestroy(&cached);
+
+    // Escrita sem mudar o mtime: a impressão digital a denuncia
+    TEST_CHECK(testImageFlag(directory, "sda.img", 0x44, false));
+    cached = testContext(&backend, cachePath);
+    TEST_CHECK(cached && cached->commonBlockDeviceCount == 1 && cached->specialBlockDeviceCount == 3);
+    LibSpecialDriveDestroy(&cached);
+
+    // O cache gravado depois da mudança volta a bastar
+    opens = 0;
+    cached = testContext(&backend, cachePath);
+    TEST_CHECK(cached && cached->specialBlockDeviceCount == 3);
+    TEST_CHECK(testOpenedOnce(4));
+    LibSpecialDriveDestroy(&cached);
+
+    // Cache corrompido: ignorado, sondagem completa
+    int fd = open(cachePath, O_RDWR);
+    TEST_CHECK(fd >= 0);
+    if (fd >= 0)
+    {
+        uint8_t byte = 0;
+        off_t offset = st.st_size / 2;
+        TEST_CHECK(pread(fd, &byte, 1, offset) == 1);
+        byte ^= 0xFF;
+        TEST_CHECK(pwrite(fd, &byte, 1, offset) == 1);
+        close(fd);
+    }
+    opens = 0;
+    cached = testContext(&backend, cachePath);
+    TEST_CHECK(cached && cached->commonBlockDeviceCount == 1 && cached->specialBlockDeviceCount == 3);
+    TEST_CHECK(opens >= 4);
+    LibSpecialDriveDestroy(&cached);
+
+    LibSpecialDriveDestroy(&probed);
+    LibSpecialDriveBackendImageDestroy(&imageBackend);
+    testTempDirRemove(directory);
+    testTempDirRemove(cacheDirectory);
+    return TEST_RESULT();
+}
@@ -0,0 +1,59 @@
+#include "LibSpecialDriveTest.h"
+
+// --- CRC-32 da GPT ---
+
+// Vetores conhecidos (mesmo resultado do crc32() do zlib) e a versão
+// acelerada contra a portátil em todos os tamanhos e alinhamentos que
+// passam pelos laços de 8 e 64 bytes e pelas sobras.
+
+static uint32_t testCrcText(const char *text)
+{
+    return LibSpecialDriveCrc32(0, text, strlen(text));
+}
+
+int main(void)
+{
+    TEST_CHECK(LibSpecialDriveCrc32(0, "", 0) == 0);
+    TEST_CHECK(testCrcText("a") == 0xE8B7BE43u);
+    TEST_CHECK(testCrcText("123456789") == 0xCBF43926u);
+    TEST_CHECK(testCrcText("The quick brown fox jumps over the lazy dog") == 0x414FA339u);
+
+    uint8_t zeros[32] = {0};
+    TEST_CHECK(LibSpecialDriveCrc32(0, zeros, sizeof(zeros)) == 0x190A55ADu);
+    TEST_CHECK(LibSpecialDriveCrc32Portable(0, zeros, sizeof(zeros)) == 0x190A55ADu);
+
+    // Encadeamento: o CRC de uma parte continua na seguinte
+    const char *text = "123456789";
+    for (size_t split = 0; split <= 9; split++)
+        TEST_CHECK(LibSpecialDriveCrc32(LibSpecialDriveCrc32(0, text, split), text + split, 9 - split) == 0xCBF43926u);
+
+    enum { MAX = 4096 + 16 };
+    uint8_t *data = malloc(MAX);
+    TEST_CHECK(data != NULL);
+    if (!data)
+        return TEST_RESULT();
+
+    uint32_t seed = 0x12345678u;
+    for (size_t i = 0; i < MAX; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+
+    int mismatches = 0;
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t len = 0; len + offset <= 4096; len += len < 256 ? 1 : 61)
+        {
+            if (LibSpecialDriveCrc32(0, data + offset, len) != LibSpecialDriveCrc32Portable(0, data + offset, len))
+                mismatches++;
+        }
+    }
+    TEST_CHECK(mismatches == 0);
+
+    // Estado inicial diferente de zero, como nas chamadas encadeadas
+    TEST_CHECK(LibSpecialDriveCrc32(0xDEADBEEFu, data + 3, MAX - 3) == LibSpecialDriveCrc32Portable(0xDEADBEEFu, data + 3, MAX - 3));
+
+    free(data);
+    return TEST_RESULT();
+}
@@ -0,0 +1,100 @@
+#include "LibSpecialDriveTest.h"
+
+// --- Aprofundamento da sondagem ---
+
+// Blocos sondados só com identidade ou só com a tabela são aprofundados até
+// as montagens depois que a tabela de montagens mudou. Os pontos de
+// montagem precisam vir da tabela atual, não da vista na enumeração.
+
+static LibSpecialDrive_Backend *imageBackend;
+static const char *mountTable = NULL; // tabela "do sistema"
+static const char *mountIndex = NULL; // o que o backend viu na última revalidação
+static int refreshes = 0;
+
+static void tableMount(void *user, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    (void)user;
+    (void)type;
+    part->mountPoint = mountIndex ? LibSpecialDriveArenaStrdup(arena, mountIndex) : NULL;
+}
+
+static bool tableRefresh(void *user)
+{
+    (void)user;
+    refreshes++;
+    bool changed = mountIndex != mountTable;
+    mountIndex = mountTable;
+    return changed;
+}
+
+static LibSpecialDrive *testContextDepth(LibSpecialDrive_Backend *backend, enum LibSpecialDrive_ProbeDepth depth)
+{
+    LibSpecialDrive_Options options;
+    memset(&options, 0, sizeof(options));
+    options.backend = backend;
+    options.depth = (uint8_t)depth;
+    return LibSpecialDriveGetEx(&options);
+}
+
+static bool testMounted(const LibSpecialDrive_BlockDevice *blk, const char *mountPoint)
+{
+    for (int i = 0; i < blk->partitionCount; i++)
+    {
+        if (!blk->partitions[i].mountPoint || strcmp(blk->partitions[i].mountPoint, mountPoint) != 0)
+            return false;
+    }
+    return blk->partitionCount > 0;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 2, 0));
+
+    imageBackend = LibSpecialDriveBackendImageCreate(directory, 0);
+    TEST_CHECK(imageBackend != NULL);
+    if (!imageBackend)
+        return TEST_RESULT();
+    LibSpecialDrive_Backend backend = *imageBackend;
+    backend.partitionMount = tableMount;
+    backend.mountTableRefresh = tableRefresh;
+
+    // Só identidade: a tabela de partições e as montagens vêm no Deepen
+    mountTable = "/mnt/old";
+    LibSpecialDrive *ctx = testContextDepth(&backend, PROBE_DEPTH_IDENTITY);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 1);
+    if (ctx && ctx->commonBlockDeviceCount == 1)
+    {
+        mountTable = "/mnt/identity";
+        refreshes = 0;
+        LibSpecialDrive_BlockDevice *blk = &ctx->commonBlockDevices[0];
+        TEST_CHECK(LibSpecialDriveDeepen(ctx, blk, PROBE_DEPTH_MOUNTS));
+        TEST_CHECK(refreshes == 1);
+        TEST_CHECK(blk->partitionCount == 2 && testMounted(blk, "/mnt/identity"));
+    }
+    LibSpecialDriveDestroy(&ctx);
+
+    // Tabela já lida: só as montagens faltam
+    ctx = testContextDepth(&backend, PROBE_DEPTH_PARTITIONS);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 1);
+    if (ctx && ctx->commonBlockDeviceCount == 1)
+    {
+        mountTable = "/mnt/partitions";
+        refreshes = 0;
+        LibSpecialDrive_BlockDevice *blk = &ctx->commonBlockDevices[0];
+        TEST_CHECK(blk->partitionCount == 2 && blk->partitions[0].mountPoint == NULL);
+        TEST_CHECK(LibSpecialDriveDeepen(ctx, blk, PROBE_DEPTH_MOUNTS));
+        TEST_CHECK(refreshes == 1);
+        TEST_CHECK(testMounted(blk, "/mnt/partitions"));
+
+        // Já nas montagens: nada a fazer, nem revalidar
+        TEST_CHECK(LibSpecialDriveDeepen(ctx, blk, PROBE_DEPTH_MOUNTS));
+        TEST_CHECK(refreshes == 1);
+    }
+    LibSpecialDriveDestroy(&ctx);
+
+    LibSpecialDriveBackendImageDestroy(&imageBackend);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
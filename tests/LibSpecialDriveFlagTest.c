@@ -0,0 +1,97 @@
+#include "LibSpecialDriveTest.h"
+
+// --- Marcações em lote ---
+
+// Índices válidos, fora da lista e repetidos no mesmo lote. Os índices
+// referem-se à lista como estava antes do lote; os resultados dizem onde cada
+// bloco ficou na lista de destino.
+
+static bool testEndsWith(const char *text, const char *suffix)
+{
+    size_t length = strlen(text);
+    size_t suffixLength = strlen(suffix);
+    return length >= suffixLength && strcmp(text + length - suffixLength, suffix) == 0;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdc.img", 2, 0));
+    TEST_CHECK(testImageCreate(directory, "sdd.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sde.img", 1, 0x11));
+
+    LibSpecialDrive_Backend *images = LibSpecialDriveBackendImageCreate(directory, 0);
+    LibSpecialDrive *ctx = testContext(images, NULL);
+    TEST_CHECK(ctx != NULL);
+    if (!ctx)
+        return TEST_RESULT();
+    TEST_CHECK(ctx->commonBlockDeviceCount == 4);
+    TEST_CHECK(ctx->specialBlockDeviceCount == 1);
+
+    // sdb, fora da lista, sdd, sdb de novo, negativo, sdc: mesmo depois de
+    // sdb sair da lista comum, 3 ainda é sdd e 2 ainda é sdc
+    const int indices[] = {1, 7, 3, 1, -1, 2};
+    const char *expected[] = {"sdb.img", NULL, "sdd.img", NULL, NULL, "sdc.img"};
+    enum { COUNT = sizeof(indices) / sizeof(indices[0]) };
+    LibSpecialDrive_FlagResult results[COUNT];
+
+    // Entradas inválidas fazem o lote retornar false, sem impedir as demais
+    TEST_CHECK(!LibSpecialDriveMarkBatch(ctx, indices, COUNT, results));
+    TEST_CHECK(ctx->commonBlockDeviceCount == 1);
+    TEST_CHECK(ctx->specialBlockDeviceCount == 4);
+    TEST_CHECK(testEndsWith(ctx->commonBlockDevices[0].path, "sda.img"));
+
+    for (int i = 0; i < COUNT; i++)
+    {
+        if (!expected[i])
+        {
+            TEST_CHECK(results[i].status == FLAG_STATUS_INVALID);
+            TEST_CHECK(results[i].index == -1);
+            continue;
+        }
+
+        TEST_CHECK(results[i].status == FLAG_STATUS_OK);
+        TEST_CHECK(results[i].index >= 0 && (size_t)results[i].index < ctx->specialBlockDeviceCount);
+        if (results[i].index < 0 || (size_t)results[i].index >= ctx->specialBlockDeviceCount)
+            continue;
+
+        LibSpecialDrive_BlockDevice *blk = &ctx->specialBlockDevices[results[i].index];
+        TEST_CHECK(testEndsWith(blk->path, expected[i]));
+        TEST_CHECK(memcmp(LibSpecialDriveIsSpecial(blk->signature)->uuid, results[i].uuid, sizeof(results[i].uuid)) == 0);
+    }
+
+    // Desmarcação com a mesma regra: 0 é sde e 3 é sdc antes do lote
+    const int unmark[] = {3, 0, 3, 9};
+    LibSpecialDrive_FlagResult unmarked[4];
+    TEST_CHECK(!LibSpecialDriveUnmarkBatch(ctx, unmark, 4, unmarked));
+    TEST_CHECK(unmarked[0].status == FLAG_STATUS_OK);
+    TEST_CHECK(unmarked[1].status == FLAG_STATUS_OK);
+    TEST_CHECK(unmarked[2].status == FLAG_STATUS_INVALID && unmarked[2].index == -1);
+    TEST_CHECK(unmarked[3].status == FLAG_STATUS_INVALID && unmarked[3].index == -1);
+    TEST_CHECK(ctx->commonBlockDeviceCount == 3);
+    TEST_CHECK(ctx->specialBlockDeviceCount == 2);
+    if (unmarked[0].index >= 0 && unmarked[1].index >= 0)
+    {
+        TEST_CHECK(testEndsWith(ctx->commonBlockDevices[unmarked[0].index].path, "sdc.img"));
+        TEST_CHECK(testEndsWith(ctx->commonBlockDevices[unmarked[1].index].path, "sde.img"));
+    }
+
+    // Sem contexto os resultados continuam definidos
+    LibSpecialDrive_FlagResult none[2];
+    memset(none, 0xFF, sizeof(none));
+    TEST_CHECK(!LibSpecialDriveMarkBatch(NULL, indices, 2, none));
+    TEST_CHECK(none[0].status == FLAG_STATUS_INVALID && none[1].index == -1);
+
+    // O que foi gravado vale para uma nova sondagem
+    LibSpecialDriveDestroy(&ctx);
+    ctx = testContext(images, NULL);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 3 && ctx->specialBlockDeviceCount == 2);
+    LibSpecialDriveDestroy(&ctx);
+
+    LibSpecialDriveBackendImageDestroy(&images);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+#include "LibSpecialDriveTest.h"
+
+// --- Espaço livre sob demanda ---
+
+// Nem a sondagem nem o recarregamento consultam o espaço livre: as
+// partições montadas chegam com freeSpaceMs 0. A consulta de uma partição
+// preenche só ela e não publica; a atualização em lote preenche as demais
+// e publica uma única vez.
+
+static const char *mountPoint;
+
+static void directoryMount(void *user, LibSpecialDrive_Partition *part, enum LibSpecialDrive_PartitionType type, LibSpecialDrive_Arena *arena)
+{
+    (void)user;
+    (void)type;
+    part->mountPoint = LibSpecialDriveArenaStrdup(arena, mountPoint);
+}
+
+// Partições montadas do contexto já consultadas
+static size_t testQueried(const LibSpecialDrive *ctx, size_t *mounted)
+{
+    size_t queried = 0;
+    *mounted = 0;
+    for (size_t i = 0; i < ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount; i++)
+    {
+        const LibSpecialDrive_BlockDevice *blk = i < ctx->commonBlockDeviceCount
+                                                     ? &ctx->commonBlockDevices[i]
+                                                     : &ctx->specialBlockDevices[i - ctx->commonBlockDeviceCount];
+        for (int p = 0; p < blk->partitionCount; p++)
+        {
+            *mounted += blk->partitions[p].mountPoint != NULL;
+            queried += blk->partitions[p].freeSpaceMs != 0;
+        }
+    }
+    return queried;
+}
+
+static uint64_t testSnapshotGeneration(LibSpecialDrive *ctx)
+{
+    const LibSpecialDrive_Snapshot *snapshot = LibSpecialDriveSnapshotAcquire(ctx);
+    uint64_t generation = snapshot ? snapshot->generation : 0;
+    LibSpecialDriveSnapshotRelease(&snapshot);
+    return generation;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 2, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 3, 0x11));
+    mountPoint = directory;
+
+    LibSpecialDrive_Backend *imageBackend = LibSpecialDriveBackendImageCreate(directory, 0);
+    TEST_CHECK(imageBackend != NULL);
+    if (!imageBackend)
+        return TEST_RESULT();
+    LibSpecialDrive_Backend backend = *imageBackend;
+    backend.partitionMount = directoryMount;
+
+    LibSpecialDrive *ctx = testContext(&backend, NULL);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 1 && ctx->specialBlockDeviceCount == 1);
+    if (!ctx)
+        return TEST_RESULT();
+
+    // Sondagem completa, nenhuma consulta
+    size_t mounted;
+    TEST_CHECK(testQueried(ctx, &mounted) == 0 && mounted == 5);
+
+    // Uma partição: consultada, sem publicação
+    uint64_t generation = testSnapshotGeneration(ctx);
+    LibSpecialDrive_Partition *part = &ctx->commonBlockDevices[0].partitions[0];
+    TEST_CHECK(LibSpecialDriveGetFreeSpace(ctx, part) > 0 && part->freeSpaceMs != 0);
+    TEST_CHECK(testQueried(ctx, &mounted) == 1);
+    TEST_CHECK(testSnapshotGeneration(ctx) == generation);
+
+    // Em lote: só as vencidas, uma publicação
+    TEST_CHECK(LibSpecialDriveRefreshFreeSpace(ctx, false) == 4);
+    TEST_CHECK(testQueried(ctx, &mounted) == 5);
+    TEST_CHECK(testSnapshotGeneration(ctx) == generation + 1);
+
+    // Dentro da validade nada é consultado nem publicado
+    TEST_CHECK(LibSpecialDriveRefreshFreeSpace(ctx, false) == 0);
+    TEST_CHECK(testSnapshotGeneration(ctx) == generation + 1);
+
+    // O recarregamento também não consulta: o disco alterado volta sem valor
+    TEST_CHECK(testImageCreate(directory, "sda.img", 1, 0));
+    TEST_CHECK(LibSpecialDriveReloadDiff(ctx, NULL));
+    TEST_CHECK(testQueried(ctx, &mounted) == 3 && mounted == 4);
+
+    LibSpecialDriveDestroy(&ctx);
+    LibSpecialDriveBackendImageDestroy(&imageBackend);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
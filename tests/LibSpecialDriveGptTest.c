@@ -0,0 +1,143 @@
+#include "LibSpecialDriveTest.h"
+
+// --- Validação da GPT e cópia de backup ---
+
+// Imagens GPT com duas partições: íntegra, cabeçalho primário corrompido,
+// cabeçalho primário íntegro apontando o backup para fora do disco com a
+// tabela primária corrompida, e as duas cópias corrompidas.
+
+#define LBA 512u
+#define LBAS (TEST_DISK_SIZE / LBA)
+#define ENTRIES 128u
+#define ENTRY_LBAS (ENTRIES * sizeof(LibSpecialDrive_GPT_Partition_Entry) / LBA)
+
+enum
+{
+    GPT_INTACT,
+    GPT_PRIMARY_HEADER_BAD,
+    GPT_PRIMARY_TABLE_BAD_BACKUP_LBA_BOGUS,
+    GPT_BOTH_BAD
+};
+
+static void testGptHeaderCrc(LibSpecialDrive_GPT_Header *header)
+{
+    header->crc32 = 0;
+    header->crc32 = LibSpecialDriveCrc32(0, header, header->headerSize);
+}
+
+static bool testGptImageCreate(const char *directory, const char *name, int damage)
+{
+    char path[4096];
+    if (!testPath(path, sizeof(path), directory, name))
+        return false;
+
+    uint8_t *disk = calloc(1, TEST_DISK_SIZE);
+    if (!disk)
+        return false;
+
+    LibSpecialDrive_Protective_MBR *mbr = (void *)disk;
+    mbr->partitions[0].partitionType = 0xEE;
+    mbr->partitions[0].firstLBA = 1;
+    mbr->partitions[0].sectors = LBAS - 1;
+    mbr->signature = 0xAA55;
+
+    LibSpecialDrive_GPT_Partition_Entry entries[ENTRIES];
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < 2; i++)
+    {
+        memset(entries[i].partitionTypeGuid, 0xA0 + i, 16);
+        memset(entries[i].uniquePartitionGuid, 0xB0 + i, 16);
+        entries[i].startingLba = 2048 + (uint64_t)i * 2048;
+        entries[i].endingLba = entries[i].startingLba + 2047;
+    }
+
+    LibSpecialDrive_GPT_Header primary;
+    memset(&primary, 0, sizeof(primary));
+    memcpy(&primary.signature, GPT_SIGNATURE, 8);
+    primary.revision = 0x00010000;
+    primary.headerSize = sizeof(primary);
+    primary.currentLba = 1;
+    primary.backupLba = LBAS - 1;
+    primary.firstUsableLba = 2 + ENTRY_LBAS;
+    primary.lastUsableLba = LBAS - 2 - ENTRY_LBAS;
+    primary.partitionEntriesLba = 2;
+    primary.numPartitionEntries = ENTRIES;
+    primary.sizeOfPartitionEntry = sizeof(LibSpecialDrive_GPT_Partition_Entry);
+    primary.partitionEntriesCrc32 = LibSpecialDriveCrc32(0, entries, sizeof(entries));
+
+    LibSpecialDrive_GPT_Header backup = primary;
+    backup.currentLba = LBAS - 1;
+    backup.backupLba = 1;
+    backup.partitionEntriesLba = LBAS - 1 - ENTRY_LBAS;
+    testGptHeaderCrc(&backup);
+
+    if (damage == GPT_PRIMARY_TABLE_BAD_BACKUP_LBA_BOGUS)
+        primary.backupLba = (uint64_t)LBAS * 1000;
+    testGptHeaderCrc(&primary);
+
+    memcpy(disk + LBA, &primary, sizeof(primary));
+    memcpy(disk + 2 * LBA, entries, sizeof(entries));
+    memcpy(disk + backup.partitionEntriesLba * LBA, entries, sizeof(entries));
+    memcpy(disk + backup.currentLba * LBA, &backup, sizeof(backup));
+
+    // Corrompe depois dos CRCs calculados
+    if (damage == GPT_PRIMARY_HEADER_BAD || damage == GPT_BOTH_BAD)
+        disk[LBA + offsetof(LibSpecialDrive_GPT_Header, firstUsableLba)] ^= 0xFF;
+    if (damage == GPT_PRIMARY_TABLE_BAD_BACKUP_LBA_BOGUS)
+        disk[2 * LBA + 40] ^= 0xFF;
+    if (damage == GPT_BOTH_BAD)
+        disk[backup.currentLba * LBA + offsetof(LibSpecialDrive_GPT_Header, firstUsableLba)] ^= 0xFF;
+
+    FILE *file = fopen(path, "wb");
+    bool ok = file && fwrite(disk, TEST_DISK_SIZE, 1, file) == 1;
+    if (file && fclose(file) != 0)
+        ok = false;
+    free(disk);
+    return ok;
+}
+
+static LibSpecialDrive_BlockDevice *testFind(LibSpecialDrive *ctx, const char *name)
+{
+    for (size_t i = 0; i < ctx->commonBlockDeviceCount; i++)
+    {
+        const char *slash = strrchr(ctx->commonBlockDevices[i].path, '/');
+        if (slash && strcmp(slash + 1, name) == 0)
+            return &ctx->commonBlockDevices[i];
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testGptImageCreate(directory, "intact.img", GPT_INTACT));
+    TEST_CHECK(testGptImageCreate(directory, "header.img", GPT_PRIMARY_HEADER_BAD));
+    TEST_CHECK(testGptImageCreate(directory, "bogus.img", GPT_PRIMARY_TABLE_BAD_BACKUP_LBA_BOGUS));
+    TEST_CHECK(testGptImageCreate(directory, "both.img", GPT_BOTH_BAD));
+
+    LibSpecialDrive_Backend *images = LibSpecialDriveBackendImageCreate(directory, LBA);
+    LibSpecialDrive *ctx = testContext(images, NULL);
+    TEST_CHECK(ctx != NULL);
+    if (!ctx)
+        return TEST_RESULT();
+
+    LibSpecialDrive_BlockDevice *intact = testFind(ctx, "intact.img");
+    TEST_CHECK(intact && intact->type == PARTITION_TYPE_GPT && intact->partitionCount == 2);
+    TEST_CHECK(intact && !(intact->flags & (BLOCK_FLAG_GPT_FROM_BACKUP | BLOCK_FLAG_GPT_CORRUPT)));
+
+    LibSpecialDrive_BlockDevice *header = testFind(ctx, "header.img");
+    TEST_CHECK(header && header->partitionCount == 2 && (header->flags & BLOCK_FLAG_GPT_FROM_BACKUP));
+
+    // O backupLba fora do disco é ignorado e o backup vem do último LBA
+    LibSpecialDrive_BlockDevice *bogus = testFind(ctx, "bogus.img");
+    TEST_CHECK(bogus && bogus->partitionCount == 2 && (bogus->flags & BLOCK_FLAG_GPT_FROM_BACKUP));
+
+    LibSpecialDrive_BlockDevice *both = testFind(ctx, "both.img");
+    TEST_CHECK(both && both->type == PARTITION_TYPE_GPT && both->partitionCount == 0 && (both->flags & BLOCK_FLAG_GPT_CORRUPT));
+
+    LibSpecialDriveDestroy(&ctx);
+    LibSpecialDriveBackendImageDestroy(&images);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
@@ -0,0 +1,113 @@
+#include "LibSpecialDriveTest.h"
+
+// --- Recarregamento incremental ---
+
+// Mudanças relatadas por ReloadDiff e ReloadDevices, conteúdo preservado dos
+// blocos mantidos, layoutGeneration avançando a cada troca dos vetores e
+// falha da descoberta deixando contexto e lista de mudanças como estavam.
+
+static LibSpecialDrive_BlockDevice *testFind(LibSpecialDrive *ctx, const char *name)
+{
+    size_t total = ctx->commonBlockDeviceCount + ctx->specialBlockDeviceCount;
+    for (size_t i = 0; i < total; i++)
+    {
+        LibSpecialDrive_BlockDevice *blk = i < ctx->commonBlockDeviceCount
+                                               ? &ctx->commonBlockDevices[i]
+                                               : &ctx->specialBlockDevices[i - ctx->commonBlockDeviceCount];
+        const char *slash = strrchr(blk->path, '/');
+        if (slash && strcmp(slash + 1, name) == 0)
+            return blk;
+    }
+    return NULL;
+}
+
+static bool testHasChange(const LibSpecialDrive_ChangeList *changes, enum LibSpecialDrive_ChangeType type, const char *name)
+{
+    for (size_t i = 0; i < changes->count; i++)
+    {
+        const char *slash = strrchr(changes->items[i].path, '/');
+        if (changes->items[i].type == type && slash && strcmp(slash + 1, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 2, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdc.img", 1, 0x22));
+
+    LibSpecialDrive_Backend *imageBackend = LibSpecialDriveBackendImageCreate(directory, 0);
+    TEST_CHECK(imageBackend != NULL);
+    if (!imageBackend)
+        return TEST_RESULT();
+    LibSpecialDrive_Backend backend = testFailingBackend(imageBackend);
+
+    LibSpecialDrive *ctx = testContext(&backend, NULL);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 2 && ctx->specialBlockDeviceCount == 1);
+    if (!ctx)
+        return TEST_RESULT();
+
+    // Nada mudou: nenhuma mudança, mesmo conteúdo, vetores novos
+    LibSpecialDrive_BlockDevice before = *testFind(ctx, "sda.img");
+    LibSpecialDrive_Protective_MBR signature = *before.signature;
+    LibSpecialDrive_Partition firstPartition = before.partitions[0];
+    uint64_t generation = ctx->layoutGeneration;
+    LibSpecialDrive_ChangeList changes = {0};
+    TEST_CHECK(LibSpecialDriveReloadDiff(ctx, &changes));
+    TEST_CHECK(changes.count == 0);
+    TEST_CHECK(ctx->layoutGeneration > generation);
+    LibSpecialDrive_BlockDevice *sda = testFind(ctx, "sda.img");
+    TEST_CHECK(sda && sda->partitionCount == 2 && sda->size == before.size && sda->devId == before.devId);
+    TEST_CHECK(sda && memcmp(sda->signature, &signature, sizeof(signature)) == 0);
+    TEST_CHECK(sda && memcmp(&sda->partitions[0].partitionMeta, &firstPartition.partitionMeta, sizeof(firstPartition.partitionMeta)) == 0);
+
+    // Disco novo, disco alterado e disco removido numa única recarga
+    char path[4096];
+    TEST_CHECK(testImageCreate(directory, "sdd.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 3, 0));
+    TEST_CHECK(testPath(path, sizeof(path), directory, "sdc.img") && unlink(path) == 0);
+    generation = ctx->layoutGeneration;
+    TEST_CHECK(LibSpecialDriveReloadDiff(ctx, &changes));
+    TEST_CHECK(changes.count == 3);
+    TEST_CHECK(testHasChange(&changes, CHANGE_ADDED, "sdd.img"));
+    TEST_CHECK(testHasChange(&changes, CHANGE_CHANGED, "sdb.img"));
+    TEST_CHECK(testHasChange(&changes, CHANGE_REMOVED, "sdc.img"));
+    TEST_CHECK(ctx->layoutGeneration > generation);
+    TEST_CHECK(ctx->commonBlockDeviceCount == 3 && ctx->specialBlockDeviceCount == 0);
+    LibSpecialDrive_BlockDevice *sdb = testFind(ctx, "sdb.img");
+    TEST_CHECK(sdb && sdb->partitionCount == 3);
+
+    // Descoberta que falha: contexto, geração e mudanças anteriores intactos
+    testFailDiscover = true;
+    generation = ctx->layoutGeneration;
+    TEST_CHECK(!LibSpecialDriveReloadDiff(ctx, &changes));
+    TEST_CHECK(changes.count == 3);
+    TEST_CHECK(ctx->layoutGeneration == generation && ctx->commonBlockDeviceCount == 3);
+    testFailDiscover = false;
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Só o caminho pedido é sondado; os demais ficam como estavam
+    TEST_CHECK(testImageCreate(directory, "sda.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdd.img", 2, 0));
+    TEST_CHECK(testPath(path, sizeof(path), directory, "sdd.img"));
+    const char *const paths[] = {path};
+    TEST_CHECK(LibSpecialDriveReloadDevices(ctx, paths, 1, &changes));
+    TEST_CHECK(changes.count == 1 && testHasChange(&changes, CHANGE_CHANGED, "sdd.img"));
+    sda = testFind(ctx, "sda.img");
+    TEST_CHECK(sda && sda->partitionCount == 2);
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Marcar move o bloco para a outra lista e também avança a geração
+    generation = ctx->layoutGeneration;
+    TEST_CHECK(LibSpecialDriveMark(ctx, 0));
+    TEST_CHECK(ctx->layoutGeneration > generation && ctx->specialBlockDeviceCount == 1);
+
+    LibSpecialDriveDestroy(&ctx);
+    LibSpecialDriveBackendImageDestroy(&imageBackend);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+#include "LibSpecialDriveTest.h"
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+// --- Segmento compartilhado sob concorrência ---
+
+// O publicador alterna entre dois contextos de tamanhos diferentes enquanto
+// leitores, cada um com o próprio mapeamento, leem sem parar. O segmento
+// nasce do tamanho do contexto pequeno, então o grande o faz crescer com os
+// leitores já abertos. Uma leitura rasgada pelo seqlock ou um remapeamento
+// errado aparece como contexto que não corresponde à geração, geração fora
+// de ordem ou, com ASan, acesso fora da cópia. A falha ao publicar chega ao
+// resultado do LibSpecialDriveGetEx.
+
+#define READERS 4
+#define PUBLISHES 5000
+#define LARGE_DISKS 48
+
+typedef struct
+{
+    const char *name;
+    const char *directories[2];
+    size_t counts[2];
+    volatile int stop;
+    volatile int errors;
+    volatile long reads;
+} ShmTest;
+
+static bool testFromDirectory(const LibSpecialDrive *view, const char *directory)
+{
+    size_t length = strlen(directory);
+    for (size_t i = 0; i < view->commonBlockDeviceCount; i++)
+    {
+        if (strncmp(view->commonBlockDevices[i].path, directory, length) != 0)
+            return false;
+    }
+    for (size_t i = 0; i < view->specialBlockDeviceCount; i++)
+    {
+        if (strncmp(view->specialBlockDevices[i].path, directory, length) != 0)
+            return false;
+    }
+    return true;
+}
+
+// A publicação 1 é o contexto 0; a partir da 2 eles se alternam, então a
+// geração também diz qual contexto o leitor deveria ver
+static bool testConsistent(const ShmTest *test, const LibSpecialDrive *view, uint64_t generation)
+{
+    int i = generation < 2 ? 0 : (int)((generation - 2) & 1);
+    size_t total = view->commonBlockDeviceCount + view->specialBlockDeviceCount;
+    return total == test->counts[i] && view->specialBlockDeviceCount == 1 && testFromDirectory(view, test->directories[i]);
+}
+
+static void *shmReader(void *arg)
+{
+    ShmTest *test = arg;
+    LibSpecialDrive_ShmReader *reader = LibSpecialDriveShmReaderOpen(test->name);
+    if (!reader)
+    {
+        __atomic_add_fetch(&test->errors, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    uint64_t last = 0;
+    while (!__atomic_load_n(&test->stop, __ATOMIC_ACQUIRE))
+    {
+        uint64_t generation = 0;
+        const LibSpecialDrive *view = LibSpecialDriveShmReaderGet(reader, &generation);
+        if (!view || generation < last || !testConsistent(test, view, generation))
+            __atomic_add_fetch(&test->errors, 1, __ATOMIC_RELAXED);
+        last = generation;
+        __atomic_add_fetch(&test->reads, 1, __ATOMIC_RELAXED);
+    }
+
+    LibSpecialDriveShmReaderClose(&reader);
+    return NULL;
+}
+
+int main(void)
+{
+    char directories[2][4096];
+    TEST_CHECK(testTempDir(directories[0], sizeof(directories[0])));
+    TEST_CHECK(testTempDir(directories[1], sizeof(directories[1])));
+    TEST_CHECK(testImageCreate(directories[0], "sda.img", 2, 0));
+    TEST_CHECK(testImageCreate(directories[0], "sdb.img", 1, 0x11));
+    for (int i = 0; i < LARGE_DISKS; i++)
+    {
+        char image[32];
+        snprintf(image, sizeof(image), "sd%02d.img", i);
+        TEST_CHECK(testImageCreate(directories[1], image, i % 5, i == 7 ? 0x22 : 0));
+    }
+
+    LibSpecialDrive_Backend *images[2] = {LibSpecialDriveBackendImageCreate(directories[0], 0),
+                                          LibSpecialDriveBackendImageCreate(directories[1], 0)};
+    LibSpecialDrive *contexts[2] = {testContext(images[0], NULL), testContext(images[1], NULL)};
+    TEST_CHECK(contexts[0] && contexts[1]);
+    if (!contexts[0] || !contexts[1])
+        return TEST_RESULT();
+
+    char name[64];
+    snprintf(name, sizeof(name), "/specialdrive-test-%ld", (long)getpid());
+    ShmTest test = {name, {directories[0], directories[1]}, {2, LARGE_DISKS}, 0, 0, 0};
+
+    // Sem segmento não há leitor; segmento sem publicação ainda não tem contexto
+    TEST_CHECK(LibSpecialDriveShmReaderOpen(name) == NULL);
+    LibSpecialDrive_ShmPublisher *publisher = LibSpecialDriveShmPublisherCreate(name, 0);
+    TEST_CHECK(publisher != NULL);
+    if (!publisher)
+        return TEST_RESULT();
+    TEST_CHECK(LibSpecialDriveShmPublisherCreate(name, 0) == NULL);
+
+    LibSpecialDrive_ShmReader *reader = LibSpecialDriveShmReaderOpen(name);
+    TEST_CHECK(reader != NULL);
+    TEST_CHECK(LibSpecialDriveShmReaderGet(reader, NULL) == NULL);
+
+    // Sem publicação nova o leitor devolve o mesmo contexto
+    uint64_t generation = 0;
+    TEST_CHECK(LibSpecialDriveShmPublish(publisher, contexts[0]));
+    const LibSpecialDrive *view = LibSpecialDriveShmReaderGet(reader, &generation);
+    TEST_CHECK(view && generation == 1 && testConsistent(&test, view, generation));
+    TEST_CHECK(LibSpecialDriveShmReaderGet(reader, NULL) == view);
+
+    pthread_t readers[READERS];
+    for (int i = 0; i < READERS; i++)
+        TEST_CHECK(pthread_create(&readers[i], NULL, shmReader, &test) == 0);
+
+    for (int i = 0; i < PUBLISHES; i++)
+        TEST_CHECK(LibSpecialDriveShmPublish(publisher, contexts[i & 1]));
+
+    __atomic_store_n(&test.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < READERS; i++)
+        pthread_join(readers[i], NULL);
+
+    TEST_CHECK(test.errors == 0);
+    TEST_CHECK(test.reads > 0);
+
+    // A última publicação sobrevive ao publicador; um novo continua a contagem
+    LibSpecialDriveShmPublisherDestroy(&publisher);
+    view = LibSpecialDriveShmReaderGet(reader, &generation);
+    TEST_CHECK(view && generation == PUBLISHES + 1 && view->commonBlockDeviceCount == LARGE_DISKS - 1);
+
+    publisher = LibSpecialDriveShmPublisherCreate(name, 0);
+    TEST_CHECK(publisher != NULL);
+    TEST_CHECK(LibSpecialDriveShmPublish(publisher, contexts[0]));
+    view = LibSpecialDriveShmReaderGet(reader, &generation);
+    TEST_CHECK(view && generation == PUBLISHES + 2 && view->commonBlockDeviceCount == 1);
+    LibSpecialDriveShmPublisherDestroy(&publisher);
+    LibSpecialDriveShmReaderClose(&reader);
+    TEST_CHECK(LibSpecialDriveShmUnlink(name));
+
+    // Capacidade pedida menor que a imagem: o segmento cresce já na
+    // primeira publicação e de novo quando o contexto grande chega
+    snprintf(name, sizeof(name), "/specialdrive-test-small-%ld", (long)getpid());
+    publisher = LibSpecialDriveShmPublisherCreate(name, 64);
+    reader = LibSpecialDriveShmReaderOpen(name);
+    TEST_CHECK(publisher && reader);
+    TEST_CHECK(LibSpecialDriveShmPublish(publisher, contexts[0]));
+    view = LibSpecialDriveShmReaderGet(reader, &generation);
+    TEST_CHECK(view && generation == 1 && testConsistent(&test, view, generation));
+    TEST_CHECK(LibSpecialDriveShmPublish(publisher, contexts[1]));
+    view = LibSpecialDriveShmReaderGet(reader, &generation);
+    TEST_CHECK(view && generation == 2 && view->commonBlockDeviceCount == LARGE_DISKS - 1);
+    LibSpecialDriveShmReaderClose(&reader);
+    LibSpecialDriveShmPublisherDestroy(&publisher);
+    TEST_CHECK(LibSpecialDriveShmUnlink(name));
+
+    // Segmento de dados impossível de criar (nome longo demais para o
+    // sufixo do número): o contexto não é entregue
+    char longName[256];
+    memset(longName, 'x', sizeof(longName));
+    longName[0] = '/';
+    longName[254] = '\0';
+    LibSpecialDrive_Options options;
+    memset(&options, 0, sizeof(options));
+    options.backend = images[0];
+    options.shmName = longName;
+    LibSpecialDrive *unpublished = LibSpecialDriveGetEx(&options);
+    TEST_CHECK(unpublished == NULL);
+    LibSpecialDriveDestroy(&unpublished);
+    LibSpecialDriveShmUnlink(longName);
+
+    for (int i = 0; i < 2; i++)
+    {
+        LibSpecialDriveDestroy(&contexts[i]);
+        LibSpecialDriveBackendImageDestroy(&images[i]);
+        testTempDirRemove(directories[i]);
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,89 @@
+#include "LibSpecialDriveTest.h"
+#include <pthread.h>
+
+// --- Instantâneos sob concorrência ---
+
+// Leitores fixam e soltam o instantâneo sem parar enquanto o escritor
+// publica um atrás do outro. Um instantâneo liberado cedo demais aparece
+// como geração fora de ordem, contagem errada ou, com ASan, uso após free.
+
+#define READERS 4
+#define PUBLISHES 20000
+#define DISKS 3
+
+typedef struct
+{
+    LibSpecialDrive *ctx;
+    volatile int stop;
+    volatile int errors;
+    volatile long acquired;
+} SnapshotTest;
+
+static void *snapshotReader(void *arg)
+{
+    SnapshotTest *test = arg;
+    uint64_t last = 0;
+
+    while (!__atomic_load_n(&test->stop, __ATOMIC_ACQUIRE))
+    {
+        const LibSpecialDrive_Snapshot *snapshot = LibSpecialDriveSnapshotAcquire(test->ctx);
+        if (!snapshot)
+        {
+            __atomic_add_fetch(&test->errors, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        size_t total = snapshot->view.commonBlockDeviceCount + snapshot->view.specialBlockDeviceCount;
+        bool ok = snapshot->generation >= last && total == DISKS && snapshot->refs > 0;
+        for (size_t i = 0; i < snapshot->view.commonBlockDeviceCount; i++)
+            ok = ok && snapshot->view.commonBlockDevices[i].path[0] == '/';
+        last = snapshot->generation;
+
+        LibSpecialDriveSnapshotRelease(&snapshot);
+        if (!ok)
+            __atomic_add_fetch(&test->errors, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&test->acquired, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 2, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdc.img", 1, 0x5A));
+
+    LibSpecialDrive_Backend *images = LibSpecialDriveBackendImageCreate(directory, 0);
+    SnapshotTest test = {testContext(images, NULL), 0, 0, 0};
+    TEST_CHECK(test.ctx != NULL);
+    if (!test.ctx)
+        return TEST_RESULT();
+
+    pthread_t readers[READERS];
+    for (int i = 0; i < READERS; i++)
+        TEST_CHECK(pthread_create(&readers[i], NULL, snapshotReader, &test) == 0);
+
+    // Publicações coladas: o cenário em que a fixação por paridade falhava
+    for (int i = 0; i < PUBLISHES; i++)
+        TEST_CHECK(LibSpecialDriveSnapshotPublish(test.ctx));
+
+    __atomic_store_n(&test.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < READERS; i++)
+        pthread_join(readers[i], NULL);
+
+    TEST_CHECK(test.errors == 0);
+    TEST_CHECK(test.acquired > 0);
+
+    // Referência mantida além da destruição do contexto continua válida
+    const LibSpecialDrive_Snapshot *kept = LibSpecialDriveSnapshotAcquire(test.ctx);
+    TEST_CHECK(kept && kept->generation == (uint64_t)PUBLISHES + 1);
+    LibSpecialDriveDestroy(&test.ctx);
+    TEST_CHECK(kept && kept->view.specialBlockDeviceCount == 1);
+    LibSpecialDriveSnapshotRelease(&kept);
+
+    LibSpecialDriveBackendImageDestroy(&images);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
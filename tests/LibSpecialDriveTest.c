@@ -0,0 +1,108 @@
+#include "LibSpecialDriveTest.h"
+#include <dirent.h>
+
+// --- Apoio comum dos testes ---
+
+int testFailures = 0;
+bool testFailDiscover = false;
+
+static const LibSpecialDrive_Backend *failingImages;
+
+// Diretório temporário próprio do teste
+bool testTempDir(char *directory, size_t size)
+{
+    const char *base = getenv("TMPDIR");
+    snprintf(directory, size, "%s/specialdrive-test.XXXXXX", base && *base ? base : "/tmp");
+    return mkdtemp(directory) != NULL;
+}
+
+// Remove os arquivos do diretório e o próprio diretório
+void testTempDirRemove(const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (dir)
+    {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] == '.')
+                continue;
+            char path[4096];
+            if (testPath(path, sizeof(path), directory, entry->d_name))
+                unlink(path);
+        }
+        closedir(dir);
+    }
+    rmdir(directory);
+}
+
+// directory/name em path; false se não couber
+bool testPath(char *path, size_t size, const char *directory, const char *name)
+{
+    int written = snprintf(path, size, "%s/%s", directory, name);
+    return written > 0 && (size_t)written < size;
+}
+
+// Imagem esparsa de TEST_DISK_SIZE bytes com MBR de partitions partições
+// (até 4) e, se uuidSeed não for 0, a flag de dispositivo especial com um
+// UUID derivado dele
+bool testImageCreate(const char *directory, const char *name, int partitions, uint8_t uuidSeed)
+{
+    char path[4096];
+    if (!testPath(path, sizeof(path), directory, name))
+        return false;
+
+    LibSpecialDrive_Protective_MBR mbr;
+    memset(&mbr, 0, sizeof(mbr));
+    if (uuidSeed)
+    {
+        LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
+        memset(flag.uuid, uuidSeed, sizeof(flag.uuid));
+        memcpy(mbr.boot_code, &flag, sizeof(flag));
+    }
+    uint32_t each = (TEST_DISK_SIZE / 512 - 2048) / 4;
+    for (int p = 0; p < partitions && p < 4; p++)
+    {
+        mbr.partitions[p].partitionType = 0x83;
+        mbr.partitions[p].firstLBA = 2048 + (uint32_t)p * each;
+        mbr.partitions[p].sectors = each;
+    }
+    mbr.signature = 0xAA55;
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    uint8_t last = 0;
+    bool ok = fwrite(&mbr, sizeof(mbr), 1, file) == 1 &&
+              fseek(file, TEST_DISK_SIZE - 1, SEEK_SET) == 0 &&
+              fwrite(&last, 1, 1, file) == 1;
+    return fclose(file) == 0 && ok;
+}
+
+// Contexto sobre o backend de imagens; cachePath pode ser NULL
+LibSpecialDrive *testContext(LibSpecialDrive_Backend *backend, const char *cachePath)
+{
+    LibSpecialDrive_Options options;
+    memset(&options, 0, sizeof(options));
+    options.backend = backend;
+    options.cachePath = cachePath;
+    return LibSpecialDriveGetEx(&options);
+}
+
+static bool testFailingDiscover(void *user, const LibSpecialDrive_Options *options, LibSpecialDrive_DiscoverCallback callback, void *callbackUser)
+{
+    (void)user;
+    if (testFailDiscover)
+        return false;
+    return failingImages->discover(failingImages->user, options, callback, callbackUser);
+}
+
+// Cópia do backend de imagens cuja descoberta falha com testFailDiscover;
+// images deve viver mais que a cópia (um backend assim por teste)
+LibSpecialDrive_Backend testFailingBackend(const LibSpecialDrive_Backend *images)
+{
+    failingImages = images;
+    LibSpecialDrive_Backend backend = *images;
+    backend.discover = testFailingDiscover;
+    return backend;
+}
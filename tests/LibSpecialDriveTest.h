@@ -0,0 +1,40 @@
+#ifndef LIBSPECIALDRIVE_TEST_H
+#define LIBSPECIALDRIVE_TEST_H
+
+#include <LibSpecialDrive.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// --- Apoio comum dos testes (LibSpecialDriveTest.c) ---
+
+// Cada verificação que falha é contada e mostrada; o teste termina com
+// TEST_RESULT(), que vira o código de saída lido pelo ctest
+extern int testFailures;
+
+#define TEST_CHECK(cond)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(cond))                                                              \
+        {                                                                         \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);   \
+            testFailures++;                                                       \
+        }                                                                         \
+    } while (0)
+
+#define TEST_RESULT() (testFailures == 0 ? 0 : 1)
+
+#define TEST_DISK_SIZE (4u * 1024 * 1024)
+
+// Descoberta de testFailingBackend falha enquanto for true
+extern bool testFailDiscover;
+
+bool testTempDir(char *directory, size_t size);
+void testTempDirRemove(const char *directory);
+bool testPath(char *path, size_t size, const char *directory, const char *name);
+bool testImageCreate(const char *directory, const char *name, int partitions, uint8_t uuidSeed);
+LibSpecialDrive *testContext(LibSpecialDrive_Backend *backend, const char *cachePath);
+LibSpecialDrive_Backend testFailingBackend(const LibSpecialDrive_Backend *images);
+
+#endif
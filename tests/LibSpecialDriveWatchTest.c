@@ -0,0 +1,202 @@
+#include "LibSpecialDriveTest.h"
+#include <time.h>
+
+// --- Observador com fonte de eventos sintética ---
+
+// Os eventos saem de uma fila montada pelo teste e nomeiam imagens do
+// diretório do backend (devDirectory). Cobre entrada, rajada coalescida,
+// remoção, eventos perdidos, debounce e falha da recarga.
+
+#define EVENTS_MAX 32
+
+typedef struct
+{
+    LibSpecialDrive_UEvent events[EVENTS_MAX];
+    int results[EVENTS_MAX]; // 1 = evento, -1 = eventos perdidos
+    size_t count;
+    size_t next;
+} SyntheticSource;
+
+typedef struct
+{
+    int calls;
+    size_t changes;
+} CallbackCount;
+
+static int syntheticNext(void *user, LibSpecialDrive_UEvent *event)
+{
+    SyntheticSource *source = user;
+    if (source->next == source->count)
+        return 0;
+
+    *event = source->events[source->next];
+    return source->results[source->next++];
+}
+
+static void syntheticPush(SyntheticSource *source, const char *action, const char *devName, const char *devType, const char *devPath)
+{
+    if (source->count == EVENTS_MAX)
+        return;
+
+    LibSpecialDrive_UEvent *event = &source->events[source->count];
+    memset(event, 0, sizeof(*event));
+    snprintf(event->action, sizeof(event->action), "%s", action);
+    snprintf(event->devName, sizeof(event->devName), "%s", devName);
+    snprintf(event->devType, sizeof(event->devType), "%s", devType);
+    snprintf(event->devPath, sizeof(event->devPath), "%s", devPath);
+    source->results[source->count++] = 1;
+}
+
+static void syntheticLost(SyntheticSource *source)
+{
+    if (source->count == EVENTS_MAX)
+        return;
+
+    memset(&source->events[source->count], 0, sizeof(source->events[0]));
+    source->results[source->count++] = -1;
+}
+
+static void testCallback(LibSpecialDrive *ctx, const LibSpecialDrive_ChangeList *changes, void *user)
+{
+    (void)ctx;
+    CallbackCount *count = user;
+    count->calls++;
+    count->changes += changes->count;
+}
+
+static bool testSingleChange(const LibSpecialDrive_ChangeList *changes, enum LibSpecialDrive_ChangeType type, const char *name)
+{
+    if (changes->count != 1 || changes->items[0].type != type)
+        return false;
+
+    const char *slash = strrchr(changes->items[0].path, '/');
+    return slash && strcmp(slash + 1, name) == 0;
+}
+
+static void testSleepMs(long ms)
+{
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+int main(void)
+{
+    char directory[4096];
+    TEST_CHECK(testTempDir(directory, sizeof(directory)));
+    TEST_CHECK(testImageCreate(directory, "sda.img", 1, 0));
+    TEST_CHECK(testImageCreate(directory, "sdb.img", 2, 0));
+
+    LibSpecialDrive_Backend *imageBackend = LibSpecialDriveBackendImageCreate(directory, 0);
+    TEST_CHECK(imageBackend != NULL);
+    if (!imageBackend)
+        return TEST_RESULT();
+
+    LibSpecialDrive_Backend backend = testFailingBackend(imageBackend);
+
+    LibSpecialDrive *ctx = testContext(&backend, NULL);
+    TEST_CHECK(ctx && ctx->commonBlockDeviceCount == 2);
+    if (!ctx)
+        return TEST_RESULT();
+
+    SyntheticSource synthetic;
+    memset(&synthetic, 0, sizeof(synthetic));
+    LibSpecialDrive_EventSource source = {&synthetic, NULL, syntheticNext, NULL, directory};
+    CallbackCount count = {0, 0};
+
+    LibSpecialDrive_Watcher *watcher = LibSpecialDriveWatcherCreate(ctx, &source, 0, testCallback, &count);
+    TEST_CHECK(watcher != NULL);
+    if (!watcher)
+        return TEST_RESULT();
+    TEST_CHECK(LibSpecialDriveWatcherGetFd(watcher) == -1);
+    TEST_CHECK(LibSpecialDriveWatcherGetTimeout(watcher) == -1);
+
+    LibSpecialDrive_ChangeList changes = {0};
+
+    // Disco novo
+    TEST_CHECK(testImageCreate(directory, "sdc.img", 1, 0));
+    syntheticPush(&synthetic, "add", "sdc.img", "disk", "/devices/virtual/block/sdc.img");
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_ADDED, "sdc.img"));
+    TEST_CHECK(ctx->commonBlockDeviceCount == 3);
+    TEST_CHECK(count.calls == 1 && count.changes == 1);
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Rajada no disco e nas partições vira uma única mudança; eventos que
+    // não são de disco nem de partição são ignorados
+    syntheticPush(&synthetic, "change", "sdb.img", "disk", "/devices/virtual/block/sdb.img");
+    syntheticPush(&synthetic, "change", "sdb.img1", "partition", "/devices/virtual/block/sdb.img/sdb.img1");
+    syntheticPush(&synthetic, "change", "sdb.img2", "partition", "/devices/virtual/block/sdb.img/sdb.img2");
+    syntheticPush(&synthetic, "change", "sdb.img", "disk", "/devices/virtual/block/sdb.img");
+    syntheticPush(&synthetic, "change", "", "", "/devices/virtual/net/lo");
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_CHANGED, "sdb.img"));
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Remoção
+    char path[4096];
+    TEST_CHECK(testPath(path, sizeof(path), directory, "sda.img") && unlink(path) == 0);
+    syntheticPush(&synthetic, "remove", "sda.img", "disk", "/devices/virtual/block/sda.img");
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_REMOVED, "sda.img"));
+    TEST_CHECK(ctx->commonBlockDeviceCount == 2);
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Eventos perdidos: recarga completa encontra o disco que não avisou
+    TEST_CHECK(testImageCreate(directory, "sdd.img", 1, 0));
+    syntheticLost(&synthetic);
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_ADDED, "sdd.img"));
+    LibSpecialDriveChangeListClear(&changes);
+
+    // Nada pendente: nada a fazer
+    TEST_CHECK(!LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(changes.count == 0);
+
+    // Recarga que falha mantém o disco pendente para a próxima tentativa
+    TEST_CHECK(testImageCreate(directory, "sde.img", 1, 0));
+    syntheticPush(&synthetic, "add", "sde.img", "disk", "/devices/virtual/block/sde.img");
+    testFailDiscover = true;
+    int calls = count.calls;
+    TEST_CHECK(!LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(changes.count == 0 && count.calls == calls);
+    TEST_CHECK(LibSpecialDriveWatcherGetTimeout(watcher) == 0);
+    testFailDiscover = false;
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_ADDED, "sde.img"));
+    TEST_CHECK(ctx->commonBlockDeviceCount == 4);
+    LibSpecialDriveChangeListClear(&changes);
+
+    // A recarga completa também sobrevive a uma falha
+    TEST_CHECK(testPath(path, sizeof(path), directory, "sdd.img") && unlink(path) == 0);
+    syntheticLost(&synthetic);
+    testFailDiscover = true;
+    TEST_CHECK(!LibSpecialDriveWatcherDispatch(watcher, &changes));
+    testFailDiscover = false;
+    TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+    TEST_CHECK(testSingleChange(&changes, CHANGE_REMOVED, "sdd.img"));
+    LibSpecialDriveChangeListClear(&changes);
+    LibSpecialDriveWatcherDestroy(&watcher);
+    TEST_CHECK(watcher == NULL);
+
+    // Debounce: a mudança espera o silêncio da rajada
+    watcher = LibSpecialDriveWatcherCreate(ctx, &source, 50, NULL, NULL);
+    TEST_CHECK(watcher != NULL);
+    if (watcher)
+    {
+        syntheticPush(&synthetic, "change", "sdb.img", "disk", "/devices/virtual/block/sdb.img");
+        TEST_CHECK(!LibSpecialDriveWatcherDispatch(watcher, &changes));
+        int timeout = LibSpecialDriveWatcherGetTimeout(watcher);
+        TEST_CHECK(timeout > 0 && timeout <= 50);
+        testSleepMs(60);
+        TEST_CHECK(LibSpecialDriveWatcherGetTimeout(watcher) == 0);
+        TEST_CHECK(LibSpecialDriveWatcherDispatch(watcher, &changes));
+        TEST_CHECK(testSingleChange(&changes, CHANGE_CHANGED, "sdb.img"));
+        LibSpecialDriveChangeListClear(&changes);
+        LibSpecialDriveWatcherDestroy(&watcher);
+    }
+
+    LibSpecialDriveDestroy(&ctx);
+    LibSpecialDriveBackendImageDestroy(&imageBackend);
+    testTempDirRemove(directory);
+    return TEST_RESULT();
+}
@@ -0,0 +1,197 @@
+#include "LibSpecialDriveTest.h"
+#include <fcntl.h>
+
+// --- Saída em fluxo ---
+
+// Bloco montado à mão (caminho com aspas, barra e caractere de controle,
+// duas partições, uma sem ponto de montagem) escrito em JSON Lines e no
+// formato binário, comparado byte a byte. Cobre também registro que não
+// cabe no buffer e descarga num fd com buffer menor que um registro.
+
+#define JSON_BLOCK                                                                                              \
+    "{\"list\":\"special\",\"index\":3,\"path\":\"/dev/q\\\"x\\\\\\u0001\",\"devId\":2049,\"size\":1048576,"  \
+    "\"lbaSize\":512,\"type\":\"mbr\",\"depth\":4,\"flags\":1,\"removable\":true,\"readOnly\":false,"          \
+    "\"uuid\":\"42424242-4242-4242-4242-424242424242\",\"partitions\":["                                       \
+    "{\"path\":\"/dev/q1\",\"mountPoint\":\"/mnt/a\",\"uuid\":null,\"freeSpace\":4096},"                       \
+    "{\"path\":\"/dev/q2\",\"mountPoint\":null,\"uuid\":null,\"freeSpace\":0}]}\n"
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool ok;
+} TestReader;
+
+static uint64_t testLE(TestReader *reader, size_t size)
+{
+    uint64_t value = 0;
+    if (reader->pos + size > reader->len)
+    {
+        reader->ok = false;
+        return 0;
+    }
+    for (size_t i = 0; i < size; i++)
+        value |= (uint64_t)reader->data[reader->pos + i] << (8 * i);
+    reader->pos += size;
+    return value;
+}
+
+static bool testBytes(TestReader *reader, const void *expected, size_t size)
+{
+    if (reader->pos + size > reader->len || memcmp(reader->data + reader->pos, expected, size) != 0)
+        reader->ok = false;
+    reader->pos += size;
+    return reader->ok;
+}
+
+static bool testJson(LibSpecialDrive_Writer *writer, const char *expected)
+{
+    return writer->len == strlen(expected) && memcmp(writer->buffer, expected, writer->len) == 0;
+}
+
+int main(void)
+{
+    LibSpecialDrive_Protective_MBR mbr;
+    memset(&mbr, 0, sizeof(mbr));
+    LibSpecialDrive_Flag flag = LIBSPECIAL_FLAG;
+    memset(flag.uuid, 0x42, sizeof(flag.uuid));
+    memcpy(mbr.boot_code, &flag, sizeof(flag));
+    mbr.signature = 0xAA55;
+
+    uint32_t lbaSize = 512;
+    LibSpecialDrive_Partition partitions[2];
+    memset(partitions, 0, sizeof(partitions));
+    partitions[0].path = "/dev/q1";
+    partitions[0].mountPoint = "/mnt/a";
+    partitions[0].lbaSize = &lbaSize;
+    partitions[0].freeSpace = 4096;
+    partitions[1].path = "/dev/q2";
+    partitions[1].lbaSize = &lbaSize;
+
+    LibSpecialDrive_BlockDevice blk;
+    memset(&blk, 0, sizeof(blk));
+    blk.type = PARTITION_TYPE_MBR;
+    blk.partitions = partitions;
+    blk.partitionCount = 2;
+    blk.lbaSize = lbaSize;
+    blk.size = 1048576;
+    blk.flags = BLOCK_FLAG_IS_REMOVABLE;
+    blk.path = "/dev/q\"x\\\x01";
+    blk.signature = &mbr;
+    blk.devId = 2049;
+    blk.depth = PROBE_DEPTH_FULL;
+
+    uint8_t buffer[1024];
+    LibSpecialDrive_Writer writer;
+
+    // JSON Lines
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, 0, buffer, sizeof(buffer));
+    TEST_CHECK(LibSpecialDriveWriterBlock(&writer, &blk, true, 3));
+    TEST_CHECK(testJson(&writer, JSON_BLOCK));
+
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, WRITER_FLAG_NO_PARTITIONS, buffer, sizeof(buffer));
+    TEST_CHECK(LibSpecialDriveWriterBlock(&writer, &blk, false, 0));
+    TEST_CHECK(writer.len > 0 && writer.len < sizeof(buffer) && buffer[writer.len - 1] == '\n');
+    buffer[writer.len] = '\0';
+    TEST_CHECK(strstr((char *)buffer, "\"partitions\"") == NULL);
+    TEST_CHECK(strstr((char *)buffer, "\"uuid\":null}") != NULL);
+
+    LibSpecialDrive_Change change = {CHANGE_REMOVED, 7, "/dev/q", false};
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, 0, buffer, sizeof(buffer));
+    TEST_CHECK(LibSpecialDriveWriterChange(&writer, &change));
+    TEST_CHECK(testJson(&writer, "{\"event\":\"removed\",\"list\":\"common\",\"path\":\"/dev/q\",\"devId\":7}\n"));
+    change.type = (enum LibSpecialDrive_ChangeType)9;
+    TEST_CHECK(!LibSpecialDriveWriterChange(&writer, &change));
+    change.type = CHANGE_REMOVED;
+
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, 0, buffer, sizeof(buffer));
+    TEST_CHECK(LibSpecialDriveWriterFreeSpace(&writer, &partitions[0], 8192));
+    TEST_CHECK(testJson(&writer, "{\"event\":\"freeSpace\",\"path\":\"/dev/q1\",\"mountPoint\":\"/mnt/a\",\"freeSpace\":4096,\"previous\":8192}\n"));
+
+    // Binário
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_BINARY, 0, buffer, sizeof(buffer));
+    TEST_CHECK(LibSpecialDriveWriterBlock(&writer, &blk, true, 3));
+    TEST_CHECK(LibSpecialDriveWriterChange(&writer, &change));
+    TEST_CHECK(LibSpecialDriveWriterFreeSpace(&writer, &partitions[1], 1));
+
+    static const uint8_t zero[16] = {0};
+    size_t pathLen = strlen(blk.path);
+    TestReader reader = {buffer, writer.len, 0, true};
+    TEST_CHECK(testBytes(&reader, "LSDS", 4));
+    TEST_CHECK(testLE(&reader, 2) == 1 && testLE(&reader, 2) == 0);
+
+    const uint8_t head[8] = {1, 1, PARTITION_TYPE_MBR, PROBE_DEPTH_FULL, BLOCK_FLAG_IS_REMOVABLE, 2, (uint8_t)pathLen, 0};
+    TEST_CHECK(testBytes(&reader, head, sizeof(head)));
+    TEST_CHECK(testLE(&reader, 4) == 3 && testLE(&reader, 4) == 512);
+    TEST_CHECK(testLE(&reader, 8) == 1048576 && testLE(&reader, 8) == 2049);
+    TEST_CHECK(testBytes(&reader, flag.uuid, 16));
+    TEST_CHECK(testBytes(&reader, blk.path, pathLen));
+
+    TEST_CHECK(testBytes(&reader, zero, 16));
+    TEST_CHECK(testLE(&reader, 8) == 4096 && testLE(&reader, 2) == 7 && testLE(&reader, 2) == 6);
+    TEST_CHECK(testBytes(&reader, "/dev/q1/mnt/a", 13));
+    TEST_CHECK(testBytes(&reader, zero, 16));
+    TEST_CHECK(testLE(&reader, 8) == 0 && testLE(&reader, 2) == 7 && testLE(&reader, 2) == UINT16_MAX);
+    TEST_CHECK(testBytes(&reader, "/dev/q2", 7));
+
+    const uint8_t changeHead[4] = {2, CHANGE_REMOVED, 0, 0};
+    TEST_CHECK(testBytes(&reader, changeHead, sizeof(changeHead)));
+    TEST_CHECK(testLE(&reader, 8) == 7 && testLE(&reader, 2) == 6);
+    TEST_CHECK(testBytes(&reader, "/dev/q", 6));
+
+    const uint8_t freeHead[4] = {3, 0, 0, 0};
+    TEST_CHECK(testBytes(&reader, freeHead, sizeof(freeHead)));
+    TEST_CHECK(testLE(&reader, 8) == 0 && testLE(&reader, 8) == 1);
+    TEST_CHECK(testLE(&reader, 2) == 7 && testLE(&reader, 2) == UINT16_MAX);
+    TEST_CHECK(testBytes(&reader, "/dev/q2", 7));
+    TEST_CHECK(reader.ok && reader.pos == writer.len);
+
+    // Sem fd, o registro que não cabe é descartado inteiro, com o cabeçalho
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_BINARY, 0, buffer, 40);
+    TEST_CHECK(!LibSpecialDriveWriterBlock(&writer, &blk, true, 3));
+    TEST_CHECK(writer.len == 0 && !writer.headerWritten);
+    TEST_CHECK(LibSpecialDriveWriterChange(&writer, &change));
+    TEST_CHECK(writer.len == 8 + 4 + 8 + 2 + 6);
+
+    LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, 0, buffer, 80);
+    TEST_CHECK(LibSpecialDriveWriterChange(&writer, &change));
+    size_t len = writer.len;
+    TEST_CHECK(!LibSpecialDriveWriterBlock(&writer, &blk, true, 3));
+    TEST_CHECK(writer.len == len);
+
+    // Com fd, um buffer menor que o registro produz os mesmos bytes
+    FILE *file = tmpfile();
+    TEST_CHECK(file != NULL);
+    if (file)
+    {
+        uint8_t expected[1024];
+        LibSpecialDriveWriterInit(&writer, WRITER_FORMAT_JSONL, 0, expected, sizeof(expected));
+        TEST_CHECK(LibSpecialDriveWriterBlock(&writer, &blk, true, 3) && LibSpecialDriveWriterChange(&writer, &change));
+        size_t expectedLen = writer.len;
+
+        uint8_t small[7];
+        LibSpecialDriveWriterInitFd(&writer, WRITER_FORMAT_JSONL, 0, fileno(file), small, sizeof(small));
+        TEST_CHECK(LibSpecialDriveWriterBlock(&writer, &blk, true, 3) && LibSpecialDriveWriterChange(&writer, &change));
+        TEST_CHECK(LibSpecialDriveWriterFlush(&writer) && writer.len == 0);
+
+        TEST_CHECK(lseek(fileno(file), 0, SEEK_SET) == 0);
+        ssize_t got = read(fileno(file), buffer, sizeof(buffer));
+        TEST_CHECK(got == (ssize_t)expectedLen && memcmp(buffer, expected, expectedLen) == 0);
+        fclose(file);
+    }
+
+    // fd sem escrita: a falha fica registrada e as escritas seguintes falham
+    int readOnly = open("/dev/null", O_RDONLY);
+    TEST_CHECK(readOnly >= 0);
+    if (readOnly >= 0)
+    {
+        uint8_t tiny[4];
+        LibSpecialDriveWriterInitFd(&writer, WRITER_FORMAT_JSONL, 0, readOnly, tiny, sizeof(tiny));
+        TEST_CHECK(!LibSpecialDriveWriterChange(&writer, &change));
+        TEST_CHECK(writer.failed && !LibSpecialDriveWriterFlush(&writer));
+        close(readOnly);
+    }
+
+    return TEST_RESULT();
+}